@@ -317,7 +317,7 @@ class BleedthroughLinearOp(HasStrictTraits):
         a_inv = np.linalg.pinv(a)
          
         # compute the corrected channels
-        new_channels = np.dot(experiment.data[channels], a_inv)
+        new_channels = util.compensate_columns(experiment.data[channels], a_inv).values
          
         # and assign to the new experiment
         for i, c in enumerate(channels):
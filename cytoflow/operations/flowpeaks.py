@@ -313,9 +313,7 @@ class FlowPeaksOp(HasStrictTraits):
             if len(data_subset) == 0:
                 raise util.CytoflowOpError('by',
                                            "Group {} had no data".format(data_group))
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
             
             # drop data that isn't in the scale range
             for c in self.channels:
@@ -667,10 +665,7 @@ class FlowPeaksOp(HasStrictTraits):
                                            "model.  Do you need to re-run estimate()?"
                                            .format(group))
                 
-            x = data_subset.loc[:, self.channels[:]]
-            
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
                  
             # which values are missing?
  
@@ -284,9 +284,7 @@ class GaussianMixtureOp(HasStrictTraits):
                 raise util.CytoflowOpError(None,
                                            "Group {} had no data"
                                            .format(group))
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
             
             # drop data that isn't in the scale range
             for c in self.channels:
@@ -481,24 +479,16 @@ class GaussianMixtureOp(HasStrictTraits):
                 continue
              
             gmm = self._gmms[group]
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
-                
-            # which values are missing?
-
-            x_na = pd.Series([False] * len(x))
-            for c in self.channels:
-                x_na[np.isnan(x[c]).values] = True
-                        
-            x = x.values
-            x_na = x_na.values
             group_idx = groupby.groups[group]
+            
+            # events that are missing on any of the scales aren't in any
+            # component
+            predicted, p, dist = util.gmm_predict(data_subset.loc[:, self.channels[:]], 
+                                                  self._scale, gmm,
+                                                  posteriors = self.posteriors,
+                                                  distances = self.sigma > 0.0)
  
             if self.num_components > 1:
-                predicted = np.full(len(x), -1, "int")
-                predicted[~x_na] = gmm.predict(x[~x_na])
-                
                 predicted_str = pd.Series(["(none)"] * len(predicted))
                 for c in range(0, self.num_components):
                     predicted_str[predicted == c] = "{0}_{1}".format(self.name, c + 1)
@@ -510,28 +500,19 @@ class GaussianMixtureOp(HasStrictTraits):
             # if we're doing sigma-based gating, for each component check
             # to see if the event is in the sigma gate.
             if self.sigma > 0.0:
+                
+                # come up with a threshold based on sigma.  you'll note we
+                # didn't sqrt dist (the squared Mahalanobis distance): 
+                # that's because for a multivariate Gaussian, the square of 
+                # the Mahalanobis distance is chi-square distributed
+                
+                prob = (scipy.stats.norm.cdf(self.sigma) - 0.5) * 2
+                thresh = scipy.stats.chi2.ppf(prob, 1)
+                
                 for c in range(self.num_components):
-                    s = np.linalg.pinv(gmm.covariances_[c])
-                    mu = gmm.means_[c]
-                    
-                    # compute the Mahalanobis distance
-
-                    f = lambda x, mu, s: np.dot(np.dot((x - mu).T, s), (x - mu))
-                    dist = np.apply_along_axis(f, 1, x, mu, s)
-
-                    # come up with a threshold based on sigma.  you'll note we
-                    # didn't sqrt dist: that's because for a multivariate 
-                    # Gaussian, the square of the Mahalanobis distance is
-                    # chi-square distributed
-                    
-                    p = (scipy.stats.norm.cdf(self.sigma) - 0.5) * 2
-                    thresh = scipy.stats.chi2.ppf(p, 1)
-                    
-                    event_gate[c].iloc[group_idx] = np.less_equal(dist, thresh)
+                    event_gate[c].iloc[group_idx] = np.less_equal(dist[:, c], thresh)
                     
             if self.posteriors:  
-                p = np.full((len(x), self.num_components), 0.0)
-                p[~x_na] = gmm.predict_proba(x[~x_na])
                 for c in range(self.num_components):
                     event_posteriors[c].iloc[group_idx] = p[:, c]
                     
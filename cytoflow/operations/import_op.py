@@ -28,6 +28,7 @@ from traits.api import (HasTraits, HasStrictTraits, provides, Str, List, Any,
 
 import fcsparser
 import numpy as np
+import pandas as pd
 from pathlib import Path
 
 import cytoflow.utility as util
@@ -543,6 +544,55 @@ def autodetect_name_metadata(filename, data_set = 0):
     return name_metadata
     
 
+def _read_data(filename, meta):
+    """
+    Decode the DATA segment of an FCS file with the native reader, which
+    maps the file and decodes it a channel at a time (see 
+    ``utility/logicle_ext/fcs.h``.)  ``meta`` is the metadata fcsparser
+    parsed from the TEXT segment.  Returns ``None`` if the native reader 
+    isn't built or can't handle the file, in which case fcsparser should
+    read it instead.
+    """
+    
+    try:
+        from ..utility.logicle_ext.Logicle import FcsData
+        
+        if meta['$MODE'] != 'L':
+            return None
+        
+        byte_order = meta['$BYTEORD'].replace(' ', '')
+        if byte_order in ('1,2,3,4', '1,2'):
+            big_endian = False
+        elif byte_order in ('4,3,2,1', '2,1'):
+            big_endian = True
+        else:
+            return None
+        
+        # the header's offsets are 0 if they don't fit in it
+        begin = int(meta['__header__']['data start'])
+        end = int(meta['__header__']['data end'])
+        if begin == 0 or end == 0:
+            begin = int(meta['$BEGINDATA'])
+            end = int(meta['$ENDDATA'])
+            
+        channels = int(meta['$PAR'])
+        bits = [int(meta['$P{}B'.format(i + 1)]) for i in range(channels)]
+        
+        # ImportOp masks the extra bits itself
+        fcs = FcsData(filename, begin, end, meta['$DATATYPE'], big_endian,
+                      int(meta['$TOT']), bits, [])
+        
+        # Experiment.add_events converts to float64 anyway, so decode 
+        # straight into float64 columns
+        data = np.empty((fcs.events(), channels), order = 'F')
+        for i in range(channels):
+            fcs.decode(i, data[:, i])
+            
+        return pd.DataFrame(data, columns = meta['_channel_names_'])
+    except (ImportError, KeyError, ValueError, TypeError):
+        return None
+    
+
 # module-level, so we can reuse it in other modules
 def parse_tube(filename, experiment = None, data_set = 0, metadata_only = False):   
         
@@ -564,13 +614,27 @@ def parse_tube(filename, experiment = None, data_set = 0, metadata_only = False)
                                 data_set = data_set,
                                 channel_naming = name_metadata)
         else:
-            with warnings.catch_warnings():
-                warnings.simplefilter("ignore")
-                tube_meta, tube_data = fcsparser.parse(
-                                        filename, 
-                                        meta_data_only = metadata_only,
-                                        data_set = data_set,
-                                        channel_naming = name_metadata)
+            # parse the TEXT segment with fcsparser, then decode the 
+            # DATA segment natively if we can
+            tube_data = None
+            if data_set == 0:
+                with warnings.catch_warnings():
+                    warnings.simplefilter("ignore")
+                    tube_meta = fcsparser.parse(
+                                    filename, 
+                                    meta_data_only = True,
+                                    data_set = data_set,
+                                    channel_naming = name_metadata)
+                tube_data = _read_data(filename, tube_meta)
+                
+            if tube_data is None:
+                with warnings.catch_warnings():
+                    warnings.simplefilter("ignore")
+                    tube_meta, tube_data = fcsparser.parse(
+                                            filename, 
+                                            meta_data_only = metadata_only,
+                                            data_set = data_set,
+                                            channel_naming = name_metadata)
     except Exception as e:
         raise util.CytoflowError("FCS reader threw an error reading data for tube {}"
                                  .format(filename)) from e
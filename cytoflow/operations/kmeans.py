@@ -226,9 +226,7 @@ class KMeansOp(HasStrictTraits):
                 raise util.CytoflowOpError('by',
                                            "Group {} had no data"
                                            .format(group))
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
             
             # drop data that isn't in the scale range
             for c in self.channels:
@@ -337,24 +335,13 @@ class KMeansOp(HasStrictTraits):
                                            "Do you need to re-run estimate()?"
                                            .format(group))    
             
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
-                 
-            # which values are missing?
- 
-            x_na = pd.Series([False] * len(x))
-            for c in self.channels:
-                x_na[np.isnan(x[c]).values] = True
-                         
-            x = x.values
-            x_na = x_na.values
             group_idx = groupby.groups[group]
             
             kmeans = self._kmeans[group]
   
-            predicted = np.full(len(x), -1, "int")
-            predicted[~x_na] = kmeans.predict(x[~x_na])
+            # events that are missing on any of the scales get -1
+            predicted = util.kmeans_predict(data_subset.loc[:, self.channels[:]], 
+                                            self._scale, kmeans)
                  
             predicted_str = pd.Series(["(none)"] * len(predicted))
             for c in range(0, self.num_clusters):
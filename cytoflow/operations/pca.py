@@ -247,9 +247,7 @@ class PCAOp(HasStrictTraits):
                 raise util.CytoflowOpError('by',
                                            "Group {} had no data"
                                            .format(group))
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
             
             # drop data that isn't in the scale range
             for c in self.channels:
@@ -343,9 +341,7 @@ class PCAOp(HasStrictTraits):
                 raise util.CytoflowOpError('by',
                                            "Group {} had no data"
                                            .format(group))
-            x = data_subset.loc[:, self.channels[:]]
-            for c in self.channels:
-                x[c] = self._scale[c](x[c])
+            x = util.scale_columns(data_subset.loc[:, self.channels[:]], self._scale)
                  
             # which values are missing?
    
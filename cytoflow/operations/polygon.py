@@ -234,19 +234,26 @@ class PolygonOp(HasStrictTraits):
         xscale = util.scale_factory(self.xscale, experiment, channel = self.xchannel)
         yscale = util.scale_factory(self.yscale, experiment, channel = self.ychannel)
         
-        vertices = [(xscale(x), yscale(y)) for (x, y) in self.vertices]
-        data = experiment.data[[self.xchannel, self.ychannel]].copy()
-        data[self.xchannel] = xscale(data[self.xchannel])
-        data[self.ychannel] = yscale(data[self.ychannel])
-            
-        # use a matplotlib Path because testing for membership is a fast C fn.
-        path = mpl.path.Path(np.array(vertices))
-        xy_data = data[[self.xchannel, self.ychannel]].values
+        # the native gate scales the data a block at a time as it tests it,
+        # so it doesn't need a scaled copy of both channels
+        gate = util.polygon_gate(experiment, 
+                                 self.xchannel, xscale, 
+                                 self.ychannel, yscale, 
+                                 self.vertices)
+        
+        if gate is None:
+            vertices = [(xscale(x), yscale(y)) for (x, y) in self.vertices]
+            data = experiment.data[[self.xchannel, self.ychannel]].copy()
+            data[self.xchannel] = xscale(data[self.xchannel])
+            data[self.ychannel] = yscale(data[self.ychannel])
+                
+            # use a matplotlib Path because testing for membership is a fast C fn.
+            path = mpl.path.Path(np.array(vertices))
+            xy_data = data[[self.xchannel, self.ychannel]].values
+            gate = path.contains_points(xy_data)
         
         new_experiment = experiment.clone()        
-        new_experiment.add_condition(self.name, 
-                                     "bool", 
-                                     path.contains_points(xy_data))
+        new_experiment.add_condition(self.name, "bool", gate)
         new_experiment.history.append(self.clone_traits(transient = lambda _: True))
             
         return new_experiment
@@ -208,31 +208,18 @@ class QuadOp(HasStrictTraits):
         if not self.ythreshold:
             raise util.CytoflowOpError('ythreshold', 'ythreshold must be set!')
 
-        gate = pd.Series([None] * len(experiment))
-        
-        # perhaps there's some more pythonic way to do this?
-        
-        # these gate names match FACSDiva.  They are ARBITRARY.
-
-        # lower-left
-        ll = np.logical_and(experiment[self.xchannel] < self.xthreshold,
-                            experiment[self.ychannel] < self.ythreshold)
-        gate.loc[ll] = self.name + '_3'
-        
-        # upper-left
-        ul = np.logical_and(experiment[self.xchannel] < self.xthreshold,
-                            experiment[self.ychannel] > self.ythreshold)
-        gate.loc[ul] = self.name + '_1'
-
-        # upper-right
-        ur = np.logical_and(experiment[self.xchannel] > self.xthreshold,
-                            experiment[self.ychannel] > self.ythreshold)
-        gate.loc[ur] = self.name + '_2'
-        
-        # lower-right
-        lr = np.logical_and(experiment[self.xchannel] > self.xthreshold,
-                            experiment[self.ychannel] < self.ythreshold)
-        gate.loc[lr] = self.name + '_4'
+        # these gate names match FACSDiva.  They are ARBITRARY.  events
+        # that are on a threshold aren't in any quadrant.
+        quadrant = util.quad_gate(experiment, 
+                                  self.xchannel, self.xthreshold, 
+                                  self.ychannel, self.ythreshold)
+        names = np.array([None, 
+                          self.name + '_1',     # upper-left
+                          self.name + '_2',     # upper-right
+                          self.name + '_3',     # lower-left
+                          self.name + '_4'],    # lower-right
+                         dtype = object)
+        gate = pd.Series(names[quadrant])
 
         new_experiment = experiment.clone()
         new_experiment.add_condition(self.name, "category", gate)
@@ -183,7 +183,7 @@ class RangeOp(HasStrictTraits):
                                        "range low must be < {0}"
                                        .format(experiment[self.channel].max()))
         
-        gate = experiment[self.channel].between(self.low, self.high)
+        gate = util.range_gate(experiment, self.channel, self.low, self.high)
         new_experiment = experiment.clone()
         new_experiment.add_condition(self.name, "bool", gate)
         new_experiment.history.append(self.clone_traits(transient = lambda _: True))
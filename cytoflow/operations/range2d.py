@@ -22,8 +22,6 @@ cytoflow.operations.range2d
 ---------------------------
 '''
 
-import pandas as pd
-
 from traits.api import HasStrictTraits, Float, Str, Bool, Instance, \
     provides, on_trait_change, Any, Constant
 
@@ -226,9 +224,9 @@ class Range2DOp(HasStrictTraits):
                                        "y channel range low must be < {0}"
                                        .format(experiment[self.ychannel].max()))
         
-        x = experiment[self.xchannel].between(self.xlow, self.xhigh)
-        y = experiment[self.ychannel].between(self.ylow, self.yhigh)
-        gate = pd.Series(x & y)
+        gate = util.range2d_gate(experiment, 
+                                 self.xchannel, self.xlow, self.xhigh,
+                                 self.ychannel, self.ylow, self.yhigh)
         
         new_experiment = experiment.clone() 
         new_experiment.add_condition(self.name, "bool", gate)   
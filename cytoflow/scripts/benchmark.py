@@ -0,0 +1,252 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.scripts.benchmark
+--------------------------
+
+Benchmarks for the scales, as cytoflow uses them:  `LogicleScale`,
+`HlogScale` and `ArcsinhScale` called on a channel's data, and the
+matplotlib transforms that draw them.  Each reports its throughput in
+events per second and, where it doesn't compute the transform exactly,
+its largest error against the exact one (on the scale, or relative to the
+data value for inverses).  The data come from a fixed seed, so runs on the
+same machine with the same ``--events`` are comparable::
+
+    cf-benchmark --save baseline.json
+    (upgrade or rebuild)
+    cf-benchmark --compare baseline.json
+
+exits with status 1 if any benchmark is more than ``--tolerance`` slower
+than the baseline, or any error is larger.  The extension's own
+microbenchmarks are in ``cytoflow/utility/logicle_ext/benchmark.cpp``.
+'''
+
+import argparse, json, sys, time
+
+import numpy as np
+import pandas as pd
+
+import cytoflow as flow
+from cytoflow.utility.logicle_scale import MatplotlibLogicleScale
+from cytoflow.utility.hlog_scale import MatplotlibHlogScale
+from cytoflow.utility.arcsinh_scale import MatplotlibArcsinhScale
+from cytoflow.utility.logicle_ext.Logicle import Logicle, Hlog, Arcsinh
+
+# an 18-bit channel
+RANGE = 262144
+
+def _experiment(events):
+    """
+    An `Experiment` with one channel that looks roughly like a compensated
+    fluorescence channel:  a third of the events unstained, spread either
+    side of zero, and the rest log-normal a couple of decades up.
+    """
+    rng = np.random.default_rng(42)
+    unstained = rng.random(events) < 1 / 3
+    data = np.where(unstained,
+                    50 * rng.standard_normal(events),
+                    10 ** (3 + 0.5 * rng.standard_normal(events)))
+    data = np.clip(data, -1000, RANGE)
+
+    ex = flow.Experiment()
+    ex.add_channel("B1-A")
+    ex.add_events(pd.DataFrame({"B1-A" : data}), {})
+    ex.metadata["B1-A"]["range"] = RANGE
+    return ex
+
+def _time(f):
+    """The best of a few runs of `f`, in seconds"""
+    best = None
+    for _ in range(5):
+        start = time.perf_counter()
+        f()
+        elapsed = time.perf_counter() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    return best
+
+def _error(x, exact, relative = False):
+    err = np.abs(np.asarray(x, dtype = np.float64) - exact)
+    if relative:
+        big = np.abs(exact) > 1
+        err[big] /= np.abs(exact[big])
+    return float(np.max(err))
+
+def _exact(transform, data, inverse = False):
+    data = np.ascontiguousarray(data, dtype = np.float64)
+    ret = np.empty_like(data)
+    if inverse:
+        transform.inverse(data, ret)
+    else:
+        transform.scale(data, ret)
+    return ret
+
+def run(events = 1 << 20, out = sys.stdout):
+    """
+    Run the benchmarks on `events` events, printing each result to `out`
+    (if it isn't None) as it's done.  Returns a list of dicts, each with
+    the benchmark's ``name``, its ``events_per_second``, and its ``error``
+    (None for the exact transforms).
+    """
+    ex = _experiment(events)
+    data = ex.data["B1-A"]
+    values = data.values
+
+    results = []
+
+    if out is not None:
+        print("{:<44} {:>12} {:>12}".format("benchmark", "Mevents/s", "max error"),
+              file = out)
+
+    def report(name, f, truth = None, relative = False):
+        ret = f()
+        seconds = _time(f)
+        error = None if truth is None else _error(ret, truth, relative)
+        results.append({"name" : name,
+                        "events_per_second" : events / seconds,
+                        "error" : error})
+        if out is not None:
+            print("{:<44} {:>12.2f} {:>12}".format(name, events / seconds / 1e6,
+                                                  "" if error is None else "{:.3g}".format(error)),
+                  file = out)
+
+    # scale values spread over the display, for the inverses
+    position = np.random.default_rng(7).random(events) * (1 - 1e-9)
+
+    for mode in ["fast", "accurate"]:
+        scale = flow.utility.scale_factory("logicle", ex, channel = "B1-A", mode = mode)
+
+        # against the exact transform with the table's parameters (it moves
+        # A a little to put zero on a bin boundary).  the scale clips the
+        # data to the bottom of the display first.
+        table = scale._logicle
+        exact = Logicle(table.T(), table.W(), table.M(), table.A())
+        truth = _exact(exact, np.clip(values, exact.inverse(0.0), None))
+        inverse = _exact(exact, position, inverse = True)
+
+        report("LogicleScale.__call__/{}/ndarray".format(mode),
+               lambda: scale(values), truth)
+        report("LogicleScale.__call__/{}/Series".format(mode),
+               lambda: scale(data), truth)
+        report("LogicleScale.inverse/{}/ndarray".format(mode),
+               lambda: scale.inverse(position), inverse, relative = True)
+
+        if mode == "fast":
+            transform = MatplotlibLogicleScale(None, logicle = table).get_transform()
+            inverted = transform.inverted()
+            report("LogicleTransform.transform",
+                   lambda: transform.transform(values), truth)
+            report("InvertedLogicleTransform.transform",
+                   lambda: inverted.transform(position), inverse, relative = True)
+
+    scale = flow.utility.scale_factory("hlog", ex, channel = "B1-A")
+    exact = Hlog(scale.b, 1.0, np.log10(RANGE))
+    truth = _exact(exact, values)
+    scaled = truth
+    inverse = _exact(exact, scaled, inverse = True)
+    report("HlogScale.__call__/ndarray", lambda: scale(values))
+    report("HlogScale.__call__/Series", lambda: scale(data))
+    report("HlogScale.inverse/ndarray", lambda: scale.inverse(scaled))
+
+    transform = MatplotlibHlogScale(None, **scale.get_mpl_params()).get_transform()
+    inverted = transform.inverted()
+    report("HlogTransform.transform",
+           lambda: transform.transform(values), truth)
+    report("InvertedHlogTransform.transform",
+           lambda: inverted.transform(scaled), inverse, relative = True)
+
+    scale = flow.utility.scale_factory("arcsinh", ex, channel = "B1-A")
+    exact = Arcsinh(scale.cofactor)
+    truth = _exact(exact, values)
+    scaled = truth
+    inverse = _exact(exact, scaled, inverse = True)
+    report("ArcsinhScale.__call__/ndarray", lambda: scale(values))
+    report("ArcsinhScale.inverse/ndarray", lambda: scale.inverse(scaled))
+
+    transform = MatplotlibArcsinhScale(None, **scale.get_mpl_params(None)).get_transform()
+    inverted = transform.inverted()
+    report("ArcsinhTransform.transform",
+           lambda: transform.transform(values), truth)
+    report("InvertedArcsinhTransform.transform",
+           lambda: inverted.transform(scaled), inverse, relative = True)
+
+    return results
+
+def compare(results, baseline, tolerance, out = sys.stdout):
+    """
+    Compare `results` against `baseline` (both from `run`), printing each
+    to `out`.  Returns the number of benchmarks that are more than
+    `tolerance` (a fraction) slower than the baseline, or whose error is
+    larger.
+    """
+    old = {b["name"] : b for b in baseline}
+    regressed = 0
+
+    print("\n{:<44} {:>12} {:>12}".format("against baseline", "speed", "error"),
+          file = out)
+    for r in results:
+        if r["name"] not in old:
+            continue
+        b = old[r["name"]]
+        speed = r["events_per_second"] / b["events_per_second"]
+        slower = speed < 1 - tolerance
+        worse = r["error"] is not None and b["error"] is not None \
+                and r["error"] > b["error"] * (1 + 1e-6)
+        if slower or worse:
+            regressed += 1
+        print("{:<44} {:>11.2f}x {:>12}{}"
+              .format(r["name"], speed,
+                      "" if r["error"] is None else "{:.3g}".format(r["error"]),
+                      "  REGRESSED" if slower or worse else ""),
+              file = out)
+
+    return regressed
+
+def main():
+    parser = argparse.ArgumentParser(description = "Benchmark cytoflow's scales")
+    parser.add_argument("--events", type = int, default = 1 << 20,
+                        help = "how many events to transform (default 2^20)")
+    parser.add_argument("--save", metavar = "FILE",
+                        help = "save the results to FILE as a baseline")
+    parser.add_argument("--compare", metavar = "FILE",
+                        help = "compare the results against the baseline in FILE")
+    parser.add_argument("--tolerance", type = float, default = 0.2,
+                        help = "how much slower than the baseline is a "
+                               "regression (default 0.2, ie. 20%%)")
+    args = parser.parse_args()
+
+    results = run(max(args.events, 1))
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump({"events" : args.events, "results" : results}, f, indent = 1)
+
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+        if baseline["events"] != args.events:
+            print("The baseline transformed {} events, not {}; its errors "
+                  "aren't comparable".format(baseline["events"], args.events),
+                  file = sys.stderr)
+        if compare(results, baseline["results"], args.tolerance):
+            sys.exit(1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import unittest
+
+import numpy as np
+
+import cytoflow.utility as util
+from cytoflow.utility.algorithms import bootstrap, percentiles
+from test_base import ImportedDataSmallTest  # @UnresolvedImport
+
+class Test(ImportedDataSmallTest):
+
+    def test_percentiles(self):
+        # the native percentiles agree with numpy
+        data = self.ex["Y2-A"].values
+
+        pcts = [0, 2.5, 33.3, 50, 97.5, 100]
+        np.testing.assert_allclose(percentiles(data, pcts), np.percentile(data, pcts))
+        self.assertEqual(percentiles(data, 50).shape, ())
+
+    def test_bootstrap(self):
+        # the native bootstrap agrees with resampling in Python
+        data = self.ex["Y2-A"].values
+
+        for func in [np.mean, np.median, util.geom_mean]:
+            boots = bootstrap(data, func = func, n_boot = 500, random_seed = 1)
+            self.assertEqual(boots.shape, (500,))
+            np.testing.assert_array_equal(boots, bootstrap(data, func = func,
+                                                           n_boot = 500,
+                                                           random_seed = 1))
+
+            # the resamples' statistics are around the data's, and spread
+            # out the way numpy's are
+            expected = bootstrap(data, func = lambda x: func(x), n_boot = 500, random_seed = 1)
+            self.assertLess(abs(boots.mean() - func(data)), 3 * expected.std())
+            self.assertAlmostEqual(boots.std() / expected.std(), 1, delta = 0.25)
+
+        low, high = util.ci(data, np.mean)
+        self.assertLess(low, data.mean())
+        self.assertGreater(high, data.mean())
+
+
+if __name__ == "__main__":
+    #import sys;sys.argv = ['', 'Test.testName']
+    unittest.main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import unittest
+import os
+
+import numpy as np
+import pandas as pd
+
+import cytoflow as flow
+import cytoflow.utility as util
+import cytoflow.utility.arcsinh_scale  # @UnusedImport
+
+class Test(unittest.TestCase):
+
+    def setUp(self):
+        self.cwd = os.path.dirname(os.path.abspath(__file__))
+        self.ex = flow.ImportOp(conditions = {},
+                                tubes = [flow.Tube(file = self.cwd + '/data/tasbe/mkate.fcs',
+                                                   conditions = {})]).apply()
+        
+    def test_run(self):
+        scale = util.scale_factory("arcsinh", self.ex, channel = "Pacific Blue-A")
+        x = scale(20.0)
+        self.assertTrue(isinstance(x, float))
+        self.assertAlmostEqual(x, np.arcsinh(20.0 / 5))
+        
+        x = scale([20])
+        self.assertTrue(isinstance(x, list))
+        
+        x = scale(pd.Series([20]))
+        self.assertTrue(isinstance(x, pd.Series))
+        
+        scale = util.scale_factory("arcsinh", self.ex, channel = "Pacific Blue-A",
+                                   cofactor = 150)
+        self.assertAlmostEqual(scale(20.0), np.arcsinh(20.0 / 150))
+        
+    def test_arcsinh_native(self):
+        from cytoflow.utility.logicle_ext.Logicle import Transform, Arcsinh, FastArcsinh
+        
+        exact = Arcsinh(5)
+        fast = FastArcsinh(5, 2 ** 18)
+        self.assertTrue(isinstance(exact, Transform))
+        self.assertTrue(isinstance(fast, Transform))
+        
+        x = np.r_[-np.logspace(-3, 5, 100), 0, np.logspace(-3, np.log10(2 ** 18), 100)]
+        y = np.empty_like(x)
+        exact.scale(x, y)
+        np.testing.assert_allclose(y, np.arcsinh(x / 5), rtol = 1e-15)
+        np.testing.assert_array_equal(y, [exact.scale(float(v)) for v in x])
+        
+        out = np.empty_like(x)
+        exact.inverse(y, out)
+        np.testing.assert_allclose(out, x, rtol = 1e-14)
+        
+        # the table is good to about six digits
+        fast.scale(x, out)
+        np.testing.assert_array_equal(out, [fast.scale(float(v)) for v in x])
+        np.testing.assert_allclose(out, y, rtol = 0, atol = 1e-5)
+        
+        fast.inverse(y, out)
+        np.testing.assert_array_equal(out, [fast.inverse(float(v)) for v in y])
+        np.testing.assert_allclose(out, x, rtol = 1e-5)
+        
+        # off the end of the table, FastArcsinh is exact
+        self.assertEqual(fast.scale(1e10), exact.scale(1e10))
+        self.assertEqual(fast.inverse(-20.0), exact.inverse(-20.0))
+        
+        with self.assertRaises(ValueError):
+            Arcsinh(0)
+        with self.assertRaises(ValueError):
+            FastArcsinh(5, -1)
+        with self.assertRaises(AttributeError):
+            Transform()
+            
+    def test_scale_batch(self):
+        scale = util.scale_factory("arcsinh", self.ex, channel = "Pacific Blue-A")
+        data = self.ex["Pacific Blue-A"]
+        
+        x = scale(data)
+        self.assertTrue(isinstance(x, pd.Series))
+        self.assertTrue(x.index.equals(data.index))
+        np.testing.assert_array_equal(x.values[0:100], 
+                                      [scale(float(v)) for v in data.values[0:100]])
+        
+        y = scale.inverse(x.values)
+        np.testing.assert_allclose(y, data.values, rtol = 1e-9, atol = 1e-9)
+        
+if __name__ == "__main__":
+    unittest.main()
@@ -78,6 +78,35 @@ class TestDensityPlot(View2DTestBase, unittest.TestCase):
     def testSmoothedSigma(self):
         self.view.plot(self.ex, smoothed = True, smoothed_sigma = 2) 
         
+    def testLogicleZoom(self):
+        # on logicle scales, re-plotting with new limits re-bins the 
+        # density grids from the last plot instead of counting again
+        self.view.xscale = "logicle"
+        self.view.yscale = "logicle"
+        self.view.plot(self.ex)
+        grids = self.view._density[2]
+        
+        self.view.plot(self.ex, xlim = (0, 10000), ylim = (0, 10000))
+        self.assertIs(self.view._density[2], grids)
+        
+        self.view.ychannel = "V2-A"
+        self.view.plot(self.ex)
+        self.assertIsNot(self.view._density[2], grids)
+
+        # the view only holds the experiment weakly
+        import weakref
+        self.assertIsInstance(self.view._density[0], weakref.ref)
+        self.assertIs(self.view._density[0](), self.ex)
+        
+        # and a scale with a different transform (here, a different T)
+        # counts again
+        ex = self.ex.clone()
+        self.view.plot(ex)
+        grids = self.view._density[2]
+        ex.metadata["V2-A"]["range"] *= 2
+        self.view.plot(ex)
+        self.assertIsNot(self.view._density[2], grids)
+        
         
 if __name__ == "__main__":
 #     import sys;sys.argv = ['', 'Test.testName']
@@ -23,7 +23,9 @@ Created on Feb 4, 2018
 @author: brian
 '''
 import unittest
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataTest  # @UnresolvedImport
 
 class TestGaussian(ImportedDataTest):
@@ -59,6 +61,40 @@ class TestGaussian(ImportedDataTest):
     def testPlot(self):
         self.op.estimate(self.ex)
         self.op.default_view().plot(self.ex)
+        
+    def testNativePredict(self):
+        # the native component assignments agree with sklearn's
+        import sklearn.mixture
+
+        channels = ["Y2-A", "V2-A"]
+        scales = {c : util.scale_factory("logicle", self.ex, channel = c)
+                  for c in channels}
+        data = self.ex.data.loc[:, channels]
+        x = util.scale_columns(data, scales).values
+
+        gmm = sklearn.mixture.GaussianMixture(n_components = 2, covariance_type = "full",
+                                              random_state = 1).fit(x)
+        predicted, posteriors, distances = util.gmm_predict(data, scales, gmm,
+                                                            posteriors = True,
+                                                            distances = True)
+        np.testing.assert_array_equal(predicted, gmm.predict(x))
+        np.testing.assert_allclose(posteriors, gmm.predict_proba(x), atol = 1e-12)
+        for c in range(2):
+            delta = x - gmm.means_[c]
+            expected = np.sum(np.dot(delta, np.linalg.pinv(gmm.covariances_[c])) * delta, axis = 1)
+            np.testing.assert_allclose(distances[:, c], expected, rtol = 1e-8)
+
+        # NaN on a scale isn't in any component
+        data = data.copy()
+        data.iloc[:10, 1] = -1.0
+        scales["V2-A"] = util.scale_factory("log", self.ex, channel = "V2-A")
+        scales["V2-A"].mode = "mask"
+        predicted, posteriors, distances = util.gmm_predict(data, scales, gmm, posteriors = True)
+        missing = np.isnan(scales["V2-A"](data["V2-A"].values))
+        self.assertTrue(missing.any())
+        np.testing.assert_array_equal(predicted == -1, missing)
+        np.testing.assert_array_equal(posteriors[missing], 0)
+        self.assertIsNone(distances)
 
 if __name__ == "__main__":
 #     import sys;sys.argv = ['', 'TestKMeans.testEstimateBy1Channel']
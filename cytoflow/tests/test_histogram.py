@@ -58,6 +58,41 @@ class TestHistogram(View1DTestBase, unittest.TestCase):
         self.view.huefacet = "Dox"
         self.view.plot(self.ex, histtype = 'step', density = True)
 
+    def testEnds(self):
+        # the bins run from the smallest value to the largest, and the
+        # events at the ends are counted too
+        import matplotlib.pyplot as plt
+        self.view.plot(self.ex, histtype = 'bar')
+        heights = [p.get_height() for p in plt.gca().patches]
+        self.assertEqual(sum(heights), len(self.ex))
+
+    def testLogicleBins(self):
+        # the caller's bins are what's counted, on a logicle scale too
+        import numpy as np
+        import matplotlib.pyplot as plt
+        bins = [-100, 0, 100, 1000, 10000]
+        self.view.scale = "logicle"
+        self.view.plot(self.ex, bins = bins, histtype = 'bar')
+        heights = [p.get_height() for p in plt.gca().patches]
+        expected, _ = np.histogram(self.ex["B1-A"], bins)
+        np.testing.assert_array_equal(heights, expected)
+
+    def testLogicleNotScaled(self):
+        # on a logicle scale, the bins come from percentiles of the data,
+        # and the column is never scaled all at once
+        from unittest import mock
+        import numpy as np
+        from cytoflow.utility.logicle_scale import LogicleScale
+        sizes = []
+        call = LogicleScale.__call__
+        def scale(self, data):
+            sizes.append(np.size(data))
+            return call(self, data)
+        self.view.scale = "logicle"
+        with mock.patch.object(LogicleScale, "__call__", scale):
+            self.view.plot(self.ex)
+        self.assertLess(max(sizes), len(self.ex))
+
         
 if __name__ == "__main__":
     import sys;sys.argv = ['', 'TestHistogram.testLogicleScale']
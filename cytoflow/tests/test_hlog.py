@@ -84,6 +84,63 @@ class Test(unittest.TestCase):
         d = ((hlpos_large - tlpos_large) / hlpos_large)
         assert_almost_equal(d, np.zeros(len(d)), decimal=2)
         
+    def test_hlog_native(self):
+        """
+        Compare the native hlog against a numerical solution of its inverse,
+        and the lookup table against the exact transform
+        """
+        
+        import scipy.optimize
+        from cytoflow.utility.hlog_scale import hlog_inv
+        from cytoflow.utility.logicle_ext.Logicle import Hlog, FastHlog
+        
+        b, r, d = 200, 1.0, np.log10(2 ** 18)
+        exact = Hlog(b, r, d)
+        fast = FastHlog(b, r, d)
+        
+        x = np.r_[-np.logspace(-3, 5, 100), 0, np.logspace(-3, np.log10(2 ** 18), 100)]
+        expected = [scipy.optimize.brentq(lambda y: hlog_inv(y, b, r, d) - v, -2 * r, 2 * r,
+                                          xtol = 1e-15)
+                    for v in x]
+        
+        y = np.array([exact.scale(float(v)) for v in x])
+        assert_almost_equal(y, expected, decimal = 12)
+        
+        # batch transforms match the scalar ones
+        out = np.empty_like(x)
+        exact.scale(x, out)
+        np.testing.assert_array_equal(out, y)
+        
+        exact.inverse(y, out)
+        np.testing.assert_allclose(out, x, rtol = 1e-12, atol = 1e-12)
+        
+        fast.scale(x, out)
+        np.testing.assert_array_equal(out, [fast.scale(float(v)) for v in x])
+        assert_almost_equal(out, y, decimal = 5)
+        
+        fast.inverse(y, out)
+        np.testing.assert_array_equal(out, [fast.inverse(float(v)) for v in y])
+        
+        # off the end of the table, FastHlog is exact
+        self.assertEqual(fast.scale(1e10), exact.scale(1e10))
+        self.assertEqual(fast.inverse(1.5), exact.inverse(1.5))
+        
+        with self.assertRaises(ValueError):
+            Hlog(200, 1.0, -1)
+        
+    def test_scale_batch(self):
+        scale = util.scale_factory("hlog", self.ex, channel = "Pacific Blue-A")
+        data = self.ex["Pacific Blue-A"]
+        
+        x = scale(data)
+        self.assertTrue(isinstance(x, pd.Series))
+        self.assertTrue(x.index.equals(data.index))
+        np.testing.assert_array_equal(x.values[0:100], 
+                                      [scale(float(v)) for v in data.values[0:100]])
+        
+        y = scale.inverse(x.values)
+        np.testing.assert_allclose(y, data.values, rtol = 1e-9, atol = 1e-9)
+        
         
 
 _machine_max = 2**18
@@ -98,6 +98,34 @@ class TestImport(unittest.TestCase):
             path = self.cwd + '/data/instruments/' + file
             import_op = flow.ImportOp(tubes = [flow.Tube(file = path)])
             import_op.apply()
+            
+    def testNativeReader(self):
+        # the native DATA segment decoder agrees with fcsparser, for the
+        # files it can read
+        import numpy as np
+        import fcsparser
+        from cytoflow.operations.import_op import _read_data
+        
+        files = sorted(f for f in os.listdir(self.cwd + '/data/instruments')
+                       if not f.endswith('.txt'))
+        files.append('../Plate01/RFP_Well_A3.fcs')
+        
+        # the only one it can't: its channels are 10 bits wide
+        fallback = {'Beckman Coulter - Cytomics FC500.LMD'}
+        
+        for file in files:
+            path = self.cwd + '/data/instruments/' + file
+            meta, data = fcsparser.parse(path, channel_naming = '$PnN')
+            native = _read_data(path, meta)
+            if file in fallback:
+                self.assertIsNone(native, file)
+                continue
+            
+            self.assertIsNotNone(native, file)
+            self.assertEqual(list(native.columns), list(data.columns))
+            self.assertEqual(len(native), len(data))
+            np.testing.assert_array_equal(native.values, 
+                                          data.values.astype('float64'))
     
 if __name__ == "__main__":
     import sys;sys.argv = ['', 'TestImport.testManufacturers']
@@ -24,7 +24,9 @@ Created on Mar 5, 2018
 '''
 
 import unittest
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 
 from test_base import View1DTestBase  # @UnresolvedImport
 
@@ -66,6 +68,42 @@ class TestKde1D(View1DTestBase, unittest.TestCase):
     def testBandwidth(self):
         for bw in ['scott', 'silverman', 1.0, 0.1, 0.01]:
             self.view.plot(self.ex, bw = bw)
+            
+    def testNativeDensity(self):
+        # the binned kernel density estimates agree with sklearn's
+        from sklearn.neighbors import KernelDensity
+
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        x = scale(self.ex["Y2-A"].values)
+        support = np.linspace(x.min() - 0.1, x.max() + 0.1, 100)
+
+        for kernel in ["gaussian", "epanechnikov", "exponential", "linear", "cosine"]:
+            expected = np.exp(KernelDensity(kernel = kernel, bandwidth = 0.05)
+                              .fit(x[:, np.newaxis])
+                              .score_samples(support[:, np.newaxis]))
+            density = util.kde_density(x, support, kernel = kernel, bw = 0.05)
+            np.testing.assert_allclose(density, expected, atol = 1e-3 * expected.max())
+
+        with self.assertRaises(util.CytoflowError):
+            util.kde_density(x, support, bw = 0)
+
+        # a far outlier and a small bandwidth, on a linear scale: the grid
+        # is sized from the bandwidth (or not used at all), so the compact
+        # kernels neither alias nor vanish
+        rng = np.random.default_rng(3)
+        data = rng.standard_normal(20000)
+        support = np.linspace(-3, 3, 61)
+        for outlier in [50.0, 1e6]:
+            data[0] = outlier
+            for kernel in ["tophat", "epanechnikov", "linear", "cosine"]:
+                expected = np.exp(KernelDensity(kernel = kernel, bandwidth = 0.05)
+                                  .fit(data[:, np.newaxis])
+                                  .score_samples(support[:, np.newaxis]))
+                density = util.kde_density(data, support, kernel = kernel, bw = 0.05)
+                # the tophat's edges are the least forgiving of binning
+                tolerance = 5e-2 if kernel == "tophat" else 1e-2
+                np.testing.assert_allclose(density, expected,
+                                           atol = tolerance * expected.max())
 
         
 if __name__ == "__main__":
@@ -24,7 +24,9 @@ Created on Mar 5, 2018
 '''
 
 import unittest
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 import matplotlib.pyplot as plt
 
 from test_base import View2DTestBase  # @UnresolvedImport
@@ -69,6 +71,37 @@ class TestKde2D(View2DTestBase, unittest.TestCase):
         for bw in ['scott', 'silverman', 0.1]:
             self.view.plot(self.ex, bw = bw)
             plt.close('all')
+            
+    def testNativeDensity(self):
+        # the binned kernel density estimates agree with sklearn's
+        from sklearn.neighbors import KernelDensity
+
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        yscale = util.scale_factory("logicle", self.ex, channel = "V2-A")
+        x = xscale(self.ex["Y2-A"].values)
+        y = yscale(self.ex["V2-A"].values)
+        xsupport = np.linspace(x.min(), x.max(), 20)
+        ysupport = np.linspace(y.min(), y.max(), 30)
+        xx, yy = np.meshgrid(xsupport, ysupport)
+        expected = np.exp(KernelDensity(kernel = "gaussian", bandwidth = 0.05)
+                          .fit(np.column_stack((x, y)))
+                          .score_samples(np.column_stack((xx.ravel(), yy.ravel()))))
+        density = util.kde_density_2d(x, y, xsupport, ysupport, bw = 0.05)
+        self.assertEqual(density.shape, xx.shape)
+        np.testing.assert_allclose(density.ravel(), expected, atol = 1e-2 * expected.max())
+
+        # a far outlier and a small bandwidth: the grid is sized from the 
+        # bandwidth (or not used at all)
+        rng = np.random.default_rng(3)
+        data = rng.standard_normal(20000)
+        data[0] = 1e6
+        support = np.linspace(-3, 3, 61)
+        expected = np.exp(KernelDensity(kernel = "gaussian", bandwidth = 0.01)
+                          .fit(np.column_stack((data, data[::-1])))
+                          .score_samples(np.column_stack((support, support))))
+        density = util.kde_density_2d(data, data[::-1], support, support, bw = 0.01)
+        np.testing.assert_allclose(np.diag(density), expected,
+                                   atol = 1e-2 * expected.max())
         
         
 if __name__ == "__main__":
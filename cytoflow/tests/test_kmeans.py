@@ -23,7 +23,9 @@ Created on Feb 4, 2018
 @author: brian
 '''
 import unittest
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataTest  # @UnresolvedImport
 
 class TestKMeans(ImportedDataTest):
@@ -59,6 +61,20 @@ class TestKMeans(ImportedDataTest):
     def testPlot(self):
         self.op.estimate(self.ex)
         self.op.default_view().plot(self.ex)
+        
+    def testNativePredict(self):
+        # the native cluster assignments agree with sklearn's
+        import sklearn.cluster
+
+        channels = ["Y2-A", "V2-A"]
+        scales = {c : util.scale_factory("logicle", self.ex, channel = c)
+                  for c in channels}
+        data = self.ex.data.loc[:, channels]
+        x = util.scale_columns(data, scales).values
+
+        kmeans = sklearn.cluster.MiniBatchKMeans(n_clusters = 3, random_state = 0).fit(x)
+        np.testing.assert_array_equal(util.kmeans_predict(data, scales, kmeans),
+                                      kmeans.predict(x))
 
 if __name__ == "__main__":
 #     import sys;sys.argv = ['', 'TestKMeans.testEstimateBy1Channel']
@@ -25,6 +25,7 @@ Created on Dec 1, 2015
 import unittest
 import os
 
+import numpy as np
 import pandas as pd
 
 import cytoflow as flow
@@ -49,6 +50,25 @@ class Test(unittest.TestCase):
         
         x = scale(pd.Series([20]))
         self.assertTrue(isinstance(x, pd.Series))
+        
+    def test_gate_axis(self):
+        # with a threshold that isn't positive (eg. NaN, for data without
+        # any positive values) there's no native axis, and the scale is
+        # evaluated in Python instead
+        channel = "Pacific Blue-A"
+        self.assertIsNotNone(util.scale_factory("log", self.ex, channel = channel).gate_axis())
+        
+        data = self.ex.data.loc[:, [channel]]
+        vertices = [(1, 1), (1000, 1), (1000, 1000)]
+        for threshold in [0.0, -1.0, np.nan]:
+            scale = util.scale_factory("log", self.ex, channel = channel)
+            scale.threshold = threshold
+            self.assertIsNone(scale.gate_axis())
+            self.assertIsNone(util.polygon_gate(self.ex, channel, scale, 
+                                                channel, scale, vertices))
+            
+            scaled = util.scale_columns(data, {channel : scale})
+            np.testing.assert_array_equal(scaled[channel], scale(data[channel]))
                         
         
 
@@ -18,7 +18,9 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 import unittest
+import sys
 
+import numpy as np
 import pandas as pd
 
 import cytoflow as flow
@@ -48,6 +50,42 @@ class TestLogicle(unittest.TestCase):
         
     ### TODO - test the estimator failure modes
         
+    def test_logicle_channel_stats(self):
+        """
+        The native pass gets the same maximum and negative quantile as pandas
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import ChannelStats
+        
+        data = self.ex["Y2-A"]
+        for r in [0.001, 0.05, 0.5, 0.9]:
+            stats = ChannelStats(data.values.astype(np.float64), r)
+            self.assertEqual(stats.count(), len(data))
+            self.assertEqual(stats.maximum(), data.max())
+            self.assertEqual(stats.negatives(), (data < 0).sum())
+            self.assertAlmostEqual(stats.negativeQuantile(), 
+                                   data[data < 0].quantile(r), places = 9)
+            
+        # NaN doesn't count, and no negative values means no quantile
+        stats = ChannelStats(np.array([np.nan, 3.0, 1.0]), 0.05)
+        self.assertEqual(stats.count(), 2)
+        self.assertEqual(stats.maximum(), 3.0)
+        self.assertEqual(stats.negatives(), 0)
+        self.assertTrue(np.isnan(stats.negativeQuantile()))
+        
+        with self.assertRaises(ValueError):
+            ChannelStats(data.values.astype(np.float64), 1.5)
+
+        with self.assertRaises(util.CytoflowError):
+            util.scale_factory("logicle", self.ex, channel = "Y2-A", r = 1.5).W
+            
+        # an explicit W doesn't need r, and T never does
+        ex = self.ex.clone()
+        ex.metadata["Y2-A"].pop("range", None)
+        scale = util.scale_factory("logicle", ex, channel = "Y2-A", r = 1.5, W = 0.5)
+        self.assertEqual(scale._T, data.max())
+        self.assertTrue(np.isfinite(scale(20.0)))
+        
     def test_logicle_apply(self):
         """
         Make sure the function applies without segfaulting
@@ -64,6 +102,820 @@ class TestLogicle(unittest.TestCase):
         x = scale(pd.Series([20]))
         self.assertTrue(isinstance(x, pd.Series))
         
+    def test_logicle_range(self):
+        """
+        Make sure a range that isn't a positive, finite number is rejected
+        """
+        
+        for bad in [float('nan'), float('inf'), -1.0]:
+            ex = self.ex.clone()
+            ex.metadata["Y2-A"]["range"] = bad
+            scale = util.scale_factory("logicle", ex, channel = "Y2-A")
+            with self.assertRaises(util.CytoflowError):
+                scale(20.0)
+        
+    def test_logicle_batch(self):
+        """
+        Make sure the array transforms match the scalar ones
+        """
+        
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        data = self.ex["Y2-A"].values[0:1000]
+        
+        x = scale(data)
+        self.assertTrue(isinstance(x, np.ndarray))
+        np.testing.assert_array_equal(x, [scale(float(v)) for v in data])
+        
+        y = scale.inverse(x)
+        np.testing.assert_array_equal(y, [scale.inverse(float(v)) for v in x])
+        
+        x = scale(self.ex["Y2-A"])
+        self.assertTrue(isinstance(x, pd.Series))
+        self.assertTrue(x.index.equals(self.ex.data.index))
+        
+    def test_logicle_clip_scale(self):
+        """
+        Make sure the fused clip-and-scale matches clipping, then scaling
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import FastLogicle
+        
+        fast = FastLogicle(262144, 0.5)
+        lo = fast.inverse(0.0)
+        hi = fast.inverse(1.0 - sys.float_info.epsilon)
+        
+        data = np.linspace(-1e5, 1e6, 100001)
+        expected = np.array([fast.scale(float(v)) for v in np.clip(data, lo, hi)])
+        
+        out = np.empty_like(data)
+        fast.clipScale(data, out)
+        np.testing.assert_array_equal(out, expected)
+        
+        # in place
+        fast.clipScale(data, data)
+        np.testing.assert_array_equal(data, expected)
+        
+        self.assertEqual(fast.clipScale(-1e9), 0.0)
+        self.assertEqual(fast.clipScale(1e9), fast.scale(hi))
+        
+        with self.assertRaises(ValueError):
+            fast.clipScale(out, out[1:])
+        
+    def test_logicle_simd(self):
+        """
+        Make sure each instruction set's batch kernels agree with the scalar
+        code
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+        
+        best = Logicle.simd()
+        exact = Logicle(262144, 0.5)
+        fast = FastLogicle(262144, 0.5)
+        
+        # stay inside the range of the lookup table, which is [0, 1)
+        x = np.linspace(0, 1, 10001)[:-1]
+        data = np.array([exact.inverse(float(v)) for v in x])
+        out = np.empty_like(data)
+        
+        try:
+            for simd in ["scalar", "sse2", "avx2", "avx512", "neon"]:
+                if not Logicle.setSimd(simd):
+                    continue
+                
+                exact.inverse(x, out)
+                np.testing.assert_allclose(out, data, rtol = 1e-13, atol = 1e-9)
+                
+                # the lookup tables should give exactly the same answers
+                fast.scale(data, out)
+                np.testing.assert_array_equal(out, [fast.scale(float(v)) for v in data])
+                
+                fast.inverse(x, out)
+                np.testing.assert_array_equal(out, [fast.inverse(float(v)) for v in x])
+        finally:
+            Logicle.setSimd(best)
+        
+    def test_logicle_threads(self):
+        """
+        Make sure splitting a batch transform across threads doesn't change
+        the answer, or the exception for a bad value
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+        
+        fast = FastLogicle(262144, 0.5)
+        
+        x = np.linspace(0, 1, 1000001)[:-1]
+        serial = np.empty_like(x)
+        parallel = np.empty_like(x)
+        
+        try:
+            Logicle.setThreads(1)
+            self.assertEqual(Logicle.threads(), 1)
+            fast.inverse(x, serial)
+            
+            Logicle.setThreads(4)
+            self.assertEqual(Logicle.threads(), 4)
+            fast.inverse(x, parallel)
+            np.testing.assert_array_equal(serial, parallel)
+            
+            data = serial.copy()
+            Logicle.setThreads(1)
+            fast.scale(data, serial)
+            Logicle.setThreads(4)
+            fast.scale(data, parallel)
+            np.testing.assert_array_equal(serial, parallel)
+            
+            data[-1] = 1e9
+            with self.assertRaises(ValueError):
+                fast.scale(data, parallel)
+        finally:
+            Logicle.setThreads(0)
+        
+    def test_logicle_python_threads(self):
+        """
+        Transform independent channels from several Python threads at once
+        (the wrappers release the GIL), and make sure bad values still raise
+        ValueError
+        """
+        
+        import threading
+        from cytoflow.utility.logicle_ext.Logicle import FastLogicle
+        
+        channels = ["V2-A", "Y2-A", "FSC-A", "SSC-A"]
+        scales = {c : util.scale_factory("logicle", self.ex, channel = c)
+                  for c in channels}
+        expected = {c : scales[c](self.ex[c].values) for c in channels}
+        results = {}
+        
+        def transform(channel):
+            for _ in range(10):
+                results[channel] = scales[channel](self.ex[channel].values)
+        
+        threads = [threading.Thread(target = transform, args = (c,)) 
+                   for c in channels]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+            
+        for c in channels:
+            np.testing.assert_array_equal(results[c], expected[c])
+            
+        fast = FastLogicle(262144, 0.5)
+        with self.assertRaises(ValueError):
+            fast.scale(1e9)
+        with self.assertRaises(ValueError):
+            fast.inverse(2.0)
+        with self.assertRaises(ValueError):
+            fast.intScale(1e9)
+        with self.assertRaises(ValueError):
+            FastLogicle(-1, 0.5)
+        for bad in [(float('nan'), 0.5), (float('inf'), 0.5),
+                    (262144, float('nan')), (262144, 0.5, float('nan')),
+                    (262144, 0.5, 4.5, float('nan'))]:
+            with self.assertRaises(ValueError):
+                FastLogicle(*bad)
+        
+    def test_logicle_table_fill(self):
+        """
+        The table entries, which are computed by recurrence, match the exact
+        transform at the bin edges
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+        
+        for T, W, M, A in [(262144, 0.5, 4.5, 0), (262144, 0, 4.5, 0),
+                           (1000, 1, 4.5, 1), (1e6, 2, 6, 0.5)]:
+            fast = FastLogicle(T, W, M, A, 1 << 16)
+            exact = Logicle(T, W, M, fast.A())
+            
+            bins = np.arange(fast.bins())
+            np.testing.assert_allclose([fast.inverse(int(i)) for i in bins],
+                                       [exact.inverse(i / fast.bins()) for i in bins],
+                                       rtol = 1e-12, atol = 1e-12 * T)
+        
+    def test_logicle_table_cache(self):
+        """
+        FastLogicles with the same parameters share a table from the cache,
+        and give the same answers whether it's on or not
+        """
+        
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+        
+        x = np.linspace(0, 1, 10001)[:-1]
+        expected = np.empty_like(x)
+        out = np.empty_like(x)
+        
+        size = Logicle.tableCacheSize()
+        try:
+            Logicle.setTableCacheSize(0)
+            self.assertEqual(Logicle.tableCacheCount(), 0)
+            FastLogicle(262144, 0.5).inverse(x, expected)
+            self.assertEqual(Logicle.tableCacheCount(), 0)
+            
+            Logicle.setTableCacheSize(2)
+            FastLogicle(262144, 0.5).inverse(x, out)
+            np.testing.assert_array_equal(out, expected)
+            self.assertEqual(Logicle.tableCacheCount(), 1)
+            
+            # this one comes from the cache
+            FastLogicle(262144, 0.5).inverse(x, out)
+            np.testing.assert_array_equal(out, expected)
+            self.assertEqual(Logicle.tableCacheCount(), 1)
+            
+            # the cache doesn't grow past its size, and tables it drops
+            # are still good
+            fast = FastLogicle(262144, 0.5)
+            for T in [1000, 10000, 100000]:
+                FastLogicle(T, 0.5)
+            self.assertEqual(Logicle.tableCacheCount(), 2)
+            fast.inverse(x, out)
+            np.testing.assert_array_equal(out, expected)
+        finally:
+            Logicle.setTableCacheSize(size)
+
+    def test_logicle_table_file(self):
+        """
+        A FastLogicle mapped from a saved table matches the one that saved it
+        """
+
+        import os
+        import tempfile
+        from cytoflow.utility.logicle_ext.Logicle import FastLogicle
+
+        fast = FastLogicle(262144, 0.5, 4.5, 0.3, 1 << 14)
+        x = np.linspace(0, 1, 10001)[:-1]
+        expected = np.empty_like(x)
+        fast.inverse(x, expected)
+
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "logicle.table")
+            fast.save(path)
+
+            mapped = FastLogicle(path)
+            self.assertEqual(mapped.bins(), fast.bins())
+            for p in ["T", "W", "M", "A", "b", "d"]:
+                self.assertEqual(getattr(mapped, p)(), getattr(fast, p)())
+
+            out = np.empty_like(x)
+            mapped.inverse(x, out)
+            np.testing.assert_array_equal(out, expected)
+            mapped.scale(expected, out)
+            fast.scale(expected, x)
+            np.testing.assert_array_equal(out, x)
+
+            # (windows won't delete a mapped file)
+            del mapped
+
+            # a truncated table
+            with open(path, "rb") as f:
+                data = f.read(1000)
+            truncated = os.path.join(tmp, "truncated.table")
+            with open(truncated, "wb") as f:
+                f.write(data)
+            with self.assertRaises(ValueError):
+                FastLogicle(truncated)
+
+            # a table of the right length whose index points past its end
+            # (the last entry in the file is the index's last bin)
+            import struct
+            with open(path, "rb") as f:
+                data = f.read()
+            corrupt = os.path.join(tmp, "corrupt.table")
+            with open(corrupt, "wb") as f:
+                f.write(data[:-4] + struct.pack("=i", 1 << 30))
+            with self.assertRaises(ValueError):
+                FastLogicle(corrupt)
+
+            with self.assertRaises(ValueError):
+                FastLogicle(os.path.join(tmp, "missing"))
+
+            with self.assertRaises(OSError):
+                fast.save(os.path.join(tmp, "missing", "logicle.table"))
+
+    def test_logicle_pickle(self):
+        """
+        The native transforms pickle and copy, and give the same answers
+        afterwards
+        """
+
+        import copy
+        import pickle
+        from cytoflow.utility.logicle_ext.Logicle import (Logicle, FastLogicle,
+                                                          Hlog, FastHlog,
+                                                          Arcsinh, FastArcsinh)
+
+        x = np.linspace(0.01, 0.99, 1001)
+        for t in [Logicle(262144, 0.5), FastLogicle(262144, 0.5, 4.5, 0.3, 1001),
+                  Hlog(500, 1e4, 4), FastHlog(500, 1e4, 4),
+                  Arcsinh(150), FastArcsinh(150, 262144)]:
+            expected = np.empty_like(x)
+            t.inverse(x, expected)
+
+            for u in [pickle.loads(pickle.dumps(t)), copy.copy(t), copy.deepcopy(t)]:
+                self.assertIs(type(u), type(t))
+                out = np.empty_like(x)
+                u.inverse(x, out)
+                np.testing.assert_array_equal(out, expected)
+
+        # a copy of a mapped table shares the mapping, and a pickle maps
+        # the same file
+        import os
+        import tempfile
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "logicle.table")
+            FastLogicle(262144, 0.5).save(path)
+            mapped = FastLogicle(path)
+            self.assertEqual(copy.copy(mapped).tableFile(), path)
+            self.assertEqual(pickle.loads(pickle.dumps(mapped)).tableFile(), path)
+            self.assertIsNone(FastLogicle(262144, 0.5).tableFile())
+            del mapped
+
+    def test_logicle_stream(self):
+        """
+        Streaming the data through the scale a chunk at a time gives the
+        same answers as transforming it all at once
+        """
+
+        import os
+        import tempfile
+
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        data = self.ex["Y2-A"].values
+        expected = scale(data)
+
+        # in chunks, from an iterable
+        chunks = list(scale.stream([data[:5000], data[5000:]], chunk_size = 1000))
+        self.assertEqual(len(chunks), 10)
+        np.testing.assert_array_equal(np.concatenate(chunks), expected)
+
+        with tempfile.TemporaryDirectory() as tmp:
+            # from a file of big-endian float32 events, one channel out of
+            # several, into another file
+            events = np.memmap(os.path.join(tmp, "data"), dtype = '>f4',
+                               mode = 'w+', shape = (len(data), 3))
+            events[:, 1] = data
+            out = np.memmap(os.path.join(tmp, "out"), dtype = np.float64,
+                            mode = 'w+', shape = (len(data),))
+
+            self.assertIs(scale.stream(events[:, 1], out, chunk_size = 777), out)
+            np.testing.assert_array_equal(out, scale(events[:, 1].astype(np.float64)))
+
+            scale.stream(out, out, chunk_size = 777, inverse = True)
+            np.testing.assert_allclose(out, scale.inverse(scale(events[:, 1].astype(np.float64))))
+            del events, out
+
+        with self.assertRaises(util.CytoflowError):
+            scale.stream(data, np.empty(len(data) - 1))
+
+    def test_logicle_histogram(self):
+        """
+        Counting the data natively gives numpy's histogram of the scaled data
+        (give or take the odd value right on the edge of a bin)
+        """
+
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        yscale = util.scale_factory("logicle", self.ex, channel = "V2-A")
+        x = self.ex["Y2-A"]
+        y = self.ex["V2-A"]
+
+        counts = xscale.histogram(x, 100, (0.1, 0.9))
+        expected, _ = np.histogram(xscale(x), bins = 100, range = (0.1, 0.9))
+        self.assertEqual(counts.dtype, np.float64)
+        np.testing.assert_allclose(counts, expected, atol = 2)
+        self.assertLessEqual(abs(counts.sum() - expected.sum()), 2)
+
+        counts = xscale.histogram2d(x, y, yscale, bins = (40, 30),
+                                    range = ((0.1, 0.9), (0.2, 0.8)))
+        expected, _, _ = np.histogram2d(xscale(x), yscale(y), bins = (40, 30),
+                                        range = ((0.1, 0.9), (0.2, 0.8)))
+        self.assertEqual(counts.shape, (40, 30))
+        np.testing.assert_allclose(counts, expected, atol = 2)
+
+        # NaN isn't counted
+        data = np.array([np.nan, xscale.inverse(0.5)])
+        np.testing.assert_array_equal(xscale.histogram(data, 2, (0, 0.99)), [0, 1])
+
+        with self.assertRaises(util.CytoflowError):
+            xscale.histogram(x, 10, (0.5, 0.5))
+        with self.assertRaises(util.CytoflowError):
+            xscale.histogram2d(x, y[:10], yscale, (10, 10), ((0, 0.9), (0, 0.9)))
+
+    def test_logicle_density(self):
+        """
+        A density grid re-binned for a plot gives numpy's 2d histogram of the
+        scaled data, give or take the events in cells that straddle bins
+        """
+
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        yscale = util.scale_factory("logicle", self.ex, channel = "V2-A")
+        x = self.ex["Y2-A"]
+        y = self.ex["V2-A"]
+
+        # events off the ends of the tables aren't counted
+        inside = ((x >= xscale.inverse(0.0)) & (x < xscale.inverse(1.0)) & 
+                  (y >= yscale.inverse(0.0)) & (y < yscale.inverse(1.0)))
+
+        grid = xscale.density(x, y, yscale, cells = 256)
+        self.assertEqual(grid.cells(), 256)
+
+        # bins made of whole cells are exact
+        out = np.empty((64, 32))
+        grid.raster(0, 1, 64, 0, 1, out)
+        expected, _, _ = np.histogram2d(xscale(x[inside]), yscale(y[inside]), bins = (64, 32),
+                                        range = ((0, 1), (0, 1)))
+        np.testing.assert_allclose(out, expected, atol = 2)
+        self.assertAlmostEqual(out.sum(), grid.events())
+
+        # otherwise the counts are shared out, and the total is (about) the same
+        out = np.empty((49, 49))
+        grid.raster(0.2, 0.9, 49, 0.15, 0.85, out)
+        expected, _, _ = np.histogram2d(xscale(x[inside]), yscale(y[inside]), bins = (49, 49),
+                                        range = ((0.2, 0.9), (0.15, 0.85)))
+        self.assertLess(abs(out.sum() - expected.sum()), 0.01 * expected.sum())
+
+        # counting more events adds to the grid
+        grid.add(x.values, y.values)
+        self.assertAlmostEqual(grid.events(), 2 * len(x))
+
+        with self.assertRaises(util.CytoflowError):
+            xscale.density(x, y, yscale, cells = 1 << 20)
+        with self.assertRaises(ValueError):
+            grid.raster(0, 1, 10, 0, 1, np.empty(25))
+
+    def test_logicle_hermite(self):
+        """
+        The cubic table is much closer to the exact transform than the 
+        linear one, and otherwise works the same way
+        """
+
+        import pickle
+        from cytoflow.utility.logicle_ext.Logicle import (Logicle, FastLogicle,
+                                                          HermiteLogicle)
+
+        fast = FastLogicle(262144, 0.5, 4.5, 0.0)
+        hermite = HermiteLogicle(262144, 0.5, 4.5, 0.0)
+        exact = Logicle(fast.T(), fast.W(), fast.M(), fast.A())
+        self.assertEqual(hermite.bins(), fast.bins())
+        self.assertEqual(hermite.A(), fast.A())
+
+        scale = np.linspace(0.001, 0.999, 100001)
+        data = np.empty_like(scale)
+        exact.inverse(scale, data)
+
+        out = np.empty_like(data)
+        hermite.scale(data, out)
+        np.testing.assert_allclose(out, scale, rtol = 0, atol = 1e-12)
+        fast.scale(data, out)
+        self.assertGreater(np.abs(out - scale).max(), 1e-9)
+
+        hermite.inverse(scale, out)
+        np.testing.assert_allclose(out, data, rtol = 1e-10, atol = 1e-9)
+
+        # the scalar and clipped transforms are the cubics too
+        self.assertAlmostEqual(hermite.scale(1000.0), exact.scale(1000.0), places = 12)
+        self.assertAlmostEqual(hermite.clipScale(1000.0), exact.scale(1000.0), places = 12)
+        hermite.clipScale(data, out)
+        np.testing.assert_allclose(out, scale, rtol = 0, atol = 1e-12)
+        self.assertEqual(hermite.clipScale(-1e9), 0.0)
+        self.assertEqual(hermite.intScale(1000.0), fast.intScale(1000.0))
+
+        with self.assertRaises(ValueError):
+            hermite.scale(1e12)
+
+        copy = pickle.loads(pickle.dumps(hermite))
+        self.assertIsInstance(copy, HermiteLogicle)
+        self.assertEqual(copy.scale(1000.0), hermite.scale(1000.0))
+
+        # and the scale chooses between them
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        self.assertNotIsInstance(xscale._logicle, HermiteLogicle)
+        accurate = util.scale_factory("logicle", self.ex, channel = "Y2-A", 
+                                      mode = "accurate")
+        self.assertIsInstance(accurate._logicle, HermiteLogicle)
+        x = self.ex["Y2-A"].values
+        np.testing.assert_allclose(accurate(x), xscale(x), atol = 1e-6)
+
+    def test_logicle_ticks(self):
+        """
+        A whole tick layout comes back in one call, and the exact inverse
+        works off the ends of the table
+        """
+
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+
+        logicle = FastLogicle(262144, 0.5, 4.5, 0.0)
+
+        major, minor = logicle.axisTicks(0, 262144)
+        self.assertEqual(major, [0, 100, 1000, 10000, 100000])
+        self.assertEqual(minor[:3], [0, 10, 20])
+        self.assertEqual(len(minor), 46)
+
+        major, minor = logicle.axisTicks(-500, 100000)
+        self.assertEqual(major, [-100, 0, 100, 1000, 10000, 100000])
+        self.assertEqual(minor[:3], [-1000, -900, -800])
+        self.assertIn(0, minor)
+
+        # the view doesn't have to be in order
+        self.assertEqual(logicle.axisTicks(100000, -500)[0], major)
+
+        self.assertEqual(logicle.axisLabels(), Logicle(262144, 0.5).axisLabels())
+
+        scale = np.array([-0.2, 0.0, 0.5, 1.0, 1.3])
+        expected = np.array([Logicle(262144, 0.5).inverse(x) for x in scale])
+        out = np.empty_like(scale)
+        logicle.exactInverse(scale, out)
+        np.testing.assert_allclose(out, expected, rtol = 1e-14)
+
+        with self.assertRaises(TypeError):
+            logicle.exactInverse(scale.astype(np.float32), out.astype(np.float32))
+        with self.assertRaises(ValueError):
+            logicle.exactInverse(scale, np.empty(2))
+
+        # the locators share one layout for each view
+        import matplotlib.pyplot as plt
+        from unittest import mock
+        views = []
+        ticks = FastLogicle.axisTicks
+        def axisTicks(self, vmin, vmax):
+            views.append((vmin, vmax))
+            return ticks(self, vmin, vmax)
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        fig, ax = plt.subplots()
+        ax.set_xscale("logicle", **xscale.get_mpl_params(ax.get_xaxis()))
+        ax.set_xlim(0, 100000)
+        with mock.patch.object(FastLogicle, "axisTicks", axisTicks):
+            ax.xaxis.get_majorticklocs()
+            ax.xaxis.get_minorticklocs()
+            fig.canvas.draw()
+        self.assertEqual(len(views), 1)
+        plt.close(fig)
+
+        # and the ends of the scale are only worked out once
+        self.assertEqual(xscale._limits, (xscale.inverse(0.0), 
+                                          xscale.inverse(1.0 - sys.float_info.epsilon)))
+        norm = xscale.norm()
+        self.assertEqual((norm.vmin, norm.vmax), xscale._limits)
+
+    def test_logicle_scale_columns(self):
+        """
+        Scaling several channels at once agrees with scaling each of them
+        """
+
+        channels = ["Y2-A", "V2-A", "B1-A"]
+        scales = {"Y2-A" : util.scale_factory("logicle", self.ex, channel = "Y2-A"),
+                  "V2-A" : util.scale_factory("log", self.ex, channel = "V2-A"),
+                  "B1-A" : util.scale_factory("linear", self.ex, channel = "B1-A")}
+        scales["V2-A"].mode = "mask"
+
+        data = self.ex.data.loc[:, channels]
+        expected = data.copy()
+        for c in channels:
+            expected[c] = scales[c](expected[c])
+
+        # whichever order the values are stored in
+        for values in [data, pd.DataFrame(np.ascontiguousarray(data.values),
+                                          index = data.index,
+                                          columns = data.columns)]:
+            scaled = util.scale_columns(values, scales)
+            self.assertTrue(scaled.index.equals(data.index))
+            self.assertEqual(list(scaled.columns), channels)
+            np.testing.assert_array_equal(scaled.values, expected.values)
+
+        # scales without a native axis are applied one at a time
+        class Scale(object):
+            def __call__(self, data):
+                return data * 2
+        scaled = util.scale_columns(data, dict(scales, **{"B1-A" : Scale()}))
+        np.testing.assert_array_equal(scaled["B1-A"], data["B1-A"] * 2)
+        np.testing.assert_array_equal(scaled["Y2-A"], expected["Y2-A"])
+
+    def test_logicle_compensate_columns(self):
+        """
+        Compensating natively agrees with numpy, scaled or not
+        """
+
+        channels = ["Y2-A", "V2-A", "B1-A"]
+        matrix = np.linalg.pinv([[1.0, 0.1, 0.02], [0.05, 1.0, 0.2], [0.0, 0.3, 1.0]])
+        scales = {c : util.scale_factory("logicle", self.ex, channel = c)
+                  for c in channels}
+
+        data = self.ex.data.loc[:, channels]
+        expected = np.dot(data, matrix)
+
+        compensated = util.compensate_columns(data, matrix)
+        self.assertTrue(compensated.index.equals(data.index))
+        np.testing.assert_allclose(compensated.values, expected, rtol = 1e-12, atol = 1e-9)
+
+        scaled = util.compensate_columns(data, matrix, scales)
+        for i, c in enumerate(channels):
+            np.testing.assert_allclose(scaled[c], scales[c](expected[:, i]), atol = 1e-9)
+
+        with self.assertRaises(util.CytoflowError):
+            util.compensate_columns(data, matrix[:2, :2])
+
+    def test_logicle_benchmark(self):
+        """
+        The scale benchmarks run, and the fast transforms are as accurate
+        as they claim to be
+        """
+
+        import io
+        from cytoflow.scripts import benchmark
+
+        results = {r["name"] : r for r in benchmark.run(events = 10000, out = None)}
+        for r in results.values():
+            self.assertGreater(r["events_per_second"], 0)
+
+        self.assertLess(results["LogicleScale.__call__/fast/ndarray"]["error"], 1e-6)
+        self.assertLess(results["LogicleScale.__call__/accurate/ndarray"]["error"], 1e-12)
+        self.assertLess(results["LogicleTransform.transform"]["error"], 1e-6)
+        self.assertLess(results["InvertedLogicleTransform.transform"]["error"], 1e-12)
+        self.assertLess(results["HlogTransform.transform"]["error"], 1e-6)
+        self.assertLess(results["ArcsinhTransform.transform"]["error"], 1e-5)
+        self.assertIsNone(results["HlogScale.__call__/ndarray"]["error"])
+
+        baseline = [dict(r, events_per_second = 2 * r["events_per_second"])
+                    for r in results.values()]
+        self.assertEqual(benchmark.compare(list(results.values()), baseline, 0.2,
+                                           out = io.StringIO()),
+                         len(results))
+
+    def test_logicle_transform_stats(self):
+        """
+        The counters count, if they're built in, and reset
+        """
+
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+
+        util.transform_stats(reset = True)
+        exact = Logicle(262144, 0.5)
+        exact.scale(np.linspace(-100, 1000, 1001), np.empty(1001))
+        with self.assertRaises(ValueError):
+            FastLogicle(262144, 0.5).intScale(1e9)
+        stats = util.transform_stats(reset = True)
+
+        if not stats["enabled"]:
+            for name, value in stats.items():
+                if name != "enabled":
+                    self.assertFalse(np.any(value), name)
+            return
+
+        self.assertEqual(stats["exact_scales"], 1001)
+        self.assertEqual(stats["halley_histogram"].sum(), 1001)
+        iterations = np.arange(len(stats["halley_histogram"]))
+        self.assertEqual(np.dot(stats["halley_histogram"], iterations),
+                         stats["halley_iterations"])
+        self.assertGreater(stats["taylor_scales"], 0)
+        self.assertGreaterEqual(stats["illegal_arguments"], 1)
+        self.assertEqual(stats["table_builds"] + stats["table_hits"], 1)
+
+        self.assertEqual(util.transform_stats()["exact_scales"], 0)
+
+    def test_logicle_float32(self):
+        """
+        The float32 transforms give the float64 results, rounded to float32
+        """
+
+        from cytoflow.utility.logicle_ext.Logicle import Logicle, FastLogicle
+
+        # inside the lookup table, so that the fast inverse doesn't throw
+        fast = FastLogicle(262144, 0.5)
+        data = np.linspace(fast.inverse(0.0) / 2, 250000, 100001).astype(np.float32)
+
+        for logicle in [Logicle(262144, 0.5), fast]:
+            expected = np.empty(data.shape)
+            logicle.scale(data.astype(np.float64), expected)
+            out = np.empty_like(data)
+            logicle.scale(data, out)
+            np.testing.assert_array_equal(out, expected.astype(np.float32))
+
+            expected = np.empty(data.shape)
+            logicle.inverse(out.astype(np.float64), expected)
+            logicle.inverse(out, out)
+            np.testing.assert_array_equal(out, expected.astype(np.float32))
+
+            with self.assertRaises(TypeError):
+                logicle.scale(data, np.empty(data.shape))
+
+        data = np.linspace(-1e5, 1e6, 100001).astype(np.float32)
+        expected = np.empty(data.shape)
+        fast.clipScale(data.astype(np.float64), expected)
+        out = np.empty_like(data)
+        fast.clipScale(data, out)
+        np.testing.assert_array_equal(out, expected.astype(np.float32))
+
+        # and the scale keeps float32 data float32
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        x = scale(self.ex["Y2-A"].values.astype(np.float32))
+        self.assertEqual(x.dtype, np.float32)
+
+    def test_logicle_outside(self):
+        """
+        The batch transforms that handle values off the table themselves
+        clip them or make them NaN, report where they were, and don't raise
+        """
+
+        from cytoflow.utility.logicle_ext.Logicle import FastLogicle, HermiteLogicle
+
+        for logicle in [FastLogicle(262144, 0.5), HermiteLogicle(262144, 0.5)]:
+            data = np.linspace(logicle.inverse(0.0), 250000, 200001)
+            data[[3, 100, 150000]] = [-1e9, 1e12, np.nan]
+
+            clipped = np.empty_like(data)
+            logicle.clipScale(data, clipped)
+            out = np.empty_like(data)
+            outside = logicle.scaleOutside(data, out, FastLogicle.CLIP_OUTSIDE)
+            self.assertEqual(outside, [3, 100])
+            np.testing.assert_array_equal(out, clipped)
+
+            outside = logicle.scaleOutside(data, out, FastLogicle.NAN_OUTSIDE)
+            self.assertEqual(outside, [3, 100])
+            self.assertTrue(np.all(np.isnan(out[[3, 100, 150000]])))
+            self.assertEqual(np.isnan(out).sum(), 3)
+
+            # in place, and the inverse
+            scale = np.linspace(0, 1, 10001)
+            scale[[0, 17, 5000]] = [-0.5, 1.5, np.nan]
+            outside = logicle.inverseOutside(scale, scale, FastLogicle.NAN_OUTSIDE)
+            self.assertEqual(outside, [0, 17, 10000])
+            self.assertEqual(np.isnan(scale).sum(), 4)
+
+            scale = np.array([-0.5, 0.5, 1.0, 1.5])
+            out = np.empty_like(scale)
+            outside = logicle.inverseOutside(scale, out, FastLogicle.CLIP_OUTSIDE)
+            self.assertEqual(outside, [0, 2, 3])
+            self.assertEqual(out[0], logicle.inverse(0.0))
+            self.assertEqual(out[2], out[3])
+            self.assertGreater(out[3], out[1])
+
+            with self.assertRaises(TypeError):
+                logicle.scaleOutside(data.astype(np.float32),
+                                     np.empty(data.shape, dtype = np.float32),
+                                     FastLogicle.CLIP_OUTSIDE)
+
+        # which is what the scale's inverse does with them
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        x = scale.inverse(np.array([-1.0, 0.0, 0.5, 2.0, np.nan]))
+        self.assertEqual(x[0], x[1])
+        self.assertTrue(np.isnan(x[4]))
+
+    def test_logicle_buffer(self):
+        """
+        The buffer scales what's appended, grows T past the largest event,
+        and re-scales what it has already when T does
+        """
+
+        from cytoflow.utility.logicle_ext.Logicle import FastLogicle
+
+        rng = np.random.default_rng(1)
+        data = 10 ** (3 + rng.standard_normal(10000))
+        data[::7] *= -0.01
+
+        buffer = util.LogicleBuffer(1000.0, 0.5)
+        for chunk in np.array_split(data, 13):
+            buffer.append(chunk)
+            self.assertGreaterEqual(buffer.T, chunk.max())
+        buffer.append([])
+
+        self.assertEqual(len(buffer), len(data))
+        self.assertEqual(buffer.T, data.max())
+        np.testing.assert_array_equal(buffer.raw, data)
+
+        expected = np.empty_like(data)
+        FastLogicle(data.max(), 0.5, 4.5, 0.0).clipScale(data, expected)
+        np.testing.assert_array_equal(buffer.scaled, expected)
+        with self.assertRaises(ValueError):
+            buffer.scaled[0] = 0.0
+
+        # T only moves up, by headroom, and not at all if it mustn't
+        buffer = util.LogicleBuffer(1000.0, 0.5, headroom = 2.0)
+        buffer.append([10.0, 2000.0, 3000.0])
+        self.assertEqual(buffer.T, 6000.0)
+        buffer.append([5000.0, np.nan, np.inf])
+        self.assertEqual(buffer.T, 6000.0)
+        self.assertTrue(np.isnan(buffer.scaled[4]))
+
+        buffer = util.LogicleBuffer(1000.0, 0.5, grow = False)
+        buffer.append([10.0, 2000.0])
+        self.assertEqual(buffer.T, 1000.0)
+        self.assertAlmostEqual(buffer.scaled[1], 1.0)
+
+        with self.assertRaises(util.CytoflowError):
+            util.LogicleBuffer(1000.0, 0.5, headroom = 0.5)
+        with self.assertRaises(util.CytoflowError):
+            util.LogicleBuffer(-1.0, 0.5)
+
+        # from a scale, whose channel here has a range
+        scale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        buffer = scale.buffer()
+        self.assertFalse(buffer.grow)
+        buffer.append(self.ex["Y2-A"].values)
+        np.testing.assert_allclose(buffer.scaled, scale(self.ex["Y2-A"].values),
+                                   rtol = 0, atol = 1e-6)
+
+
     ### TODO - test the apply function error checking
     
 if __name__ == "__main__":
@@ -24,7 +24,10 @@ Created on Dec 1, 2015
 '''
 import unittest
 import os
+import numpy as np
+import matplotlib as mpl
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataSmallTest
 
 
@@ -46,6 +49,30 @@ class Test(ImportedDataSmallTest):
         # how many events ended up in the gate?
         self.assertEqual(ex2.data.groupby("Polygon").size()[True], 4126)
         
+    def testNativeGate(self):
+        # a polygon drawn on logicle axes, tested natively, agrees with 
+        # matplotlib's path on the scaled data
+        x = self.ex["Y2-A"]
+        y = self.ex["V2-A"]
+        xscale = util.scale_factory("logicle", self.ex, channel = "Y2-A")
+        yscale = util.scale_factory("logicle", self.ex, channel = "V2-A")
+        vertices = [(20, 5000), (4000, 10000), (30000, 200), (500, -50)]
+
+        gate = util.polygon_gate(self.ex, "Y2-A", xscale, "V2-A", yscale, vertices)
+        path = mpl.path.Path(np.array([(xscale(vx), yscale(vy)) for vx, vy in vertices]))
+        expected = path.contains_points(np.column_stack((xscale(x.values), yscale(y.values))))
+        self.assertGreater(expected.sum(), 0)
+        self.assertLessEqual((gate.values != expected).sum(), 2)
+
+        # scales without a native axis aren't gated natively
+        class Scale(object):
+            def __call__(self, data):
+                return data
+        self.assertIsNone(util.polygon_gate(self.ex, "Y2-A", Scale(), "V2-A", yscale, vertices))
+
+        with self.assertRaises(util.CytoflowError):
+            util.polygon_gate(self.ex, "Y2-A", xscale, "V2-A", yscale, vertices[:2])
+        
     def testPlot(self):
         self.gate.default_view().plot(self.ex)
 
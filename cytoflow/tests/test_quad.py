@@ -24,7 +24,9 @@ Created on Dec 1, 2015
 '''
 import unittest
 import os
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataSmallTest
 
 
@@ -46,6 +48,16 @@ class Test(ImportedDataSmallTest):
         self.assertEqual(ex2.data.groupby("Quad").size().loc["Quad_3"], 10799)
         self.assertEqual(ex2.data.groupby("Quad").size().loc["Quad_4"], 5017)
         
+    def testNativeGate(self):
+        # the native quadrants agree with pandas
+        x = self.ex["Y2-A"]
+        y = self.ex["V2-A"]
+        quadrant = util.quad_gate(self.ex, "Y2-A", 300, "V2-A", 100)
+        np.testing.assert_array_equal(quadrant == 1, (x < 300) & (y > 100))
+        np.testing.assert_array_equal(quadrant == 2, (x > 300) & (y > 100))
+        np.testing.assert_array_equal(quadrant == 3, (x < 300) & (y < 100))
+        np.testing.assert_array_equal(quadrant == 4, (x > 300) & (y < 100))
+        
     def testPlot(self):
         self.gate.default_view().plot(self.ex)
 
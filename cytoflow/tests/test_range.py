@@ -23,7 +23,9 @@ Created on Dec 1, 2015
 @author: brian
 '''
 import unittest
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataSmallTest  # @UnresolvedImport
 
 class Test(ImportedDataSmallTest):
@@ -40,6 +42,13 @@ class Test(ImportedDataSmallTest):
         # how many events ended up in the gate?
         self.assertEqual(ex2.data.groupby("Range").size()[True], 4111)
 
+    def testNativeGate(self):
+        # the native gate agrees with pandas
+        x = self.ex["Y2-A"]
+        gate = util.range_gate(self.ex, "Y2-A", 200, 1000)
+        np.testing.assert_array_equal(gate, x.between(200, 1000))
+        self.assertTrue(gate.index.equals(self.ex.data.index))
+
     def testPlot(self):
         self.gate.default_view().plot(self.ex)
 
@@ -24,7 +24,9 @@ Created on Dec 1, 2015
 '''
 import unittest
 import os
+import numpy as np
 import cytoflow as flow
+import cytoflow.utility as util
 from test_base import ImportedDataSmallTest
 
 
@@ -43,6 +45,14 @@ class Test(ImportedDataSmallTest):
         # how many events ended up in the gate?
         self.assertEqual(ex2.data.groupby("Range2D").size()[True], 4371)
         
+    def testNativeGate(self):
+        # the native gate agrees with pandas
+        x = self.ex["Y2-A"]
+        y = self.ex["V2-A"]
+        gate = util.range2d_gate(self.ex, "Y2-A", 200, 1000, "V2-A", 50, 500)
+        np.testing.assert_array_equal(gate, x.between(200, 1000) & y.between(50, 500))
+        self.assertTrue(gate.index.equals(self.ex.data.index))
+        
     def testPlot(self):
         self.gate.default_view().plot(self.ex)
 
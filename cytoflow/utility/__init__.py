@@ -18,14 +18,21 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 from .util_functions import (cartesian, iqr, geom_mean, geom_sd, geom_sd_range,
-                             geom_sem, geom_sem_range, num_hist_bins, sanitize_identifier, 
+                             geom_sem, geom_sem_range, num_hist_bins, 
+                             num_hist_bins_from_percentiles, sanitize_identifier, 
                              random_string, is_numeric, cov2corr)
 
 from .algorithms import ci
+from .gates import range_gate, range2d_gate, quad_gate, polygon_gate
+from .columns import (scale_columns, compensate_columns, kmeans_predict,
+                      gmm_predict)
+from .kde import kde_density, kde_density_2d
+from .transform_stats import transform_stats
 from .cytoflow_errors import CytoflowError, CytoflowOpError, CytoflowViewError
 from .cytoflow_errors import CytoflowWarning, CytoflowOpWarning, CytoflowViewWarning
 
 from .scale import scale_factory, IScale, set_default_scale, get_default_scale
+from .logicle_scale import LogicleBuffer
 from .custom_traits import (PositiveInt, PositiveCInt, PositiveFloat, 
                             PositiveCFloat, ScaleEnum, Deprecated, Removed, 
                             FloatOrNone, CFloatOrNone, IntOrNone, CIntOrNone)
@@ -27,6 +27,27 @@ Useful algorithms.
 import numpy as np
 from scipy import stats
 
+from .util_functions import geom_mean
+from .logicle_ext.Logicle import (bootstrapStatistic, selectPercentiles,
+                                  LOGICLE_MEAN, LOGICLE_MEDIAN, LOGICLE_GEOM_MEAN)
+
+# the summary functions the bootstrap computes natively
+_native_statistics = [(np.mean, LOGICLE_MEAN),
+                      (np.median, LOGICLE_MEDIAN),
+                      (geom_mean, LOGICLE_GEOM_MEAN)]
+
+def _native_statistic(func):
+    for f, statistic in _native_statistics:
+        if func is f:
+            return statistic
+    return None
+
+def _numeric(a):
+    a = np.asarray(a)
+    if a.dtype.kind not in "biuf":
+        return None
+    return np.ascontiguousarray(a, dtype = np.float64)
+
 def ci(data, func, which=95, boots=1000):
     """
     Determine the confidence interval of a function applied to a data set by
@@ -86,6 +107,17 @@ def percentiles(a, pcts, axis=None):
     except TypeError:
         pcts = [pcts]
         n = 0
+        
+    # the percentiles of all the values are selected natively
+    values = _numeric(a) if axis is None else None
+    if values is not None:
+        if not all(0 <= p <= 100 for p in pcts):
+            raise ValueError("percentiles must be in the range [0, 100]")
+        scores = np.asarray(selectPercentiles(values.ravel(), [float(p) for p in pcts]))
+        if not n:
+            scores = scores.squeeze()
+        return scores
+    
     for p in pcts:
         if axis is None:
             score = stats.scoreatpercentile(a.ravel(), p)
@@ -128,6 +160,14 @@ def bootstrap(*args, **kwargs):
     random_seed : int | None, default None
         Seed for the random number generator; useful if you want
         reproducible resamples.
+        
+    Notes
+    -----
+    A single one-dimensional array summarized with `numpy.mean`, 
+    `numpy.median` or `geom_mean` (and no ``axis``, ``units`` or 
+    ``smooth``) is bootstrapped natively, on all the CPUs, without 
+    copying the resamples.  Its resamples are reproducible with 
+    ``random_seed`` but aren't the ones numpy would draw.
             
     Returns
     -------
@@ -162,6 +202,17 @@ def bootstrap(*args, **kwargs):
         units = np.asarray(units)
 
     # Do the bootstrap
+    statistic = _native_statistic(func)
+    if (len(args) == 1 and args[0].ndim == 1 and statistic is not None
+            and axis is None and units is None and not smooth):
+        values = _numeric(args[0])
+        if values is not None:
+            boot_dist = np.empty(int(n_boot))
+            bootstrapStatistic(values, statistic, 
+                               int(rs.randint(0, 2 ** 62, dtype = np.int64)), 
+                               boot_dist)
+            return boot_dist
+        
     if smooth:
         return _smooth_bootstrap(args, n_boot, func, func_kwargs)
 
@@ -0,0 +1,333 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.utility.arcsinh_scale
+------------------------------
+'''
+
+from traits.api import (HasTraits, Float, Property, Instance, Str,
+                        cached_property, Undefined, provides, Constant,
+                        Tuple, Array)
+
+import numpy as np
+import pandas as pd
+
+import matplotlib.scale
+import matplotlib.colors
+from matplotlib import transforms
+from matplotlib.ticker import NullFormatter, LogFormatterMathtext
+from matplotlib.ticker import Locator
+
+from .scale import IScale, ScaleMixin, register_scale
+from .logicle_scale import _batch, _apply
+from .logicle_ext.Logicle import Arcsinh, FastArcsinh, GateAxis
+from .cytoflow_errors import CytoflowError
+
+@provides(IScale)
+class ArcsinhScale(ScaleMixin):
+    """
+    A scale that transforms the data using the inverse hyperbolic sine,
+    `asinh(x / cofactor)`.
+
+    Like `logicle` and `hlog`, this scale is linear near 0 and log-like for
+    large values (much larger than the cofactor.)  It's the usual transform
+    for mass cytometry data, with a cofactor of 5; for fluorescence data, a
+    cofactor of around 150 is more typical.
+
+    Attributes
+    ----------
+    cofactor : Float (default = 5)
+        the width of the linear region around 0.
+
+    References
+    ----------
+    [1] Extracting a cellular hierarchy from high-dimensional cytometry data
+        with SPADE.
+        Qiu P, Simonds EF, Bendall SC, et al.
+        Nat Biotechnol. 2011 Oct 2;29(10):886-91.
+        PMID: 21964415
+    """
+
+    id = Constant("edu.mit.synbio.cytoflow.utility.arcsinh")
+    name = "arcsinh"
+
+    experiment = Instance("cytoflow.Experiment")
+
+    # what data do we use to compute scale parameters?  set one.
+    channel = Str
+    condition = Str
+    statistic = Tuple(Str, Str)
+    error_statistic = Tuple(Str, Str)
+    data = Array
+
+    range = Property(Float)
+    cofactor = Float(5, desc = "the width of the linear region around 0")
+
+    _arcsinh = Property(Instance(Arcsinh), depends_on = "cofactor")
+
+    def __call__(self, data):
+        """
+        Transforms `data` using this scale.
+        """
+
+        try:
+            return _apply(self._arcsinh.scale, data)
+        except TypeError as e:
+            raise CytoflowError("Unknown data type in ArcsinhScale.__call__") from e
+        except ValueError as e:
+            raise CytoflowError(str(e))
+
+
+    def inverse(self, data):
+        """
+        Transforms 'data' using the inverse of this scale.
+        """
+
+        try:
+            return _apply(self._arcsinh.inverse, data)
+        except TypeError as e:
+            raise CytoflowError("Unknown data type in ArcsinhScale.inverse") from e
+        except ValueError as e:
+            raise CytoflowError(str(e))
+
+    def clip(self, data):
+        return data
+
+    def gate_axis(self):
+        return GateAxis(self._arcsinh)
+
+    def norm(self, vmin = None, vmax = None):
+        if vmin is not None and vmax is not None:
+            pass
+        elif self.channel:
+            vmin = self.experiment[self.channel].min()
+            vmax = self.experiment[self.channel].max()
+        elif self.condition:
+            vmin = self.experiment[self.condition].min()
+            vmax = self.experiment[self.condition].max()
+        elif self.statistic:
+            stat = self.experiment.statistics[self.statistic]
+            try:
+                vmin = min([min(x) for x in stat])
+                vmax = max([max(x) for x in stat])
+            except (TypeError, IndexError):
+                vmin = stat.min()
+                vmax = stat.max()
+        elif self.data.size > 0:
+            vmin = self.data.min()
+            vmax = self.data.max()
+        else:
+            raise CytoflowError("Must set one of 'channel', 'condition' "
+                                "or 'statistic'.")
+
+        class ArcsinhNormalize(matplotlib.colors.Normalize):
+            def __init__(self, vmin, vmax, scale):
+                self._scale = scale
+                matplotlib.colors.Normalize.__init__(self, vmin, vmax)
+
+            def __call__(self, value, clip = None):
+                # normalize in scale space, so that the colors are spread
+                # out the same way as the axes are
+                lo = self._scale(float(self.vmin))
+                hi = self._scale(float(self.vmax))
+                scaled_value = (np.asarray(self._scale(value)) - lo) / (hi - lo)
+                return np.ma.masked_array(scaled_value)
+
+        return ArcsinhNormalize(vmin, vmax, self)
+
+    @cached_property
+    def _get__arcsinh(self):
+        try:
+            return Arcsinh(self.cofactor)
+        except ValueError as e:
+            raise CytoflowError(str(e))
+
+    def _get_range(self):
+        if self.experiment:
+            if self.channel and self.channel in self.experiment.channels:
+                if "range" in self.experiment.metadata[self.channel]:
+                    return self.experiment.metadata[self.channel]["range"]
+                else:
+                    return self.experiment.data[self.channel].max()
+            elif self.condition and self.condition in self.experiment.conditions:
+                return self.experiment.data[self.condition].max()
+            elif self.statistic and self.statistic in self.experiment.statistics:
+                return self.experiment.statistics[self.statistic].max()
+            elif self.data.size > 0:
+                return self.data.max()
+            else:
+                return Undefined
+        else:
+            return Undefined
+
+    def get_mpl_params(self, ax):
+        return {"cofactor" : self.cofactor,
+                "range" : self.range}
+
+register_scale(ArcsinhScale)
+
+class MatplotlibArcsinhScale(HasTraits, matplotlib.scale.ScaleBase):
+    name = "arcsinh"
+
+    cofactor = Float(Undefined)
+    range = Float
+
+    def __init__(self, axis, **kwargs):
+        HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
+
+    def get_transform(self):
+        """
+        Returns the matplotlib.transform instance that does the actual
+        transformation
+        """
+        if self.cofactor is Undefined:
+            # this usually happens when someone tries to say
+            # plt.xscale("arcsinh").  you can, in fact, do that, but
+            # you have to get a parameterized instance of the transform
+            # from utility.scale.scale_factory().
+
+            raise CytoflowError("You can't set an 'arcsinh' scale directly.")
+
+        return MatplotlibArcsinhScale.ArcsinhTransform(cofactor = self.cofactor,
+                                                       range = self.range)
+
+    def set_default_locators_and_formatters(self, axis):
+        """
+        Set the locators and formatters to reasonable defaults for
+        arcsinh scaling.
+        """
+        axis.set_major_locator(ArcsinhMajorLocator(self.cofactor))
+        axis.set_major_formatter(LogFormatterMathtext(10))
+        axis.set_minor_locator(ArcsinhMinorLocator(self.cofactor))
+        axis.set_minor_formatter(NullFormatter())
+
+    class ArcsinhTransform(HasTraits, transforms.Transform):
+        input_dims = 1
+        output_dims = 1
+        is_separable = True
+        has_inverse = True
+
+        # the arcsinh params
+        cofactor = Float
+        range = Float
+
+        # the arcsinh itself.  plotting doesn't need every last digit, so
+        # use the lookup table
+        _arcsinh = Property(Instance(FastArcsinh), depends_on = "[cofactor, range]")
+
+        def __init__(self, **kwargs):
+            transforms.Transform.__init__(self)
+            HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
+
+        @cached_property
+        def _get__arcsinh(self):
+            return FastArcsinh(self.cofactor, self.range)
+
+        def transform_non_affine(self, values):
+            if isinstance(values, (pd.Series, np.ndarray, float)):
+                return _apply(self._arcsinh.scale, values)
+            else:
+                raise CytoflowError("Unknown data type in MatplotlibArcsinhScale.ArcsinhTransform.transform_non_affine")
+
+        def inverted(self):
+            return MatplotlibArcsinhScale.InvertedArcsinhTransform(cofactor = self.cofactor,
+                                                                   range = self.range)
+
+    class InvertedArcsinhTransform(HasTraits, transforms.Transform):
+        input_dims = 1
+        output_dims = 1
+        is_separable = True
+        has_inverse = True
+
+        # the arcsinh params
+        cofactor = Float
+        range = Float
+
+        _arcsinh = Property(Instance(FastArcsinh), depends_on = "[cofactor, range]")
+
+        def __init__(self, **kwargs):
+            transforms.Transform.__init__(self)
+            HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
+
+        @cached_property
+        def _get__arcsinh(self):
+            return FastArcsinh(self.cofactor, self.range)
+
+        def transform_non_affine(self, values):
+            if isinstance(values, (pd.Series, np.ndarray, float)):
+                return _apply(self._arcsinh.inverse, values)
+            else:
+                raise CytoflowError("Unknown data type in MatplotlibArcsinhScale.InvertedArcsinhTransform.transform_non_affine")
+
+        def inverted(self):
+            return MatplotlibArcsinhScale.ArcsinhTransform(cofactor = self.cofactor,
+                                                           range = self.range)
+
+
+class ArcsinhMajorLocator(Locator):
+    """
+    Determine the tick locations for arcsinh axes: 0, and every decade in the
+    log-like region (above the cofactor), positive and negative.
+    """
+
+    def __init__(self, cofactor):
+        self.cofactor = cofactor
+
+    def set_params(self):
+        """Empty"""
+        pass
+
+    def __call__(self):
+        'Return the locations of the ticks'
+        vmin, vmax = self.axis.get_view_interval()
+        return self.tick_values(vmin, vmax)
+
+    def _decades(self, vmin, vmax):
+        'The powers of 10 at and above the cofactor, up to the view limits'
+        top = max(abs(vmin), abs(vmax), self.cofactor)
+        return 10 ** np.arange(np.ceil(np.log10(self.cofactor)),
+                               np.ceil(np.log10(top)) + 1)
+
+    def tick_values(self, vmin, vmax):
+        if vmax < vmin:
+            vmin, vmax = vmax, vmin
+
+        decades = self._decades(vmin, vmax)
+        ticks = np.concatenate((-decades[::-1], [0.0], decades))
+
+        return self.raise_if_exceeds(ticks[(ticks >= vmin) & (ticks <= vmax)])
+
+class ArcsinhMinorLocator(ArcsinhMajorLocator):
+    """
+    Determine the minor tick locations for arcsinh axes: every tenth of a
+    decade in the log-like region.
+    """
+
+    def tick_values(self, vmin, vmax):
+        if vmax < vmin:
+            vmin, vmax = vmax, vmin
+
+        decades = self._decades(vmin, vmax)
+        ticks = np.outer(decades, np.arange(1, 10)).ravel()
+        ticks = np.concatenate((-ticks[::-1], ticks))
+
+        return self.raise_if_exceeds(ticks[(ticks >= vmin) & (ticks <= vmax)])
+
+matplotlib.scale.register_scale(MatplotlibArcsinhScale)
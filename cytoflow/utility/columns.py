@@ -0,0 +1,237 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.utility.columns
+------------------------
+
+Several channels put on their scales (or compensated, or assigned to 
+clusters) natively, in one multithreaded pass over the events (see 
+``logicle_ext/columns.h`` and ``logicle_ext/clusters.h``.)
+'''
+
+import numpy as np
+import pandas as pd
+
+from .logicle_ext.Logicle import (scaleColumns, compensateColumns, 
+                                  NearestCentroid, GaussianMixture)
+from .cytoflow_errors import CytoflowError
+
+def _axes(scales, columns):
+    # a native axis for each column's scale, or None if any of them can't
+    # be evaluated natively (see IScale.gate_axis)
+    axes = [scales[c].gate_axis() if hasattr(scales[c], 'gate_axis') else None
+            for c in columns]
+    return None if any(axis is None for axis in axes) else axes
+
+def _values(data):
+    # a DataFrame with one dtype is usually stored a column at a time, 
+    # so take whichever order the values are already in, and make the 
+    # output the same
+    values = data.values.astype(np.float64, copy = False)
+    if not values.flags.c_contiguous and not values.flags.f_contiguous:
+        values = np.ascontiguousarray(values)
+    fortran = not values.flags.c_contiguous
+    
+    return values, np.empty_like(values, order = 'F' if fortran else 'C'), fortran
+
+def scale_columns(data, scales):
+    """
+    Put each column of ``data`` on its scale, like ``scales[c](data[c])``
+    for each column ``c``.  If all the scales can be evaluated natively 
+    (see `IScale.gate_axis`), all the columns are transformed in one pass 
+    over the events; otherwise they're transformed one at a time.
+    
+    Parameters
+    ----------
+    data : pandas.DataFrame
+        The data values, eg. ``experiment.data.loc[:, channels]``.
+        
+    scales : dict
+        An `IScale` for each of ``data``'s columns.
+    
+    Returns
+    -------
+    pandas.DataFrame
+        The scaled values, with ``data``'s index and columns.
+    """
+    
+    columns = list(data.columns)
+    
+    axes = _axes(scales, columns)
+    if axes is None:
+        ret = data.copy()
+        for c in columns:
+            ret[c] = scales[c](ret[c])
+        return ret
+    
+    values, scaled, fortran = _values(data)
+    try:
+        scaleColumns(axes, values.ravel(order = 'K'), scaled.ravel(order = 'K'), fortran)
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    
+    return pd.DataFrame(scaled, index = data.index, columns = data.columns)
+
+def compensate_columns(data, matrix, scales = None):
+    """
+    Compensate ``data`` with ``matrix``, like ``numpy.dot(data, matrix)``,
+    and then (optionally) put each compensated column on its scale.  The
+    events are compensated and scaled a block at a time, so the
+    compensated values are never all kept if they're scaled.
+    
+    Parameters
+    ----------
+    data : pandas.DataFrame
+        The data values, eg. ``experiment.data.loc[:, channels]``.
+        
+    matrix : array_like
+        A square matrix with a row and a column for each of ``data``'s 
+        columns, eg. the inverse of a spillover matrix.
+        
+    scales : dict (optional)
+        An `IScale` for each of ``data``'s columns, each of which must be 
+        able to be evaluated natively (see `IScale.gate_axis`.)
+    
+    Returns
+    -------
+    pandas.DataFrame
+        The compensated (and scaled) values, with ``data``'s index and 
+        columns.
+    """
+    
+    columns = list(data.columns)
+    matrix = np.asarray(matrix, dtype = np.float64)
+    if matrix.shape != (len(columns), len(columns)):
+        raise CytoflowError("The matrix must have a row and a column for each "
+                            "of the data's columns")
+        
+    if scales is None:
+        axes = []
+    else:
+        axes = _axes(scales, columns)
+        if axes is None:
+            raise CytoflowError("All the scales must be able to be evaluated natively")
+        
+    values, compensated, fortran = _values(data)
+    try:
+        compensateColumns(matrix.ravel(), axes, values.ravel(order = 'K'), 
+                          compensated.ravel(order = 'K'), len(columns), fortran)
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    
+    return pd.DataFrame(compensated, index = data.index, columns = data.columns)
+
+def _events(data, scales):
+    # the events and the axes to scale them on as they're read, or, if the
+    # scales can't all be evaluated natively, the scaled events
+    axes = _axes(scales, list(data.columns))
+    if axes is None:
+        data = scale_columns(data, scales)
+        axes = []
+    values, _, fortran = _values(data)
+    return axes, values.ravel(order = 'K'), fortran
+
+def kmeans_predict(data, scales, kmeans):
+    """
+    Assign each event to the nearest of a fitted k-means model's clusters,
+    like ``kmeans.predict(scale_columns(data, scales))``, without keeping 
+    the scaled events.
+    
+    Parameters
+    ----------
+    data : pandas.DataFrame
+        The data values, a column for each of the channels the model was
+        fit on.
+        
+    scales : dict
+        An `IScale` for each of ``data``'s columns.
+        
+    kmeans : sklearn.cluster.KMeans or sklearn.cluster.MiniBatchKMeans
+        The fitted model.
+    
+    Returns
+    -------
+    numpy.ndarray
+        The cluster of each event, or -1 for events that are NaN on any 
+        of the scales.
+    """
+    
+    axes, values, fortran = _events(data, scales)
+    cluster = np.empty(len(data), dtype = np.int32)
+    try:
+        model = NearestCentroid(kmeans.cluster_centers_.ravel(), len(data.columns))
+        model.assign(axes, values, fortran, cluster)
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    return cluster
+
+def gmm_predict(data, scales, gmm, posteriors = False, distances = False):
+    """
+    The E-step of a fitted gaussian mixture model (with full covariances)
+    on each event, like ``gmm.predict(scale_columns(data, scales))``,
+    without keeping the scaled events.
+    
+    Parameters
+    ----------
+    data : pandas.DataFrame
+        The data values, a column for each of the channels the model was
+        fit on.
+        
+    scales : dict
+        An `IScale` for each of ``data``'s columns.
+        
+    gmm : sklearn.mixture.GaussianMixture
+        The fitted model.
+        
+    posteriors : bool
+        Compute each event's posterior probability of each component too,
+        like ``gmm.predict_proba``?
+        
+    distances : bool
+        Compute each event's squared Mahalanobis distance to each 
+        component's mean too?
+    
+    Returns
+    -------
+    (numpy.ndarray, numpy.ndarray, numpy.ndarray)
+        The most likely component of each event (or -1 for events that are
+        NaN on any of the scales); and the posteriors and the distances, 
+        each with a row for each event and a column for each component, or
+        ``None`` if they weren't asked for.  Events that are NaN have 
+        posteriors of 0 and distances of NaN.
+    """
+    
+    axes, values, fortran = _events(data, scales)
+    k = len(gmm.weights_)
+    component = np.empty(len(data), dtype = np.int32)
+    posterior = np.empty((len(data), k)) if posteriors else np.empty(0)
+    distance = np.empty((len(data), k)) if distances else np.empty(0)
+    
+    try:
+        model = GaussianMixture(gmm.weights_, gmm.means_.ravel(), 
+                                gmm.precisions_cholesky_.ravel())
+        model.assign(axes, values, fortran, component, 
+                     posterior.ravel(), distance.ravel())
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    
+    return (component, 
+            posterior if posteriors else None, 
+            distance if distances else None)
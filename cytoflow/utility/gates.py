@@ -0,0 +1,121 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.utility.gates
+----------------------
+
+Gates evaluated natively on an experiment's data, in one multithreaded 
+pass over the events (see ``logicle_ext/gate.h``.)
+'''
+
+import numpy as np
+import pandas as pd
+
+from .logicle_ext.Logicle import PolygonGate, gateRange, gateRange2d, gateQuad
+from .cytoflow_errors import CytoflowError
+
+def _column(experiment, channel):
+    return np.ascontiguousarray(experiment[channel].values, dtype = np.float64)
+
+def _axis(scale):
+    # the scale's native axis, or None if it can't be evaluated natively
+    # (see IScale.gate_axis)
+    return scale.gate_axis() if hasattr(scale, 'gate_axis') else None
+
+def _mask(experiment, mask):
+    return pd.Series(mask, index = experiment.data.index)
+
+def range_gate(experiment, channel, low, high):
+    """
+    Which events have ``low <= channel <= high``, like `pandas.Series.between`.
+    
+    Returns
+    -------
+    pandas.Series
+        A boolean series with the experiment's index.
+    """
+    
+    mask = np.empty(len(experiment), dtype = bool)
+    gateRange(_column(experiment, channel), float(low), float(high), mask)
+    return _mask(experiment, mask)
+
+def range2d_gate(experiment, xchannel, xlow, xhigh, ychannel, ylow, yhigh):
+    """
+    Which events are in the rectangle from ``(xlow, ylow)`` to ``(xhigh, 
+    yhigh)``, edges included.
+    
+    Returns
+    -------
+    pandas.Series
+        A boolean series with the experiment's index.
+    """
+    
+    mask = np.empty(len(experiment), dtype = bool)
+    gateRange2d(_column(experiment, xchannel), _column(experiment, ychannel),
+                float(xlow), float(xhigh), float(ylow), float(yhigh), mask)
+    return _mask(experiment, mask)
+
+def quad_gate(experiment, xchannel, xthreshold, ychannel, ythreshold):
+    """
+    Which quadrant around ``(xthreshold, ythreshold)`` each event is in,
+    numbered like FACSDiva: 1 is upper left, 2 upper right, 3 lower left 
+    and 4 lower right.  Events on a threshold are 0.
+    
+    Returns
+    -------
+    numpy.ndarray
+        The quadrants, as ``uint8``.
+    """
+    
+    quadrant = np.empty(len(experiment), dtype = np.uint8)
+    gateQuad(_column(experiment, xchannel), _column(experiment, ychannel),
+             float(xthreshold), float(ythreshold), quadrant)
+    return quadrant
+
+def polygon_gate(experiment, xchannel, xscale, ychannel, yscale, vertices):
+    """
+    Which events are inside a polygon drawn on ``xscale`` and ``yscale``.
+    The vertices are data values; the polygon's edges are straight on the
+    scales.  The events are transformed onto the scales a block at a time
+    as they're tested, rather than all at once.
+    
+    Returns
+    -------
+    pandas.Series
+        A boolean series with the experiment's index, or ``None`` if 
+        either scale can't be evaluated natively (see 
+        `IScale.gate_axis`.)
+    """
+    
+    xaxis = _axis(xscale)
+    yaxis = _axis(yscale)
+    if xaxis is None or yaxis is None:
+        return None
+    
+    try:
+        gate = PolygonGate(xaxis, yaxis,
+                           [float(xscale(x)) for x, _ in vertices],
+                           [float(yscale(y)) for _, y in vertices])
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    
+    mask = np.empty(len(experiment), dtype = bool)
+    gate.contains(_column(experiment, xchannel), _column(experiment, ychannel), mask)
+    return _mask(experiment, mask)
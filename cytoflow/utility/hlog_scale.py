@@ -36,6 +36,8 @@ from matplotlib.ticker import NullFormatter, LogFormatterMathtext
 from matplotlib.ticker import Locator
 
 from .scale import IScale, ScaleMixin, register_scale
+from .logicle_scale import _batch, _apply
+from .logicle_ext.Logicle import Hlog, FastHlog, GateAxis
 from .cytoflow_errors import CytoflowError
 
 @provides(IScale)
@@ -89,20 +91,13 @@ class HlogScale(ScaleMixin):
         (ie, applying a log10 scale to negative numbers.)
         """
         
-        f = _make_hlog_numeric(self.b, 1.0, np.log10(self.range))
-
-        if isinstance(data, pd.Series):            
-            return data.apply(f)
-        elif isinstance(data, np.ndarray):
-            return f(data)
-        elif isinstance(data, (int, float)):
-            # numpy returns a 0-dim array.  wtf.
-            return float(f(data))
-        else:
-            try:
-                return list(map(f, data))
-            except TypeError as e:
-                raise CytoflowError("Unknown data type in HlogScale.__call__") from e
+        try:
+            hlog = Hlog(self.b, 1.0, np.log10(self.range))
+            return _apply(hlog.scale, data)
+        except TypeError as e:
+            raise CytoflowError("Unknown data type in HlogScale.__call__") from e
+        except ValueError as e:
+            raise CytoflowError(str(e))
 
         
     def inverse(self, data):
@@ -110,24 +105,23 @@ class HlogScale(ScaleMixin):
         Transforms 'data' using the inverse of this scale.
         """
         
-        f_inv = lambda y, b = self.b, d = np.log10(self.range): hlog_inv(y, b, 1.0, d)
-        
-        if isinstance(data, pd.Series):            
-            return data.apply(f_inv)
-        elif isinstance(data, np.ndarray):
-            inverse = np.vectorize(f_inv)
-            return inverse(data)
-        elif isinstance(data, float):
-            return f_inv(data)
-        else:
-            try:
-                return list(map(f_inv, data))
-            except TypeError as e:
-                raise CytoflowError("Unknown data type in HlogScale.inverse") from e
+        try:
+            hlog = Hlog(self.b, 1.0, np.log10(self.range))
+            return _apply(hlog.inverse, data)
+        except TypeError as e:
+            raise CytoflowError("Unknown data type in HlogScale.inverse") from e
+        except ValueError as e:
+            raise CytoflowError(str(e))
         
     def clip(self, data):
         return data
     
+    def gate_axis(self):
+        try:
+            return GateAxis(Hlog(self.b, 1.0, np.log10(self.range)))
+        except ValueError as e:
+            raise CytoflowError(str(e))
+    
     def norm(self):
         if self.channel:
             vmin = self.experiment[self.channel].min()
@@ -239,20 +233,28 @@ class MatplotlibHlogScale(HasTraits, matplotlib.scale.ScaleBase):
         b = Float
         range = Float
         
+        # the hyperlog itself.  plotting doesn't need every last digit, so 
+        # use the lookup table
+        _hlog = Property(Instance(FastHlog), depends_on = "[b, range]")
+        
         def __init__(self, **kwargs):
             transforms.Transform.__init__(self)
             HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
         
+        @cached_property
+        def _get__hlog(self):
+            return FastHlog(self.b, 1.0, np.log10(self.range))
+        
         def transform_non_affine(self, values):
             
-            f = _make_hlog_numeric(self.b, 1.0, np.log10(self.range))
-
             if isinstance(values, pd.Series):            
-                return values.apply(f)
+                return pd.Series(_batch(self._hlog.scale, values.values),
+                                 index = values.index,
+                                 name = values.name)
             elif isinstance(values, np.ndarray):
-                return f(values)
+                return _batch(self._hlog.scale, values)
             elif isinstance(values, float):
-                return f(values)
+                return self._hlog.scale(values)
             else:
                 raise CytoflowError("Unknown data type in MatplotlibHlogScale.HlogTransform.transform_non_affine")
 
@@ -260,7 +262,7 @@ class MatplotlibHlogScale(HasTraits, matplotlib.scale.ScaleBase):
         def inverted(self):
             return MatplotlibHlogScale.InvertedHlogTransform(b = self.b, range = self.range)
         
-    class InvertedLogicleTransform(HasTraits, transforms.Transform):
+    class InvertedHlogTransform(HasTraits, transforms.Transform):
         input_dims = 1
         output_dims = 1
         is_separable = True
@@ -270,23 +272,28 @@ class MatplotlibHlogScale(HasTraits, matplotlib.scale.ScaleBase):
         b = Float
         range = Float
         
+        _hlog = Property(Instance(FastHlog), depends_on = "[b, range]")
+        
         def __init__(self, **kwargs):
             transforms.Transform.__init__(self)
             HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
+            
+        @cached_property
+        def _get__hlog(self):
+            return FastHlog(self.b, 1.0, np.log10(self.range))
         
         def transform_non_affine(self, values):
             
-            f_inv = lambda y, b = self.b, d = np.log10(self.range): hlog_inv(y, b, 1.0, d)
-            
             if isinstance(values, pd.Series):            
-                return values.apply(f_inv)
+                return pd.Series(_batch(self._hlog.inverse, values.values),
+                                 index = values.index,
+                                 name = values.name)
             elif isinstance(values, np.ndarray):
-                inverse = np.vectorize(f_inv)
-                return inverse(values)
+                return _batch(self._hlog.inverse, values)
             elif isinstance(values, float):
-                return f_inv(values)
+                return self._hlog.inverse(values)
             else:
-                raise CytoflowError("Unknown data type in MatplotlibHlogScale.InvertedLogicleTransform.transform_non_affine")
+                raise CytoflowError("Unknown data type in MatplotlibHlogScale.InvertedHlogTransform.transform_non_affine")
         
         
         def inverted(self):
@@ -400,8 +407,6 @@ matplotlib.scale.register_scale(MatplotlibHlogScale)
 # http://gorelab.bitbucket.org/flowcytometrytools/
 # thanks, Eugene!
 
-import scipy.optimize
-
 def hlog_inv(y, b, r, d):
     '''
     Inverse of base 10 hyperlog transform.
@@ -418,9 +423,14 @@ def _make_hlog_numeric(b, r, d):
     '''
     Return a function that numerically computes the hlog transformation for given parameter values.
     '''
-    hlog_obj = lambda y, x, b, r, d: hlog_inv(y, b, r, d) - x
-    find_inv = np.vectorize(lambda x: scipy.optimize.brentq(hlog_obj, -2*r, 2*r, 
-                                        args=(x, b, r, d)))
+    h = Hlog(b, r, d)
+    
+    def find_inv(x):
+        if np.ndim(x) == 0:
+            return h.scale(float(x))
+        else:
+            return _batch(h.scale, x)
+        
     return find_inv 
 
 def hlog(x, b, r, d):
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.utility.kde
+--------------------
+
+Kernel density estimates computed natively from binned events, so that 
+their cost doesn't grow with the number of events (see 
+``logicle_ext/kde.h``.)  The data should already be on the plot's scale.
+'''
+
+import numpy as np
+
+from .logicle_ext.Logicle import KernelDensity
+from .cytoflow_errors import CytoflowError
+
+# the same kernels as sklearn.neighbors.KernelDensity
+_kernels = {"gaussian" : KernelDensity.GAUSSIAN,
+            "tophat" : KernelDensity.TOPHAT,
+            "epanechnikov" : KernelDensity.EPANECHNIKOV,
+            "exponential" : KernelDensity.EXPONENTIAL,
+            "linear" : KernelDensity.LINEAR,
+            "cosine" : KernelDensity.COSINE}
+
+def _values(a):
+    return np.ascontiguousarray(a, dtype = np.float64).ravel()
+
+def kde_density(data, points, kernel = "gaussian", bw = 1.0):
+    """
+    The kernel density estimate of ``data`` at each of ``points``, like 
+    ``numpy.exp(KernelDensity(kernel = kernel, bandwidth = bw).fit(data).score_samples(points))``.
+    
+    Returns
+    -------
+    numpy.ndarray
+        The densities, the same size as ``points``.
+    """
+    
+    if kernel not in _kernels:
+        raise CytoflowError("kernel must be one of {}".format(list(_kernels.keys())))
+    
+    points = _values(points)
+    density = np.empty_like(points)
+    try:
+        KernelDensity(_kernels[kernel], float(bw)).density(_values(data), points, density)
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    return density
+
+def kde_density_2d(x, y, xpoints, ypoints, bw = 1.0):
+    """
+    The gaussian kernel density estimate of the pairs ``(x, y)`` on the grid
+    of ``xpoints`` by ``ypoints``.
+    
+    Returns
+    -------
+    numpy.ndarray
+        The densities, with a row for each of ``ypoints`` and a column for 
+        each of ``xpoints`` (like `numpy.meshgrid`.)
+    """
+    
+    xpoints = _values(xpoints)
+    ypoints = _values(ypoints)
+    density = np.empty((len(ypoints), len(xpoints)))
+    
+    # a coarser grid than in 1D, since it's bins squared -- though never
+    # coarser than the bandwidth needs (see kde.h)
+    try:
+        KernelDensity(KernelDensity.GAUSSIAN, float(bw), 1 << 8) \
+            .density2d(_values(x), _values(y), xpoints, ypoints, density.ravel())
+    except ValueError as e:
+        raise CytoflowError(str(e))
+    return density
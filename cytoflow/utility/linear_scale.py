@@ -26,6 +26,7 @@ import matplotlib.colors
 
 from traits.api import Instance, Str, Dict, provides, Constant, Tuple, Array
 from .scale import IScale, ScaleMixin, register_scale
+from .logicle_ext.Logicle import GateAxis
 from .cytoflow_errors import CytoflowError
 
 @provides(IScale)
@@ -55,6 +56,9 @@ class LinearScale(ScaleMixin):
     def clip(self, data):
         return data
     
+    def gate_axis(self):
+        return GateAxis()
+    
     def norm(self, vmin = None, vmax = None):
         if vmin is not None and vmax is not None:
             pass
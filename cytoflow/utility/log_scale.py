@@ -30,6 +30,7 @@ import pandas as pd
 import matplotlib.colors
 
 from .scale import IScale, ScaleMixin, register_scale
+from .logicle_ext.Logicle import GateAxis
 from .cytoflow_errors import CytoflowError
 from .util_functions import is_numeric
 
@@ -154,6 +155,19 @@ class LogScale(ScaleMixin):
             except TypeError as e:
                 raise CytoflowError("Unknown data type in LogScale.clip") from e
             
+    def gate_axis(self):
+        # the native axis needs a positive threshold.  there isn't one when
+        # the data has no positive values (the threshold is NaN), and then
+        # the scale is evaluated in Python, as it always was.
+        threshold = float(self.threshold)
+        if not threshold > 0:
+            return None
+        
+        try:
+            return GateAxis.log(threshold, self.mode == "mask")
+        except ValueError as e:
+            raise CytoflowError(str(e))
+            
     def norm(self, vmin = None, vmax = None):
         if vmin is not None and vmax is not None:
             pass
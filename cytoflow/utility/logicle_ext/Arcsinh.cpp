@@ -0,0 +1,46 @@
+#include "arcsinh.h"
+#include <cmath>
+
+Arcsinh::Arcsinh (double cofactor)
+{
+	if (!(cofactor > 0))
+		throw Logicle::IllegalParameter("cofactor is not positive");
+
+	p = new arcsinh_params;
+	p->cofactor = cofactor;
+	p->T = 0;
+
+	logicle_table_init(&p->table);
+}
+
+Arcsinh::Arcsinh (const Arcsinh & arcsinh)
+{
+	p = new arcsinh_params;
+	*p = *arcsinh.p;
+	logicle_table_init(&p->table);
+}
+
+Arcsinh::~Arcsinh ()
+{
+	delete p;
+}
+
+double Arcsinh::scale (double value) const
+{
+	return asinh(value / p->cofactor);
+}
+
+double Arcsinh::inverse (double scale) const
+{
+	return p->cofactor * sinh(scale);
+}
+
+void Arcsinh::scale (const double * value, double * scale, size_t n) const
+{
+	Transform::scale(value, scale, n);
+}
+
+void Arcsinh::inverse (const double * scale, double * value, size_t n) const
+{
+	Transform::inverse(scale, value, n);
+}
@@ -0,0 +1,162 @@
+#include "clusters.h"
+#include "columns.h"
+#include "threads.h"
+#include <cmath>
+
+// a block's worth of events, read a column at a time
+static const size_t BLOCK = 256;
+
+static const double LOG_2PI = log(2 * 3.14159265358979323846);
+
+NearestCentroid::NearestCentroid (const std::vector<double> & centroid, size_t columns)
+	: d(columns), centroid(centroid)
+{
+	if (columns == 0 || centroid.empty() || centroid.size() % columns != 0)
+		throw Logicle::IllegalParameter("the centroids aren't rows of columns values");
+	k = centroid.size() / columns;
+}
+
+void NearestCentroid::assign (const std::vector<GateAxis> & axis, const double * in,
+	size_t rows, bool fortran, int * cluster) const
+{
+	logicle_parallel(rows, [this, &axis, in, rows, fortran, cluster] (size_t begin, size_t end) {
+		std::vector<double> block(d * BLOCK);
+		double nearest[BLOCK], distance[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			logicle_read_rows(axis, in, rows, d, fortran, i, m, block.data(), BLOCK);
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				const double * mu = &centroid[c * d];
+				for (size_t r = 0; r < m; ++r)
+					distance[r] = 0;
+				for (size_t j = 0; j < d; ++j)
+				{
+					const double * x = &block[j * BLOCK];
+					for (size_t r = 0; r < m; ++r)
+					{
+						double delta = x[r] - mu[j];
+						distance[r] += delta * delta;
+					}
+				}
+
+				for (size_t r = 0; r < m; ++r)
+				{
+					if (c == 0)
+					{
+						nearest[r] = distance[r];
+						cluster[i + r] = distance[r] == distance[r] ? 0 : -1;
+					}
+					else if (distance[r] < nearest[r])
+					{
+						nearest[r] = distance[r];
+						cluster[i + r] = (int) c;
+					}
+				}
+			}
+		}
+	}, d * k);
+}
+
+GaussianMixture::GaussianMixture (const std::vector<double> & weight,
+	const std::vector<double> & mean, const std::vector<double> & precisionCholesky)
+	: k(weight.size()), mean(mean), factor(precisionCholesky)
+{
+	if (k == 0 || mean.empty() || mean.size() % k != 0)
+		throw Logicle::IllegalParameter("the means aren't a row for each component");
+	d = mean.size() / k;
+	if (factor.size() != k * d * d)
+		throw Logicle::IllegalParameter("the precisions aren't a matrix for each component");
+
+	// log(weight) + log(det(factor)) - d log(2 pi) / 2, where the factor
+	// is triangular
+	for (size_t c = 0; c < k; ++c)
+	{
+		if (!(weight[c] > 0))
+			throw Logicle::IllegalParameter("a weight is not positive");
+		double logDet = 0;
+		for (size_t j = 0; j < d; ++j)
+			logDet += log(factor[(c * d + j) * d + j]);
+		offset.push_back(log(weight[c]) + logDet - 0.5 * d * LOG_2PI);
+	}
+}
+
+void GaussianMixture::assign (const std::vector<GateAxis> & axis, const double * in,
+	size_t rows, bool fortran, int * component, double * posterior, double * distance) const
+{
+	logicle_parallel(rows, [=, &axis] (size_t begin, size_t end) {
+		std::vector<double> block(d * BLOCK);
+
+		// the (scaled) log likelihoods, a column of the block's events for
+		// each component
+		std::vector<double> likelihood(k * BLOCK);
+		double y[BLOCK], maha[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			logicle_read_rows(axis, in, rows, d, fortran, i, m, block.data(), BLOCK);
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				// the squared norm of (x - mean) . factor, a column of the
+				// product at a time
+				const double * mu = &mean[c * d];
+				const double * f = &factor[c * d * d];
+				for (size_t r = 0; r < m; ++r)
+					maha[r] = 0;
+				for (size_t j = 0; j < d; ++j)
+				{
+					for (size_t r = 0; r < m; ++r)
+						y[r] = 0;
+					for (size_t l = 0; l < d; ++l)
+					{
+						const double weight = f[l * d + j];
+						const double shift = mu[l];
+						const double * x = &block[l * BLOCK];
+						for (size_t r = 0; r < m; ++r)
+							y[r] += (x[r] - shift) * weight;
+					}
+					for (size_t r = 0; r < m; ++r)
+						maha[r] += y[r] * y[r];
+				}
+
+				double * lp = &likelihood[c * BLOCK];
+				for (size_t r = 0; r < m; ++r)
+					lp[r] = offset[c] - 0.5 * maha[r];
+				if (distance)
+					for (size_t r = 0; r < m; ++r)
+						distance[(i + r) * k + c] = maha[r];
+			}
+
+			for (size_t r = 0; r < m; ++r)
+			{
+				// the most likely component, and the posteriors relative to
+				// it so that nothing underflows
+				size_t best = 0;
+				for (size_t c = 1; c < k; ++c)
+					if (likelihood[c * BLOCK + r] > likelihood[best * BLOCK + r])
+						best = c;
+				double top = likelihood[best * BLOCK + r];
+				bool missing = top != top;
+				component[i + r] = missing ? -1 : (int) best;
+
+				if (!posterior)
+					continue;
+				double * p = posterior + (i + r) * k;
+				if (missing)
+				{
+					for (size_t c = 0; c < k; ++c)
+						p[c] = 0;
+					continue;
+				}
+				double sum = 0;
+				for (size_t c = 0; c < k; ++c)
+					sum += p[c] = exp(likelihood[c * BLOCK + r] - top);
+				for (size_t c = 0; c < k; ++c)
+					p[c] /= sum;
+			}
+		}
+	}, d * d * k);
+}
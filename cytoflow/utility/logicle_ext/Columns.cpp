@@ -0,0 +1,131 @@
+#include "columns.h"
+#include "threads.h"
+#include <cstring>
+
+// at most this many values (ie. 64k) in a block, so that a C order block
+// stays in the cache while it's visited a column at a time
+static const size_t BLOCK = 8192;
+static const size_t MAXIMUM_ROWS = 1024;
+
+// how many rows of a matrix with this many columns make a block
+static size_t block_rows (size_t columns)
+{
+	size_t rows = BLOCK / columns;
+	if (rows > MAXIMUM_ROWS)
+		rows = MAXIMUM_ROWS;
+	if (rows < 1)
+		rows = 1;
+	return rows;
+}
+
+void logicle_scale_columns (const std::vector<GateAxis> & axis,
+	const double * in, double * out, size_t rows, bool fortran)
+{
+	const size_t columns = axis.size();
+	if (columns == 0)
+		return;
+
+	// the distance from one row to the next, and one column to the next
+	const size_t rowStride = fortran ? 1 : columns;
+	const size_t columnStride = fortran ? rows : 1;
+
+	const size_t blockRows = block_rows(columns);
+
+	logicle_parallel(rows, [&axis, in, out, columns, rowStride, columnStride, blockRows]
+		(size_t begin, size_t end) {
+		double block[MAXIMUM_ROWS];
+		for (size_t i = begin; i < end; i += blockRows)
+		{
+			size_t m = end - i < blockRows ? end - i : blockRows;
+			for (size_t j = 0; j < columns; ++j)
+			{
+				const double * from = in + i * rowStride + j * columnStride;
+				double * to = out + i * rowStride + j * columnStride;
+
+				// a column of a fortran matrix is already contiguous, so
+				// scale it where it's going.  the batch transforms run
+				// serially here, since we're already in parallel.
+				if (rowStride == 1)
+				{
+					if (to != from)
+						memcpy(to, from, m * sizeof(double));
+					axis[j].scale(to, m);
+					continue;
+				}
+
+				for (size_t k = 0; k < m; ++k)
+					block[k] = from[k * rowStride];
+				axis[j].scale(block, m);
+				for (size_t k = 0; k < m; ++k)
+					to[k * rowStride] = block[k];
+			}
+		}
+	}, columns);
+}
+
+void logicle_compensate_columns (const std::vector<double> & matrix,
+	const std::vector<GateAxis> & axis, const double * in, double * out,
+	size_t rows, size_t columns, bool fortran)
+{
+	if (columns == 0)
+		return;
+
+	const size_t rowStride = fortran ? 1 : columns;
+	const size_t columnStride = fortran ? rows : 1;
+	const size_t blockRows = block_rows(columns);
+	const double * a = matrix.data();
+
+	logicle_parallel(rows, [&axis, a, in, out, rows, columns, fortran, rowStride, columnStride,
+		blockRows] (size_t begin, size_t end) {
+		// the block's input a column at a time, so that the sums below
+		// run down contiguous columns (and vectorize)
+		std::vector<double> block(columns * blockRows);
+		double result[MAXIMUM_ROWS];
+		for (size_t i = begin; i < end; i += blockRows)
+		{
+			size_t m = end - i < blockRows ? end - i : blockRows;
+
+			// all of the block's rows are read before any are written,
+			// so in and out can be the same
+			logicle_read_rows(std::vector<GateAxis>(), in, rows, columns, fortran,
+				i, m, block.data(), blockRows);
+
+			for (size_t j = 0; j < columns; ++j)
+			{
+				for (size_t r = 0; r < m; ++r)
+					result[r] = 0;
+				for (size_t k = 0; k < columns; ++k)
+				{
+					const double weight = a[k * columns + j];
+					const double * from = &block[k * blockRows];
+					for (size_t r = 0; r < m; ++r)
+						result[r] += from[r] * weight;
+				}
+
+				if (!axis.empty())
+					axis[j].scale(result, m);
+
+				double * to = out + i * rowStride + j * columnStride;
+				for (size_t r = 0; r < m; ++r)
+					to[r * rowStride] = result[r];
+			}
+		}
+	}, columns);
+}
+
+void logicle_read_rows (const std::vector<GateAxis> & axis, const double * in,
+	size_t rows, size_t columns, bool fortran, size_t row, size_t m,
+	double * block, size_t stride)
+{
+	const size_t rowStride = fortran ? 1 : columns;
+	const size_t columnStride = fortran ? rows : 1;
+	for (size_t j = 0; j < columns; ++j)
+	{
+		const double * from = in + row * rowStride + j * columnStride;
+		double * to = block + j * stride;
+		for (size_t r = 0; r < m; ++r)
+			to[r] = from[r * rowStride];
+		if (!axis.empty())
+			axis[j].scale(to, m);
+	}
+}
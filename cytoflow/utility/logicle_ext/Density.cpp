@@ -0,0 +1,127 @@
+#include "density.h"
+#include "threads.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+const int DensityGrid::DEFAULT_CELLS = 1 << 9;
+
+DensityGrid::DensityGrid (const FastLogicle & xlogicle, const FastLogicle & ylogicle,
+	int cells)
+	: x(xlogicle), y(ylogicle), n(cells), total(0)
+{
+	if (cells <= 0)
+		throw Logicle::IllegalParameter("cells is not positive");
+	if (cells > x.bins() || cells > y.bins())
+		throw Logicle::IllegalParameter("cells is more than a table's bins");
+
+	edges(x, xedge);
+	edges(y, yedge);
+	grid.assign((size_t) n * (size_t) n, 0.);
+}
+
+void DensityGrid::edges (const FastLogicle & logicle, std::vector<double> & edge) const
+{
+	// table bin b is in cell b * n / bins, so cell c starts at the first
+	// bin at or above c * bins / n
+	const long long bins = logicle.bins();
+	edge.resize(n + 1);
+	for (int c = 0; c <= n; ++c)
+		edge[c] = (double) ((c * bins + n - 1) / n) / (double) bins;
+}
+
+void DensityGrid::add (const double * xvalue, const double * yvalue, size_t m)
+{
+	const size_t cells = grid.size();
+	const long long xbins = x.bins(), ybins = y.bins();
+
+	std::mutex mutex;
+	logicle_parallel(m, [this, xvalue, yvalue, cells, xbins, ybins, &mutex] (size_t begin, size_t end) {
+		std::vector<double> local(cells, 0.);
+		double counted = 0;
+
+		const size_t BLOCK = 1024;
+		int xbin[BLOCK], ybin[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t k = end - i < BLOCK ? end - i : BLOCK;
+			x.intScale(xvalue + i, xbin, k);
+			y.intScale(yvalue + i, ybin, k);
+			for (size_t j = 0; j < k; ++j)
+			{
+				if (xbin[j] < 0 || ybin[j] < 0)
+					continue;
+				size_t cx = (size_t) (xbin[j] * n / xbins);
+				size_t cy = (size_t) (ybin[j] * n / ybins);
+				local[cx * n + cy] += 1;
+				counted += 1;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t c = 0; c < cells; ++c)
+			grid[c] += local[c];
+		total += counted;
+	});
+}
+
+void DensityGrid::pieces (const std::vector<double> & edge, double lo, double hi,
+	int bins, std::vector<Piece> & piece)
+{
+	const double width = (hi - lo) / bins;
+	for (int c = 0; c + 1 < (int) edge.size(); ++c)
+	{
+		double a = edge[c], b = edge[c + 1];
+		if (b <= lo || a >= hi)
+			continue;
+
+		// the bins the cell overlaps, and how much of it is in each
+		int first = std::max(0, (int) floor((a - lo) / width));
+		int last = std::min(bins - 1, (int) floor((b - lo) / width));
+		for (int j = first; j <= last; ++j)
+		{
+			double from = std::max(a, lo + j * width);
+			double to = std::min(b, lo + (j + 1) * width);
+			if (to > from)
+			{
+				Piece p = { c, j, (to - from) / (b - a) };
+				piece.push_back(p);
+			}
+		}
+	}
+}
+
+void DensityGrid::raster (double xlo, double xhi, int xbins, double ylo, double yhi,
+	int ybins, double * out) const
+{
+	if (xbins <= 0 || ybins <= 0)
+		throw Logicle::IllegalParameter("bins is not positive");
+	if (!(xlo < xhi) || !(ylo < yhi))
+		throw Logicle::IllegalParameter("lo is not less than hi");
+
+	std::vector<Piece> xpiece, ypiece;
+	pieces(xedge, xlo, xhi, xbins, xpiece);
+	pieces(yedge, ylo, yhi, ybins, ypiece);
+
+	// sum each row of cells into y bins, then the rows into x bins.  the
+	// pieces are in order of cell, so each row is only summed once.
+	std::fill(out, out + (size_t) xbins * ybins, 0.);
+	std::vector<double> row(ybins);
+	int summed = -1;
+	for (size_t i = 0; i < xpiece.size(); ++i)
+	{
+		const Piece & p = xpiece[i];
+		if (p.cell != summed)
+		{
+			std::fill(row.begin(), row.end(), 0.);
+			const double * cells = &grid[(size_t) p.cell * n];
+			for (size_t j = 0; j < ypiece.size(); ++j)
+				row[ypiece[j].bin] += cells[ypiece[j].cell] * ypiece[j].weight;
+			summed = p.cell;
+		}
+
+		double * bin = out + (size_t) p.bin * ybins;
+		for (int j = 0; j < ybins; ++j)
+			bin[j] += row[j] * p.weight;
+	}
+}
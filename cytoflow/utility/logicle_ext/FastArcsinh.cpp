@@ -0,0 +1,69 @@
+#include "arcsinh.h"
+#include "threads.h"
+#include <cmath>
+
+const int FastArcsinh::DEFAULT_BINS = 1 << 12;
+
+FastArcsinh::FastArcsinh (double cofactor, double T, int bins)
+	: Arcsinh(cofactor)
+{
+	if (!(T > 0))
+		throw Logicle::IllegalParameter("T is not positive");
+	if (bins < 2)
+		throw Logicle::IllegalParameter("bins is too small");
+
+	p->T = T;
+
+	// the table is symmetric about zero, so put a bin edge there
+	if (bins % 2)
+		++bins;
+	double top = Arcsinh::scale(T);
+	logicle_table_key key = { 'A', { cofactor, T, 0, 0 }, bins };
+	logicle_table_cached(&p->table, key, -top, 2 * top, [this, top] (logicle_table * table) {
+		for (int i = 0; i <= table->bins; ++i)
+			table->lookup[i] = Arcsinh::inverse(top * (2 * i - table->bins) / (double) table->bins);
+	});
+}
+
+FastArcsinh::FastArcsinh (const FastArcsinh & arcsinh) : Arcsinh(arcsinh)
+{
+	logicle_table_share(&p->table, &arcsinh.p->table);
+}
+
+FastArcsinh::~FastArcsinh ()
+{
+	logicle_table_destroy(&p->table);
+}
+
+double FastArcsinh::scale (double value) const
+{
+	// off the ends of the table, compute it directly
+	int bin = logicle_table_bin(&p->table, value);
+	if (bin < 0)
+		return Arcsinh::scale(value);
+
+	return logicle_table_scale(&p->table, bin, value);
+}
+
+double FastArcsinh::inverse (double scale) const
+{
+	double x = logicle_table_position(&p->table, scale);
+	if (!(x >= 0 && x < p->table.bins))
+		return Arcsinh::inverse(scale);
+
+	return logicle_table_inverse(&p->table, (int)floor(x), x);
+}
+
+void FastArcsinh::scale (const double * value, double * scale, size_t n) const
+{
+	logicle_parallel(n, [this, value, scale] (size_t begin, size_t end) {
+		tableScale(&p->table, value + begin, scale + begin, end - begin);
+	});
+}
+
+void FastArcsinh::inverse (const double * scale, double * value, size_t n) const
+{
+	logicle_parallel(n, [this, scale, value] (size_t begin, size_t end) {
+		tableInverse(&p->table, scale + begin, value + begin, end - begin);
+	});
+}
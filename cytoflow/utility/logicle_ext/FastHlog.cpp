@@ -0,0 +1,65 @@
+#include "hlog.h"
+#include "threads.h"
+#include <cmath>
+
+const int FastHlog::DEFAULT_BINS = 1 << 12;
+
+FastHlog::FastHlog (double b, double r, double d, int bins)
+	: Hlog(b, r, d)
+{
+	if (bins < 2)
+		throw Logicle::IllegalParameter("bins is too small");
+
+	// the table is over scale [-r, r].  the middle bin edge is at zero,
+	// where the transform is most nearly linear
+	if (bins % 2)
+		++bins;
+	logicle_table_key key = { 'H', { b, r, d, 0 }, bins };
+	logicle_table_cached(&p->table, key, -r, 2 * r, [this, r] (logicle_table * table) {
+		for (int i = 0; i <= table->bins; ++i)
+			table->lookup[i] = Hlog::inverse(r * (2 * i - table->bins) / (double) table->bins);
+	});
+}
+
+FastHlog::FastHlog (const FastHlog & hlog) : Hlog(hlog)
+{
+	logicle_table_share(&p->table, &hlog.p->table);
+}
+
+FastHlog::~FastHlog ()
+{
+	logicle_table_destroy(&p->table);
+}
+
+double FastHlog::scale (double value) const
+{
+	// off the ends of the table, solve for the scale
+	int bin = logicle_table_bin(&p->table, value);
+	if (bin < 0)
+		return Hlog::scale(value);
+
+	return logicle_table_scale(&p->table, bin, value);
+}
+
+double FastHlog::inverse (double scale) const
+{
+	double x = logicle_table_position(&p->table, scale);
+	if (!(x >= 0 && x < p->table.bins))
+		return Hlog::inverse(scale);
+
+	return logicle_table_inverse(&p->table, (int)floor(x), x);
+}
+
+void FastHlog::scale (const double * value, double * scale, size_t n) const
+{
+	logicle_parallel(n, [this, value, scale] (size_t begin, size_t end) {
+		tableScale(&p->table, value + begin, scale + begin, end - begin);
+	});
+}
+
+void FastHlog::inverse (const double * scale, double * value, size_t n) const
+{
+	logicle_parallel(n, [this, scale, value] (size_t begin, size_t end) {
+		tableInverse(&p->table, scale + begin, value + begin, end - begin);
+	});
+}
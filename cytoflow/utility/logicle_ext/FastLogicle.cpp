@@ -1,15 +1,78 @@
 #include "logicle.h"
+#include "threads.h"
 #include <memory.h>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <mutex>
 
 const int FastLogicle::DEFAULT_BINS = 1 << 12;
 
+// how many table entries fill() computes by recurrence between direct
+// evaluations of the exponentials
+const int FastLogicle::FILL_ANCHOR = 16;
+
 void FastLogicle::initialize (int bins)
 {
-	p->bins = bins;
-	p->lookup = new double[bins + 1];
-	for (int i = 0; i <= bins; ++i)
-		p->lookup[i] = Logicle::inverse((double)i / (double) bins);
+	// building the table is most of the cost of a FastLogicle, so
+	// share it with any others that have the same parameters
+	logicle_table_key key = { 'L', { p->T, p->W, p->M, p->A }, bins };
+	logicle_table_cached(&p->table, key, 0, 1, [this] (logicle_table * table) {
+		fill(table);
+	});
+}
+
+void FastLogicle::fill (logicle_table * table) const
+{
+	// the scale points are evenly spaced, so rather than evaluating both
+	// exponentials for each of them, step them along by multiplying by
+	// exp(b h) and exp(-d h).  every FILL_ANCHOR entries (and on either
+	// side of data zero) start again from exp() so that the rounding
+	// errors don't pile up.  the exponential terms stay within a couple
+	// of FILL_ANCHOR ULP of Logicle::inverse's, which is far below the
+	// interpolation error of the table.
+	const int bins = table->bins;
+	const double h = 1. / bins;
+	const double upB = exp(p->b * h), downB = exp(-p->b * h);
+	const double upD = exp(-p->d * h), downD = exp(p->d * h);
+	double * lookup = table->lookup;
+
+	logicle_parallel(bins + 1, [this, bins, upB, downB, upD, downD, lookup] (size_t begin, size_t end) {
+		double ebx = 0, emdx = 0;
+		int reflected = -1, steps = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			// reflect negative scale regions
+			double scale = (double) i / (double) bins;
+			bool negative = scale < p->x1;
+			if (negative)
+				scale = 2 * p->x1 - scale;
+
+			// near x1, i.e., data zero use the series expansion
+			if (scale < p->xTaylor)
+			{
+				double inverse = seriesBiexponential(scale);
+				lookup[i] = negative ? -inverse : inverse;
+				continue;
+			}
+
+			if (reflected != (int) negative || steps == FILL_ANCHOR)
+			{
+				ebx = exp(p->b * scale);
+				emdx = exp(-p->d * scale);
+				reflected = negative;
+				steps = 0;
+			}
+
+			double inverse = (p->a * ebx + p->f) - p->c * emdx;
+			lookup[i] = negative ? -inverse : inverse;
+
+			// reflected, the scale goes down as i goes up
+			ebx *= negative ? downB : upB;
+			emdx *= negative ? downD : upD;
+			++steps;
+		}
+	});
 }
 
 FastLogicle::FastLogicle (double T, double W, double M, double A, int bins)
@@ -48,75 +111,273 @@ FastLogicle::FastLogicle (double T, double W)
 	initialize(DEFAULT_BINS);
 }
 
+// a table mapped from a file, until the FastLogicle that uses it exists
+struct FastLogicle::MappedTable
+{
+	logicle_table table;
+	logicle_table_key key;
+
+	MappedTable (const char * path)
+	{
+		const char * error = logicle_table_map(&table, key, path);
+		if (error)
+			throw IllegalParameter(error);
+		if (key.transform != 'L')
+		{
+			logicle_table_destroy(&table);
+			throw IllegalParameter("not a logicle table file");
+		}
+	}
+
+	~MappedTable ()
+	{
+		logicle_table_destroy(&table);
+	}
+};
+
+FastLogicle::FastLogicle (const char * path)
+: FastLogicle(MappedTable(path))
+{	}
+
+// the saved A has already been adjusted to put zero on a bin boundary, so
+// use it as it is (bins = 0)
+FastLogicle::FastLogicle (const MappedTable & mapped)
+: Logicle(mapped.key.parameter[0], mapped.key.parameter[1],
+	mapped.key.parameter[2], mapped.key.parameter[3], 0)
+{
+	logicle_table_share(&p->table, &mapped.table);
+}
+
 FastLogicle::FastLogicle (const FastLogicle & logicle) : Logicle(logicle)
 {
-	p->bins = logicle.p->bins;
-	p->lookup = new double[p->bins + 1];
-	memcpy(p->lookup, logicle.p->lookup, (p->bins + 1) * sizeof (double));
+	// tables never change, so copies can share them
+	logicle_table_share(&p->table, &logicle.p->table);
 }
 
 FastLogicle::~FastLogicle ()
 {
-	delete p->lookup;
+	logicle_table_destroy(&p->table);
+}
+
+void FastLogicle::save (const char * path) const
+{
+	logicle_table_key key = { 'L', { p->T, p->W, p->M, p->A }, p->table.bins };
+	const char * error = logicle_table_save(&p->table, key, path);
+	if (error)
+		throw IllegalParameter(error);
+}
+
+const char * FastLogicle::tableFile () const
+{
+	return logicle_table_file(&p->table);
 }
 
 int FastLogicle::intScale (double value) const
 {
-    // binary search for the appropriate bin
-    int lo = 0;
-    int hi = p->bins;
-    while (lo <= hi)
-    {
-      int mid = (lo + hi) >> 1;
-      double key = p->lookup[mid];
-      if (value < key)
-        hi = mid - 1;
-      else if (value > key)
-        lo = mid + 1;
-      else if (mid < p->bins)
-        return mid;
-      else
-        // equal to table[bins] which is for interpolation only
+	int bin = logicle_table_bin(&p->table, value);
+	if (bin < 0)
 		throw IllegalArgument(value);
-	}
 
-    // check for out of range
-    if (hi < 0 || lo > p->bins)
-		throw IllegalArgument(value);
+	return bin;
+}
 
-    return lo - 1;
+void FastLogicle::intScale (const double * value, int * bin, size_t n) const
+{
+	logicle_parallel(n, [this, value, bin] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			bin[i] = value[i] == value[i] ? logicle_table_bin(&p->table, value[i]) : -1;
+	});
 }
 
 double FastLogicle::scale (double value) const
 {
-    // lookup the nearest value
-    int index = intScale(value);
-
-    // inverse interpolate the table linearly
-    double delta = (value - p->lookup[index])
-      / (p->lookup[index + 1] - p->lookup[index]);
+	// lookup the nearest value
+	int index = intScale(value);
 
-    return (index + delta) / (double)p->bins;
+	return logicle_table_scale(&p->table, index, value);
 }
 
 double FastLogicle::inverse (double scale) const
 {
-    // find the bin
-    double x = scale * p->bins;
-    int index = (int)floor(x);
-    if (index < 0 || index >= p->bins)
+	// find the bin
+	double x = logicle_table_position(&p->table, scale);
+	int index = (int)floor(x);
+	if (index < 0 || index >= p->table.bins)
 		throw IllegalArgument(scale);
 
-    // interpolate the table linearly
-    double delta = x - index;
+	return logicle_table_inverse(&p->table, index, x);
+}
 
-    return (1 - delta) * p->lookup[index] + delta * p->lookup[index + 1];
+void FastLogicle::scale (const double * value, double * scale, size_t n) const
+{
+	logicle_parallel(n, [this, value, scale] (size_t begin, size_t end) {
+		tableScale(&p->table, value + begin, scale + begin, end - begin);
+	});
+}
+
+double FastLogicle::clipMaximum () const
+{
+	// the top of the table is only there for interpolation
+	double top = FastLogicle::inverse(1 - EPSILON);
+	if (top >= p->table.lookup[p->table.bins])
+		top = nextafter(p->table.lookup[p->table.bins], p->table.lookup[0]);
+	return top;
+}
+
+double FastLogicle::clipScale (double value) const
+{
+	double lo = p->table.lookup[0];
+	double hi = clipMaximum();
+	return FastLogicle::scale(value < lo ? lo : value > hi ? hi : value);
+}
+
+void FastLogicle::clipScale (const double * value, double * scale, size_t n) const
+{
+	const double lo = p->table.lookup[0];
+	const double hi = clipMaximum();
+
+	logicle_parallel(n, [this, value, scale, lo, hi] (size_t begin, size_t end) {
+		// clip a block at a time into the output and scale it there,
+		// while it's still in the cache.  NaN is left alone.
+		const size_t BLOCK = 1024;
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			for (size_t j = i; j < i + m; ++j)
+			{
+				double x = value[j];
+				scale[j] = x < lo ? lo : x > hi ? hi : x;
+			}
+			tableScale(&p->table, scale + i, scale + i, m);
+		}
+	});
+}
+
+void FastLogicle::clipScale (const float * value, float * scale, size_t n) const
+{
+	inDouble(value, scale, n, [this] (double * block, size_t m) {
+		clipScale(block, block, m);
+	});
+}
+
+namespace
+{
+
+// transform a block at a time of value into result, after replacing the
+// values outside [lo, hi] with the end they're off (and NaN with lo), and
+// then put NaN back for those that were NaN and, if policy says so, for
+// the rest of them too.  returns how many were outside, and appends their
+// indices to outside.
+template <typename F>
+size_t transformOutside (const double * value, double * result, size_t n,
+	double lo, double hi, FastLogicle::Outside policy,
+	std::vector<size_t> * outside, const F & transform)
+{
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	size_t count = 0;
+	size_t first = outside ? outside->size() : 0;
+	std::mutex mutex;
+
+	logicle_parallel(n, [&] (size_t begin, size_t end) {
+		const size_t BLOCK = 1024;
+		size_t bad[BLOCK];
+		bool nan[BLOCK];
+		size_t chunkCount = 0;
+		std::vector<size_t> chunkOutside;
+
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			size_t k = 0;
+			for (size_t j = i; j < i + m; ++j)
+			{
+				double x = value[j];
+				if (x >= lo && x <= hi)
+					result[j] = x;
+				else
+				{
+					nan[k] = x != x;
+					bad[k++] = j;
+					result[j] = x > hi ? hi : lo;
+				}
+			}
+
+			transform(result + i, m);
+
+			for (size_t b = 0; b < k; ++b)
+			{
+				size_t j = bad[b];
+				if (nan[b])
+				{
+					result[j] = NaN;
+					continue;
+				}
+				++chunkCount;
+				if (policy == FastLogicle::NAN_OUTSIDE)
+					result[j] = NaN;
+				if (outside)
+					chunkOutside.push_back(j);
+			}
+		}
+
+		if (chunkCount)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			count += chunkCount;
+			if (outside)
+				outside->insert(outside->end(), chunkOutside.begin(), chunkOutside.end());
+		}
+	});
+
+	// the chunks finish in any order
+	if (outside)
+		std::sort(outside->begin() + first, outside->end());
+	return count;
+}
+
+}
+
+size_t FastLogicle::scale (const double * value, double * scale, size_t n,
+	Outside policy, std::vector<size_t> * outside) const
+{
+	// the same range as clipScale, so CLIP_OUTSIDE gives the same answers
+	return transformOutside(value, scale, n, p->table.lookup[0], clipMaximum(),
+		policy, outside, [this] (double * block, size_t m) {
+			this->scale(block, block, m);
+		});
+}
+
+size_t FastLogicle::inverse (const double * scale, double * value, size_t n,
+	Outside policy, std::vector<size_t> * outside) const
+{
+	// the largest scale whose position is still in the last bin
+	double lo = p->table.offset;
+	double hi = p->table.offset + p->table.width;
+	while (logicle_table_position(&p->table, hi) >= p->table.bins)
+		hi = nextafter(hi, lo);
+
+	return transformOutside(scale, value, n, lo, hi,
+		policy, outside, [this] (double * block, size_t m) {
+			this->inverse(block, block, m);
+		});
+}
+
+void FastLogicle::inverse (const double * scale, double * value, size_t n) const
+{
+	logicle_parallel(n, [this, scale, value] (size_t begin, size_t end) {
+		tableInverse(&p->table, scale + begin, value + begin, end - begin);
+	});
 }
 
 double FastLogicle::inverse (int index) const
 {
-    if (index < 0 || index >= p->bins)
+	if (index < 0 || index >= p->table.bins)
 		throw IllegalArgument(index);
 
-    return p->lookup[index];
+	return p->table.lookup[index];
+}
+
+void FastLogicle::exactInverse (const double * scale, double * value, size_t n) const
+{
+	Logicle::inverse(scale, value, n);
 }
@@ -0,0 +1,163 @@
+#include "fcs.h"
+#include "mapping.h"
+#include "threads.h"
+#include <memory.h>
+#include <cmath>
+
+FcsData::FcsData (const char * path, size_t begin, size_t end, char datatype,
+	bool bigEndian, size_t events, const std::vector<int> & bits,
+	const std::vector<double> & range)
+	: mapping(0), length(0), data(0), count(events), stride(0),
+	datatype(datatype), bigEndian(bigEndian)
+{
+	if (datatype != 'I' && datatype != 'F' && datatype != 'D')
+		throw Logicle::IllegalParameter("unsupported $DATATYPE");
+	if (bits.empty())
+		throw Logicle::IllegalParameter("no parameters");
+	if (!range.empty() && range.size() != bits.size())
+		throw Logicle::IllegalParameter("range is the wrong length");
+
+	for (size_t i = 0; i < bits.size(); ++i)
+	{
+		if (datatype == 'F' && bits[i] != 32)
+			throw Logicle::IllegalParameter("$PnB must be 32 for $DATATYPE F");
+		if (datatype == 'D' && bits[i] != 64)
+			throw Logicle::IllegalParameter("$PnB must be 64 for $DATATYPE D");
+		if (bits[i] <= 0 || bits[i] > 64 || bits[i] % 8)
+			throw Logicle::IllegalParameter("unsupported $PnB");
+
+		width.push_back(bits[i] / 8);
+		offset.push_back(stride);
+		stride += bits[i] / 8;
+
+		// as many bits as the range needs, computed the same way as
+		// ImportOp (which uses Python's math.log(range, 2)), and at
+		// least one
+		unsigned long long m = ~0ULL;
+		if (datatype == 'I' && !range.empty())
+		{
+			// the conversion below is undefined for these
+			if (!(range[i] > 0) || !std::isfinite(range[i]))
+				throw Logicle::IllegalParameter("$PnR is not a positive number");
+			int used = (int) (log(range[i]) / log(2.));
+			if (used < 1)
+				used = 1;
+			if (used < bits[i])
+				m = (1ULL << used) - 1;
+		}
+		mask.push_back(m);
+	}
+
+	if (end < begin || (end - begin + 1) / stride < events)
+		throw Logicle::IllegalParameter("the DATA segment is too short for $TOT events");
+
+	const char * error = 0;
+	mapping = logicle_map(path, length, error);
+	if (!mapping)
+		throw Logicle::IllegalParameter(error);
+	// some instruments put the end of the DATA segment one past the end of
+	// the file, so only check the part of it that has events in it
+	if (begin > length || (length - begin) / stride < events)
+	{
+		logicle_unmap(mapping, length);
+		throw Logicle::IllegalParameter("the DATA segment is past the end of the file");
+	}
+	data = (const unsigned char *) mapping + begin;
+}
+
+FcsData::~FcsData ()
+{
+	logicle_unmap(mapping, length);
+}
+
+void FcsData::check (int parameter) const
+{
+	if (parameter < 0 || parameter >= parameters())
+		throw Logicle::IllegalArgument(parameter);
+}
+
+template <typename T>
+void FcsData::decodeRange (int parameter, size_t begin, size_t end, T * out) const
+{
+	const unsigned char * value = data + begin * stride + offset[parameter];
+	const int bytes = width[parameter];
+
+	// the value's bytes, most significant first
+	unsigned char b[8];
+	for (size_t i = begin; i < end; ++i, value += stride)
+	{
+		for (int k = 0; k < bytes; ++k)
+			b[k] = bigEndian ? value[k] : value[bytes - 1 - k];
+
+		if (datatype == 'I')
+		{
+			unsigned long long x = 0;
+			for (int k = 0; k < bytes; ++k)
+				x = x << 8 | b[k];
+			out[i] = (T) (x & mask[parameter]);
+		}
+		else if (datatype == 'F')
+		{
+			unsigned int x = (unsigned) b[0] << 24 | (unsigned) b[1] << 16
+				| (unsigned) b[2] << 8 | b[3];
+			float f;
+			memcpy(&f, &x, sizeof(float));
+			out[i] = (T) f;
+		}
+		else
+		{
+			unsigned long long x = 0;
+			for (int k = 0; k < 8; ++k)
+				x = x << 8 | b[k];
+			double d;
+			memcpy(&d, &x, sizeof(double));
+			out[i] = (T) d;
+		}
+	}
+}
+
+void FcsData::decode (int parameter, double * out) const
+{
+	check(parameter);
+	logicle_parallel(count, [this, parameter, out] (size_t begin, size_t end) {
+		decodeRange(parameter, begin, end, out);
+	});
+}
+
+void FcsData::decode (int parameter, float * out) const
+{
+	check(parameter);
+	logicle_parallel(count, [this, parameter, out] (size_t begin, size_t end) {
+		decodeRange(parameter, begin, end, out);
+	});
+}
+
+void FcsData::decodeScale (int parameter, const Transform & transform, double * out) const
+{
+	check(parameter);
+	logicle_parallel(count, [this, parameter, &transform, out] (size_t begin, size_t end) {
+		// the batch transforms run serially here, since we're already in
+		// parallel
+		const size_t BLOCK = 1024;
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			decodeRange(parameter, i, i + m, out);
+			transform.scale(out + i, out + i, m);
+		}
+	});
+}
+
+void FcsData::decodeClipScale (int parameter, const FastLogicle & logicle, double * out) const
+{
+	check(parameter);
+	logicle_parallel(count, [this, parameter, &logicle, out] (size_t begin, size_t end) {
+		const size_t BLOCK = 1024;
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			decodeRange(parameter, i, i + m, out);
+			logicle.clipScale(out + i, out + i, m);
+		}
+	});
+}
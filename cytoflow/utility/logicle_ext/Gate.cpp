@@ -0,0 +1,150 @@
+#include "gate.h"
+#include "threads.h"
+#include <cmath>
+
+static const size_t BLOCK = 1024;
+
+GateAxis::GateAxis ()
+	: kind(LINEAR), transform(0), threshold(0), mask(false)
+{	}
+
+GateAxis::GateAxis (const Transform & transform)
+	: kind(TRANSFORM), transform(&transform), threshold(0), mask(false)
+{	}
+
+GateAxis GateAxis::clipped (const FastLogicle & logicle)
+{
+	GateAxis axis(logicle);
+	axis.kind = CLIPPED;
+	return axis;
+}
+
+GateAxis GateAxis::log (double threshold, bool mask)
+{
+	if (!(threshold > 0))
+		throw Logicle::IllegalParameter("threshold is not positive");
+
+	GateAxis axis;
+	axis.kind = LOG;
+	axis.threshold = threshold;
+	axis.mask = mask;
+	return axis;
+}
+
+void GateAxis::scale (double * value, size_t n) const
+{
+	switch (kind)
+	{
+	case LINEAR:
+		break;
+
+	case TRANSFORM:
+		transform->scale(value, value, n);
+		break;
+
+	case CLIPPED:
+		static_cast<const FastLogicle *>(transform)->clipScale(value, value, n);
+		break;
+
+	case LOG:
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (value[i] < threshold)
+				value[i] = mask ? NAN : threshold;
+			value[i] = log10(value[i]);
+		}
+		break;
+	}
+}
+
+PolygonGate::PolygonGate (const GateAxis & x, const GateAxis & y,
+	const std::vector<double> & xvertex, const std::vector<double> & yvertex)
+	: x(x), y(y), vx(xvertex), vy(yvertex)
+{
+	if (vx.size() != vy.size())
+		throw Logicle::IllegalParameter("the vertices' coordinates are different sizes");
+	if (vx.size() < 3)
+		throw Logicle::IllegalParameter("a polygon needs at least 3 vertices");
+}
+
+bool PolygonGate::inside (double px, double py) const
+{
+	if (px != px || py != py)
+		return false;
+
+	// count the edges a ray to the right of the point crosses, comparing
+	// against the edge's end rather than dividing (as matplotlib does)
+	const size_t n = vx.size();
+	double x0 = vx[n - 1], y0 = vy[n - 1];
+	bool above0 = y0 >= py;
+	bool in = false;
+	for (size_t i = 0; i < n; ++i)
+	{
+		double x1 = vx[i], y1 = vy[i];
+		bool above1 = y1 >= py;
+		if (above0 != above1
+			&& (((y1 - py) * (x0 - x1) >= (x1 - px) * (y0 - y1)) == above1))
+			in = !in;
+		x0 = x1;
+		y0 = y1;
+		above0 = above1;
+	}
+	return in;
+}
+
+void PolygonGate::contains (const double * xvalue, const double * yvalue, size_t n,
+	unsigned char * in) const
+{
+	logicle_parallel(n, [this, xvalue, yvalue, in] (size_t begin, size_t end) {
+		double xblock[BLOCK], yblock[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			size_t m = end - i < BLOCK ? end - i : BLOCK;
+			for (size_t j = 0; j < m; ++j)
+			{
+				xblock[j] = xvalue[i + j];
+				yblock[j] = yvalue[i + j];
+			}
+			x.scale(xblock, m);
+			y.scale(yblock, m);
+			for (size_t j = 0; j < m; ++j)
+				in[i + j] = inside(xblock[j], yblock[j]);
+		}
+	});
+}
+
+void logicle_gate_range (const double * value, size_t n, double lo, double hi,
+	unsigned char * in)
+{
+	logicle_parallel(n, [value, lo, hi, in] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			in[i] = value[i] >= lo && value[i] <= hi;
+	});
+}
+
+void logicle_gate_range2d (const double * xvalue, const double * yvalue, size_t n,
+	double xlo, double xhi, double ylo, double yhi, unsigned char * in)
+{
+	logicle_parallel(n, [=] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			in[i] = xvalue[i] >= xlo && xvalue[i] <= xhi
+				&& yvalue[i] >= ylo && yvalue[i] <= yhi;
+	});
+}
+
+void logicle_gate_quad (const double * xvalue, const double * yvalue, size_t n,
+	double xthreshold, double ythreshold, unsigned char * quadrant)
+{
+	logicle_parallel(n, [=] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			double x = xvalue[i], y = yvalue[i];
+			unsigned char q = 0;
+			if (x < xthreshold)
+				q = y > ythreshold ? 1 : y < ythreshold ? 3 : 0;
+			else if (x > xthreshold)
+				q = y > ythreshold ? 2 : y < ythreshold ? 4 : 0;
+			quadrant[i] = q;
+		}
+	});
+}
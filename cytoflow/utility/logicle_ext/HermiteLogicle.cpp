@@ -0,0 +1,149 @@
+#include "logicle.h"
+#include "threads.h"
+#include <cmath>
+
+void HermiteLogicle::initialize ()
+{
+	// the slopes are the derivative of Logicle::inverse at the same points
+	// as the table, times the width of a bin.  they're shared (and
+	// cached) the same way the table is.
+	logicle_table_key key = { 'l', { p->T, p->W, p->M, p->A }, p->table.bins };
+	logicle_table_cached(&slopes, key, p->table.offset, p->table.width, [this] (logicle_table * table) {
+		const int bins = table->bins;
+		const double offset = table->offset, width = table->width;
+		double * lookup = table->lookup;
+		logicle_parallel(bins + 1, [this, bins, offset, width, lookup] (size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				lookup[i] = slope((double) i / bins * width + offset) * (width / bins);
+		});
+	}, false);
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W, double M, double A, int bins)
+	: FastLogicle(T, W, M, A, bins)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W, double M, int bins)
+	: FastLogicle(T, W, M, bins)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W, int bins)
+	: FastLogicle(T, W, bins)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W, double M, double A)
+	: FastLogicle(T, W, M, A)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W, double M)
+	: FastLogicle(T, W, M)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (double T, double W)
+	: FastLogicle(T, W)
+{
+	initialize();
+}
+
+HermiteLogicle::HermiteLogicle (const HermiteLogicle & logicle) : FastLogicle(logicle)
+{
+	logicle_table_share(&slopes, &logicle.slopes);
+}
+
+HermiteLogicle::~HermiteLogicle ()
+{
+	logicle_table_destroy(&slopes);
+}
+
+double HermiteLogicle::hermiteScale (int bin, double value) const
+{
+	// the cubic in the fraction t of the way across the bin in data space
+	// that goes from 0 to 1 with the transform's slopes at either end
+	const double * lookup = p->table.lookup;
+	double dx = lookup[bin + 1] - lookup[bin];
+	double t = (value - lookup[bin]) / dx;
+	double m0 = dx / slopes.lookup[bin];
+	double m1 = dx / slopes.lookup[bin + 1];
+	double delta = t * (m0 + t * ((3 - 2 * m0 - m1) + t * (m0 + m1 - 2)));
+
+	return (bin + delta) / (double) p->table.bins * p->table.width + p->table.offset;
+}
+
+double HermiteLogicle::hermiteInverse (int bin, double position) const
+{
+	// the same, the other way around:  the cubic in the position in the
+	// bin that matches the table values and the slopes at either end
+	const double * lookup = p->table.lookup;
+	double t = position - bin;
+	double x0 = lookup[bin], x1 = lookup[bin + 1];
+	double m0 = slopes.lookup[bin], m1 = slopes.lookup[bin + 1];
+	double dx = x1 - x0;
+
+	return x0 + t * (m0 + t * ((3 * dx - 2 * m0 - m1) + t * (m0 + m1 - 2 * dx)));
+}
+
+double HermiteLogicle::scale (double value) const
+{
+	return hermiteScale(intScale(value), value);
+}
+
+double HermiteLogicle::inverse (double scale) const
+{
+	double x = logicle_table_position(&p->table, scale);
+	int index = (int) floor(x);
+	if (index < 0 || index >= p->table.bins)
+		throw IllegalArgument(scale);
+
+	return hermiteInverse(index, x);
+}
+
+// there aren't any kernels for the cubics, so the batches are the scalar
+// transforms on the thread pool
+
+void HermiteLogicle::scale (const double * value, double * scale, size_t n) const
+{
+	logicle_parallel(n, [this, value, scale] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			scale[i] = HermiteLogicle::scale(value[i]);
+	});
+}
+
+void HermiteLogicle::inverse (const double * scale, double * value, size_t n) const
+{
+	logicle_parallel(n, [this, scale, value] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			value[i] = HermiteLogicle::inverse(scale[i]);
+	});
+}
+
+double HermiteLogicle::clipScale (double value) const
+{
+	double lo = p->table.lookup[0];
+	double hi = clipMaximum();
+	return HermiteLogicle::scale(value < lo ? lo : value > hi ? hi : value);
+}
+
+void HermiteLogicle::clipScale (const double * value, double * scale, size_t n) const
+{
+	const double lo = p->table.lookup[0];
+	const double hi = clipMaximum();
+
+	logicle_parallel(n, [this, value, scale, lo, hi] (size_t begin, size_t end) {
+		// NaN is left alone
+		for (size_t i = begin; i < end; ++i)
+		{
+			double x = value[i];
+			scale[i] = HermiteLogicle::scale(x < lo ? lo : x > hi ? hi : x);
+		}
+	});
+}
@@ -0,0 +1,80 @@
+#include "histogram.h"
+#include "threads.h"
+#include <mutex>
+#include <vector>
+
+const size_t Histogram::BLOCK = 1024;
+
+Histogram::Histogram (const Transform & transform, double lo, double hi, int bins)
+	: transform(transform)
+{
+	if (bins <= 0)
+		throw Logicle::IllegalParameter("bins is not positive");
+	if (!(lo < hi))
+		throw Logicle::IllegalParameter("lo is not less than hi");
+
+	this->lo = lo;
+	perBin = bins / (hi - lo);
+	bottom = transform.inverse(lo);
+	top = transform.inverse(hi);
+	n = bins;
+}
+
+void Histogram::count (const double * value, size_t m, double * counts) const
+{
+	std::mutex mutex;
+	logicle_parallel(m, [this, value, counts, &mutex] (size_t begin, size_t end) {
+		std::vector<double> local(n, 0.);
+		double block[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			// gather the values that are counted, and scale them together
+			size_t last = end - i < BLOCK ? end : i + BLOCK;
+			size_t k = 0;
+			for (size_t j = i; j < last; ++j)
+				if (inside(value[j]))
+					block[k++] = value[j];
+
+			transform.scale(block, block, k);
+			for (size_t j = 0; j < k; ++j)
+				local[bin(block[j])] += 1;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int b = 0; b < n; ++b)
+			counts[b] += local[b];
+	});
+}
+
+void Histogram::count (const Histogram & x, const Histogram & y,
+	const double * xvalue, const double * yvalue, size_t m, double * counts)
+{
+	const size_t cells = (size_t) x.n * (size_t) y.n;
+
+	std::mutex mutex;
+	logicle_parallel(m, [&x, &y, xvalue, yvalue, counts, cells, &mutex] (size_t begin, size_t end) {
+		std::vector<double> local(cells, 0.);
+		double xblock[BLOCK], yblock[BLOCK];
+		for (size_t i = begin; i < end; i += BLOCK)
+		{
+			// a pair is counted if both of its values are
+			size_t last = end - i < BLOCK ? end : i + BLOCK;
+			size_t k = 0;
+			for (size_t j = i; j < last; ++j)
+				if (x.inside(xvalue[j]) && y.inside(yvalue[j]))
+				{
+					xblock[k] = xvalue[j];
+					yblock[k++] = yvalue[j];
+				}
+
+			x.transform.scale(xblock, xblock, k);
+			y.transform.scale(yblock, yblock, k);
+			for (size_t j = 0; j < k; ++j)
+				local[(size_t) x.bin(xblock[j]) * y.n + y.bin(yblock[j])] += 1;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t c = 0; c < cells; ++c)
+			counts[c] += local[c];
+	});
+}
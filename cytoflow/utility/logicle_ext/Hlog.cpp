@@ -0,0 +1,97 @@
+#include "hlog.h"
+#include <cmath>
+#include <limits>
+
+static const double LN_10 = log(10.);
+static const double EPSILON = std::numeric_limits<double>::epsilon();
+
+Hlog::Hlog (double b, double r, double d)
+{
+	if (b < 0)
+		throw Logicle::IllegalParameter("b is negative");
+	if (r <= 0)
+		throw Logicle::IllegalParameter("r is not positive");
+	if (d <= 0)
+		throw Logicle::IllegalParameter("d is not positive");
+
+	p = new hlog_params;
+	p->b = b;
+	p->r = r;
+	p->d = d;
+	p->c = d / r * LN_10;
+	p->beta = b * d / r;
+
+	logicle_table_init(&p->table);
+}
+
+Hlog::Hlog (const Hlog & hlog)
+{
+	p = new hlog_params;
+	*p = *hlog.p;
+	logicle_table_init(&p->table);
+}
+
+Hlog::~Hlog ()
+{
+	delete p;
+}
+
+double Hlog::scale (double value) const
+{
+	// handle true zero (and NaN) separately
+	if (value == 0 || value != value)
+		return value;
+
+	// reflect negative values
+	bool negative = value < 0;
+	if (negative)
+		value = -value;
+
+	if (value > std::numeric_limits<double>::max())
+		return negative ? -value : value;
+
+	// solve expm1(c y) + beta y = value.  the left side is convex, and
+	// each term alone gives an upper bound on y, so start at the smaller
+	// bound and work down
+	double y = log1p(value) / p->c;
+	if (value / (p->c + p->beta) < y)
+		y = value / (p->c + p->beta);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		// compute the function and its first two derivatives
+		double ecy = exp(p->c * y);
+		double f = (expm1(p->c * y) - value) + p->beta * y;
+		double df = p->c * ecy + p->beta;
+		double ddf = p->c * p->c * ecy;
+
+		// this is Halley's method with cubic convergence, arranged so
+		// that nothing overflows for large values
+		double newton = f / df;
+		double delta = newton / (1 - newton * ddf / (2 * df));
+		y -= delta;
+
+		// if we've reached the desired precision we're done
+		if (std::abs(delta) <= 3 * y * EPSILON)
+			return negative ? -y : y;
+	}
+
+	throw Logicle::DidNotConverge("Hlog::scale() didn't converge");
+}
+
+double Hlog::inverse (double scale) const
+{
+	double y = std::abs(scale);
+	double value = expm1(p->c * y) + p->beta * y;
+	return scale < 0 ? -value : value;
+}
+
+void Hlog::scale (const double * value, double * scale, size_t n) const
+{
+	Transform::scale(value, scale, n);
+}
+
+void Hlog::inverse (const double * scale, double * value, size_t n) const
+{
+	Transform::inverse(scale, value, n);
+}
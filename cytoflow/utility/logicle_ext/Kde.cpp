@@ -0,0 +1,344 @@
+#include "kde.h"
+#include "threads.h"
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+const int KernelDensity::DEFAULT_BINS = 1 << 10;
+
+// binning moves a value by at most half a step, ie. 1/16 of the bandwidth
+const int KernelDensity::STEPS_PER_BANDWIDTH = 8;
+
+// a 1d grid is summed once per point; a 2d one is a copy per thread
+const int KernelDensity::MAX_BINS = 1 << 16;
+const int KernelDensity::MAX_BINS_2D = 1 << 10;
+
+static const double PI = 3.14159265358979323846;
+
+KernelDensity::KernelDensity (Kernel kernel, double bandwidth, int bins)
+	: kernel(kernel), h(bandwidth), bins(bins)
+{
+	if (!(bandwidth > 0) || bandwidth > std::numeric_limits<double>::max())
+		throw Logicle::IllegalParameter("bandwidth is not positive");
+	if (bins <= 0)
+		throw Logicle::IllegalParameter("bins is not positive");
+	if (kernel < GAUSSIAN || kernel > COSINE)
+		throw Logicle::IllegalParameter("unknown kernel");
+}
+
+double KernelDensity::weight (double d) const
+{
+	double u = std::abs(d) / h;
+	switch (kernel)
+	{
+	case GAUSSIAN:
+		return exp(-0.5 * u * u) / (h * sqrt(2 * PI));
+	case TOPHAT:
+		return u < 1 ? 0.5 / h : 0;
+	case EPANECHNIKOV:
+		return u < 1 ? 0.75 * (1 - u * u) / h : 0;
+	case EXPONENTIAL:
+		return exp(-u) / (2 * h);
+	case LINEAR:
+		return u < 1 ? (1 - u) / h : 0;
+	case COSINE:
+		return u < 1 ? 0.25 * PI * cos(0.5 * PI * u) / h : 0;
+	}
+	return 0;
+}
+
+void KernelDensity::range (const double * value, size_t n, double & lo, double & hi)
+{
+	lo = std::numeric_limits<double>::infinity();
+	hi = -lo;
+
+	std::mutex mutex;
+	logicle_parallel(n, [value, &lo, &hi, &mutex] (size_t begin, size_t end) {
+		double a = std::numeric_limits<double>::infinity(), b = -a;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (!std::isfinite(value[i]))
+				continue;
+			if (value[i] < a)
+				a = value[i];
+			if (value[i] > b)
+				b = value[i];
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (a < lo)
+			lo = a;
+		if (b > hi)
+			hi = b;
+	});
+}
+
+int KernelDensity::intervals (double lo, double hi, int most) const
+{
+	double needed = ceil((hi - lo) / h * STEPS_PER_BANDWIDTH);
+	if (needed <= bins)
+		return bins;
+	// (and infinity, if hi - lo overflows)
+	if (!(needed <= most))
+		return 0;
+	return (int) needed;
+}
+
+// where a value falls on a grid of bins intervals from lo, by step: the
+// grid point below it and how far it is towards the next one
+static inline size_t grid_position (double value, double lo, double step, int bins,
+	double & t)
+{
+	double x = step > 0 ? (value - lo) / step : 0;
+	size_t i = (size_t) x;
+	if (i >= (size_t) bins)
+	{
+		// the largest value, or rounding just below it
+		t = 0;
+		return bins;
+	}
+	t = x - i;
+	return i;
+}
+
+void KernelDensity::weights (const double * point, size_t m, double lo, double step,
+	size_t points, std::vector<double> & out) const
+{
+	out.resize(m * points);
+	logicle_parallel(m, [this, point, lo, step, points, &out] (size_t begin, size_t end) {
+		for (size_t j = begin; j < end; ++j)
+			for (size_t i = 0; i < points; ++i)
+				out[j * points + i] = weight(point[j] - (lo + i * step));
+	}, points);
+}
+
+void KernelDensity::directDensity (const double * value, size_t n, const double * point,
+	size_t m, double * out) const
+{
+	logicle_parallel(m, [this, value, n, point, out] (size_t begin, size_t end) {
+		for (size_t j = begin; j < end; ++j)
+		{
+			double sum = 0, count = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (!std::isfinite(value[i]))
+					continue;
+				sum += weight(point[j] - value[i]);
+				++count;
+			}
+			out[j] = sum / count;
+		}
+	}, n);
+}
+
+void KernelDensity::density (const double * value, size_t n, const double * point,
+	size_t m, double * out) const
+{
+	double lo, hi;
+	range(value, n, lo, hi);
+	if (!(lo <= hi))
+	{
+		// nothing to estimate from
+		for (size_t j = 0; j < m; ++j)
+			out[j] = 0;
+		return;
+	}
+
+	const int intervals = this->intervals(lo, hi, MAX_BINS);
+	if (!intervals)
+	{
+		directDensity(value, n, point, m, out);
+		return;
+	}
+
+	// bin the values, each chunk into its own grid
+	const size_t points = intervals + 1;
+	const double step = (hi - lo) / intervals;
+	std::vector<double> grid(points, 0.);
+	double count = 0;
+	std::mutex mutex;
+	logicle_parallel(n, [value, lo, step, points, intervals, &grid, &count, &mutex]
+		(size_t begin, size_t end) {
+		std::vector<double> local(points, 0.);
+		double counted = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (!std::isfinite(value[i]))
+				continue;
+			double t;
+			size_t k = grid_position(value[i], lo, step, intervals, t);
+			local[k] += 1 - t;
+			if (t > 0)
+				local[k + 1] += t;
+			++counted;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t k = 0; k < points; ++k)
+			grid[k] += local[k];
+		count += counted;
+	});
+
+	// sum the grid against each point's kernel.  the compact kernels are
+	// zero more than h away, so only the grid points within h count.
+	const bool compact = kernel != GAUSSIAN && kernel != EXPONENTIAL;
+	logicle_parallel(m, [this, point, out, lo, step, points, compact, count, &grid]
+		(size_t begin, size_t end) {
+		for (size_t j = begin; j < end; ++j)
+		{
+			size_t first = 0, last = points;
+			if (compact)
+			{
+				double a = (point[j] - h - lo) / step, b = (point[j] + h - lo) / step;
+				first = !(a > 0) ? 0 : a >= points ? points : (size_t) a;
+				last = !(b < points - 1) ? points : b < 0 ? 0 : (size_t) b + 2;
+			}
+
+			double sum = 0;
+			for (size_t k = first; k < last; ++k)
+				sum += grid[k] * weight(point[j] - (lo + k * step));
+			out[j] = sum / count;
+		}
+	}, compact ? 2 * STEPS_PER_BANDWIDTH : points);
+}
+
+void KernelDensity::directDensity2d (const double * xvalue, const double * yvalue, size_t n,
+	const double * xpoint, size_t mx, const double * ypoint, size_t my,
+	double * out) const
+{
+	// the kernel is the product of one for x and one for y, so each pair
+	// adds the outer product of its kernels to every point
+	for (size_t k = 0; k < mx * my; ++k)
+		out[k] = 0;
+	double count = 0;
+	std::mutex mutex;
+	logicle_parallel(n, [&] (size_t begin, size_t end) {
+		std::vector<double> local(mx * my, 0.), xw(mx), yw(my);
+		double counted = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			double x = xvalue[i], y = yvalue[i];
+			if (!std::isfinite(x) || !std::isfinite(y))
+				continue;
+			for (size_t j = 0; j < mx; ++j)
+				xw[j] = weight(xpoint[j] - x);
+			for (size_t k = 0; k < my; ++k)
+			{
+				const double w = weight(ypoint[k] - y);
+				double * row = &local[k * mx];
+				for (size_t j = 0; j < mx; ++j)
+					row[j] += w * xw[j];
+			}
+			++counted;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t k = 0; k < mx * my; ++k)
+			out[k] += local[k];
+		count += counted;
+	}, mx * my);
+
+	for (size_t k = 0; k < mx * my; ++k)
+		out[k] /= count;
+}
+
+void KernelDensity::density2d (const double * xvalue, const double * yvalue, size_t n,
+	const double * xpoint, size_t mx, const double * ypoint, size_t my,
+	double * out) const
+{
+	if (kernel != GAUSSIAN)
+		throw Logicle::IllegalParameter("2d estimates need the gaussian kernel");
+
+	double xlo, xhi, ylo, yhi;
+	range(xvalue, n, xlo, xhi);
+	range(yvalue, n, ylo, yhi);
+	if (!(xlo <= xhi) || !(ylo <= yhi))
+	{
+		for (size_t j = 0; j < mx * my; ++j)
+			out[j] = 0;
+		return;
+	}
+
+	const int xintervals = intervals(xlo, xhi, MAX_BINS_2D);
+	const int yintervals = intervals(ylo, yhi, MAX_BINS_2D);
+	if (!xintervals || !yintervals)
+	{
+		directDensity2d(xvalue, yvalue, n, xpoint, mx, ypoint, my, out);
+		return;
+	}
+
+	// bin the pairs, a row of y grid points for each x grid point
+	const size_t xpoints = xintervals + 1, ypoints = yintervals + 1;
+	const double xstep = (xhi - xlo) / xintervals, ystep = (yhi - ylo) / yintervals;
+	std::vector<double> grid(xpoints * ypoints, 0.);
+	double count = 0;
+	std::mutex mutex;
+	logicle_parallel(n, [=, &grid, &count, &mutex] (size_t begin, size_t end) {
+		std::vector<double> local(xpoints * ypoints, 0.);
+		double counted = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			double x = xvalue[i], y = yvalue[i];
+			if (!std::isfinite(x) || !std::isfinite(y))
+				continue;
+			double s, t;
+			size_t a = grid_position(x, xlo, xstep, xintervals, s);
+			size_t b = grid_position(y, ylo, ystep, yintervals, t);
+			double * row = &local[a * ypoints + b];
+			row[0] += (1 - s) * (1 - t);
+			if (t > 0)
+				row[1] += (1 - s) * t;
+			if (s > 0)
+			{
+				row[ypoints] += s * (1 - t);
+				if (t > 0)
+					row[ypoints + 1] += s * t;
+			}
+			++counted;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t k = 0; k < xpoints * ypoints; ++k)
+			grid[k] += local[k];
+		count += counted;
+	});
+
+	// the kernel is the product of one for x and one for y, so sum the
+	// grid's rows against the x point's kernel first, and then the result
+	// against the y point's
+	std::vector<double> xw, yw;
+	weights(xpoint, mx, xlo, xstep, xpoints, xw);
+	weights(ypoint, my, ylo, ystep, ypoints, yw);
+
+	std::vector<double> partial(mx * ypoints);
+	logicle_parallel(mx, [&] (size_t begin, size_t end) {
+		for (size_t j = begin; j < end; ++j)
+		{
+			double * to = &partial[j * ypoints];
+			for (size_t b = 0; b < ypoints; ++b)
+				to[b] = 0;
+			for (size_t a = 0; a < xpoints; ++a)
+			{
+				const double w = xw[j * xpoints + a];
+				const double * row = &grid[a * ypoints];
+				for (size_t b = 0; b < ypoints; ++b)
+					to[b] += w * row[b];
+			}
+		}
+	}, xpoints * ypoints);
+
+	logicle_parallel(my, [&] (size_t begin, size_t end) {
+		for (size_t k = begin; k < end; ++k)
+		{
+			const double * w = &yw[k * ypoints];
+			for (size_t j = 0; j < mx; ++j)
+			{
+				const double * from = &partial[j * ypoints];
+				double sum = 0;
+				for (size_t b = 0; b < ypoints; ++b)
+					sum += w[b] * from[b];
+				out[k * mx + j] = sum / count;
+			}
+		}
+	}, mx * ypoints);
+}
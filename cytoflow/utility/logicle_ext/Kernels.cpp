@@ -0,0 +1,127 @@
+#include "logicle.h"
+#include "kernels.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+
+// the portable vector code, for SSE2 on x86-64 and NEON on ARM
+namespace vector
+{
+#define LOGICLE_WIDTH 2
+#include "kernels.inc"
+#undef LOGICLE_WIDTH
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LOGICLE_X86
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__ ((target ("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("avx2,fma")
+#endif
+namespace avx2
+{
+#define LOGICLE_WIDTH 4
+#define LOGICLE_GATHER(x, index) _mm256_i64gather_pd(x, (__m256i) index, 8)
+#define LOGICLE_GATHER_INT(x, index) _mm256_cvtepi32_epi64(_mm256_i64gather_epi32(x, (__m256i) index, 4))
+#include "kernels.inc"
+#undef LOGICLE_GATHER_INT
+#undef LOGICLE_GATHER
+#undef LOGICLE_WIDTH
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__ ((target ("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("avx512f")
+#endif
+namespace avx512
+{
+#define LOGICLE_WIDTH 8
+// (the masked gathers keep GCC from warning about the unmasked ones)
+#define LOGICLE_GATHER(x, index) \
+	_mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, (__m512i) index, x, 8)
+#define LOGICLE_GATHER_INT(x, index) \
+	_mm512_maskz_cvtepi32_epi64(0xff, _mm512_mask_i64gather_epi32(_mm256_setzero_si256(), 0xff, (__m512i) index, x, 4))
+#include "kernels.inc"
+#undef LOGICLE_GATHER_INT
+#undef LOGICLE_GATHER
+#undef LOGICLE_WIDTH
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // x86
+#endif // __GNUC__
+
+static const logicle_kernels kernels[] =
+{
+#if defined(LOGICLE_X86)
+	{ "avx512", avx512::inverse, avx512::fastScale, avx512::fastInverse },
+	{ "avx2", avx2::inverse, avx2::fastScale, avx2::fastInverse },
+	// two doubles at a time isn't enough to pay for the polynomial exp()
+	{ "sse2", NULL, vector::fastScale, vector::fastInverse },
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__ARM_NEON))
+	{ "neon", vector::inverse, vector::fastScale, vector::fastInverse },
+#endif
+	{ "scalar", NULL, NULL, NULL }
+};
+
+static const int KERNELS = sizeof(kernels) / sizeof(kernels[0]);
+
+static bool supported (const logicle_kernels & k)
+{
+#if defined(LOGICLE_X86)
+	if (strcmp(k.name, "avx512") == 0)
+		return __builtin_cpu_supports("avx512f");
+	if (strcmp(k.name, "avx2") == 0)
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+	return true;
+}
+
+// the first (ie, widest) kernels the CPU supports
+static const logicle_kernels * detect ()
+{
+#if defined(LOGICLE_X86)
+	// we may be running before libgcc's constructors
+	__builtin_cpu_init();
+#endif
+	for (int i = 0; i < KERNELS; ++i)
+		if (supported(kernels[i]))
+			return &kernels[i];
+	return &kernels[KERNELS - 1];
+}
+
+static const logicle_kernels * active = detect();
+
+const logicle_kernels & logicle_kernels_active ()
+{
+	return *active;
+}
+
+bool logicle_kernels_select (const char * name)
+{
+	for (int i = 0; i < KERNELS; ++i)
+		if (strcmp(kernels[i].name, name) == 0 && supported(kernels[i]))
+		{
+			active = &kernels[i];
+			return true;
+		}
+	return false;
+}
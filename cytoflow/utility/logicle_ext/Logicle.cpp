@@ -1,9 +1,13 @@
 #include "logicle.h"
+#include "kernels.h"
+#include "threads.h"
+#include "stats.h"
 #include <memory.h>
 #include <cstring>
 #include <cstdio>
 #include <cmath>
 #include <limits>
+#include <algorithm>
 
 const double Logicle::DEFAULT_DECADES = 4.5;
 
@@ -18,19 +22,30 @@ Logicle::Exception::Exception()
 	buffer = 0;
 }
 
+// the buffer is always allocated with new[], so the destructor can free
+// it the same way whichever constructor made it
+static char * copyMessage (const char * message)
+{
+	if (!message)
+		return 0;
+	char * buffer = new char[strlen(message) + 1];
+	strcpy(buffer, message);
+	return buffer;
+}
+
 Logicle::Exception::Exception(const Logicle::Exception & e)
 {
-	buffer = strdup(e.buffer);
+	buffer = copyMessage(e.buffer);
 }
 
 Logicle::Exception::Exception (const char * const message)
 {
-	buffer = strdup(message);
+	buffer = copyMessage(message);
 }
 
 Logicle::Exception::~Exception ()
 {
-	delete buffer;
+	delete[] buffer;
 }
 
 const char * Logicle::Exception::message () const
@@ -40,12 +55,14 @@ const char * Logicle::Exception::message () const
 
 Logicle::IllegalArgument::IllegalArgument (double value)
 {
+	LOGICLE_COUNT(LOGICLE_ILLEGAL_ARGUMENTS, 1);
 	buffer = new char[128];
 	sprintf(buffer, "Illegal argument value %.17g", value);
 }
 
 Logicle::IllegalArgument::IllegalArgument (int value)
 {
+	LOGICLE_COUNT(LOGICLE_ILLEGAL_ARGUMENTS, 1);
 	buffer = new char[128];
 	sprintf(buffer, "Illegal argument value %d", value);
 }
@@ -54,14 +71,18 @@ Logicle::IllegalParameter::IllegalParameter (const char * const message) : Excep
 {	}
 
 Logicle::DidNotConverge::DidNotConverge(const char * const message) : Exception(message)
-{	}
+{
+	LOGICLE_COUNT(LOGICLE_DID_NOT_CONVERGE, 1);
+}
 
 void Logicle::initialize (double T, double W, double M, double A, int bins)
 {
-	// allocate the parameter structure
-	p = new logicle_params;
-	p->taylor = 0;
-
+	// NaN fails every comparison below, so check for it (and infinity)
+	// first; a NaN T would size the table's index from NaN, and NaN keys
+	// would break the ordering of the table cache
+	if (!std::isfinite(T) || !std::isfinite(W)
+		|| !std::isfinite(M) || !std::isfinite(A))
+		throw IllegalParameter("parameters must be finite");
 	if (T <= 0)
 		throw IllegalParameter("T is not positive");
 	if (W < 0)
@@ -73,6 +94,12 @@ void Logicle::initialize (double T, double W, double M, double A, int bins)
 	if (-A > W || A + W > M - W)
 		throw IllegalParameter("A is too large");
 
+	// allocate the parameter structure, now that nothing above can throw
+	// and leak it
+	p = new logicle_params;
+	p->taylor = 0;
+	logicle_table_init(&p->table);
+
 	// if we're going to bin the data make sure that
 	// zero is on a bin boundary by adjusting A
 	if (bins > 0)
@@ -95,7 +122,15 @@ void Logicle::initialize (double T, double W, double M, double A, int bins)
 	p->x1 = p->x2 + p->w;
 	p->x0 = p->x2 + 2 * p->w;
 	p->b = (M + A) * LN_10;
-	p->d = solve(p->b, p->w);
+	try
+	{
+		p->d = solve(p->b, p->w);
+	}
+	catch (...)
+	{
+		delete p;
+		throw;
+	}
 	double c_a = exp(p->x0 * (p->b + p->d));
 	double mf_a = exp(p->b * p->x1) - c_a / exp(p->d * p->x1);
 	p->a = T / ((exp(p->b) - mf_a) - c_a / exp(p->d));
@@ -139,7 +174,7 @@ Logicle::Logicle (const Logicle & logicle)
 
 Logicle::~Logicle ()
 {
-	delete p->taylor;
+	delete[] p->taylor;
 	delete p;
 }
 
@@ -261,6 +296,11 @@ double Logicle::scale (double value) const
 	if (x > 1)
 		tolerance = 3 * x * EPSILON;
 
+	LOGICLE_COUNT(LOGICLE_EXACT_SCALES, 1);
+#ifdef LOGICLE_STATS
+	bool taylor = false;
+#endif
+
 	for (int i = 0; i < 10; ++i)
 	{
 		// compute the function and its first two derivatives
@@ -268,8 +308,13 @@ double Logicle::scale (double value) const
 		double ce2mdx = p->c / exp(p->d * x);
 		double y;
 		if (x < p->xTaylor)
+		{
 			// near zero use the Taylor series
 			y = seriesBiexponential(x) - value;
+#ifdef LOGICLE_STATS
+			taylor = true;
+#endif
+		}
 		else
 			// this formulation has better roundoff behavior
 			y = (ae2bx + p->f) - (ce2mdx + value);
@@ -284,13 +329,23 @@ double Logicle::scale (double value) const
 
 		// if we've reached the desired precision we're done
 		if (std::abs(delta) < tolerance)
+		{
+			LOGICLE_COUNT(LOGICLE_HALLEY_ITERATIONS, i + 1);
+			LOGICLE_BUCKET(LOGICLE_HALLEY_HISTOGRAM, i + 1);
+#ifdef LOGICLE_STATS
+			if (taylor)
+				LOGICLE_COUNT(LOGICLE_TAYLOR_SCALES, 1);
+#endif
+
 			// handle negative arguments
 			if (negative)
 				return 2 * p->x1 - x;
 			else
 				return x;
+		}
 	}
 
+	LOGICLE_COUNT(LOGICLE_HALLEY_ITERATIONS, 10);
 	throw DidNotConverge("scale() didn't converge");
 };
 
@@ -317,6 +372,60 @@ double Logicle::inverse (double scale) const
 		return inverse;
 };
 
+void Logicle::scale (const double * value, double * scale, size_t n) const
+{
+	// there's no kernel for Halley's method, so this is just the scalar
+	// transform on the thread pool
+	Transform::scale(value, scale, n);
+}
+
+void Logicle::inverse (const double * scale, double * value, size_t n) const
+{
+	const logicle_kernels & kernels = logicle_kernels_active();
+	logicle_parallel(n, [this, &kernels, scale, value] (size_t begin, size_t end) {
+		if (kernels.inverse)
+			kernels.inverse(p, TAYLOR_LENGTH, scale + begin, value + begin, end - begin);
+		else
+			for (size_t i = begin; i < end; ++i)
+				value[i] = Logicle::inverse(scale[i]);
+	});
+}
+
+const char * Logicle::simd ()
+{
+	return logicle_kernels_active().name;
+}
+
+bool Logicle::setSimd (const char * name)
+{
+	return logicle_kernels_select(name);
+}
+
+int Logicle::threads ()
+{
+	return logicle_threads();
+}
+
+void Logicle::setThreads (int threads)
+{
+	logicle_set_threads(threads);
+}
+
+int Logicle::tableCacheSize ()
+{
+	return logicle_table_cache_size();
+}
+
+void Logicle::setTableCacheSize (int size)
+{
+	logicle_table_set_cache_size(size);
+}
+
+int Logicle::tableCacheCount ()
+{
+	return logicle_table_cache_count();
+}
+
 double Logicle::dynamicRange () const
 {
 	return slope(1) / slope(p->x1);
@@ -366,5 +475,74 @@ void Logicle::axisLabels (std::vector<double> & label) const
 	}
 }
 
+// the ticks at every decade from minPositive up through vmax, and down
+// through vmin if it's negative.  extra more decades go on either end.
+static void logicle_decades (double vmin, double vmax, double minPositive,
+	int extra, std::vector<double> & ticks)
+{
+	double maxDecade = ceil(log10(vmax * 1.1)) + extra;
+	ticks.clear();
+	if (vmin < 0)
+	{
+		for (double x = floor(log10(-vmin)) + extra; x > 1; x -= 1)
+			ticks.push_back(-pow(10., x));
+		ticks.push_back(0);
+	}
+	else if (vmin == 0)
+		ticks.push_back(0);
+	for (double x = minPositive; x < maxDecade; x += 1)
+		ticks.push_back(pow(10., x));
+}
+
+void Logicle::axisTicks (double vmin, double vmax,
+	std::vector<double> & major, std::vector<double> & minor) const
+{
+	// widen the view out to the nearest tenth of a decade, like the
+	// locators' view_limits()
+	if (vmax < vmin)
+		std::swap(vmin, vmax);
+	if (vmax > 0)
+	{
+		double unit = pow(10., ceil(log10(vmax)) - 1);
+		vmax = ceil(vmax / unit) * unit;
+	}
+	else
+		vmax = 100;
+	if (vmin >= 0)
+		vmin = 0;
+	else
+	{
+		double unit = pow(10., ceil(log10(-vmin)) - 1);
+		vmin = floor(vmin / unit) * unit;
+	}
+
+	// and make sure it isn't empty, like matplotlib's nonsingular().  it
+	// always has zero at one end or inside it by now.
+	if (!std::isfinite(vmin) || !std::isfinite(vmax)
+		|| std::max(-vmin, vmax) < 1e21 * std::numeric_limits<double>::min())
+	{
+		vmin = -0.001;
+		vmax = 0.001;
+	}
+
+	double minPositive = ceil(log10(p->T) - p->M) + 1;
+	logicle_decades(vmin, vmax, minPositive, 0, major);
+
+	// tenths of each decade, with one more decade on either end.  these
+	// are numpy.arange()'s steps, so that the ticks are the same ones.
+	std::vector<double> decade;
+	logicle_decades(vmin, vmax, minPositive, 1, decade);
+	minor.clear();
+	for (size_t i = 0; i + 1 < decade.size(); ++i)
+	{
+		double x = decade[i], y = decade[i + 1];
+		double step = std::max(std::abs(x), std::abs(y)) / 10;
+		double n = ceil((y - x) / step);
+		double delta = (x + step) - x;
+		for (int j = 0; j < n; ++j)
+			minor.push_back(x + j * delta);
+	}
+}
+
 // Visual C++ hack!
 int PullInMyLibrary () { return 0; };
@@ -9,13 +9,388 @@ except:
 "
 %enddef
 
-%module(moduleimport=MODULEIMPORT) Logicle
+%module(moduleimport=MODULEIMPORT, threads="1") Logicle
+
+// the wrappers release the GIL around the C++ calls, so other Python
+// threads can run while we build tables and transform data.  arguments are
+// converted (and buffers acquired) before it's released, and SWIG takes it
+// back before the %exception handlers below run, so they can still set the
+// Python error.  the accessors are too quick to be worth the trouble.
+%nothread Logicle::T;
+%nothread Logicle::W;
+%nothread Logicle::M;
+%nothread Logicle::A;
+%nothread Logicle::a;
+%nothread Logicle::b;
+%nothread Logicle::c;
+%nothread Logicle::d;
+%nothread Logicle::f;
+%nothread Logicle::w;
+%nothread Logicle::x0;
+%nothread Logicle::x1;
+%nothread Logicle::x2;
+%nothread Logicle::simd;
+%nothread Logicle::setSimd;
+%nothread Logicle::threads;
+%nothread Logicle::setThreads;
+%nothread Logicle::tableCacheSize;
+%nothread Logicle::setTableCacheSize;
+%nothread Logicle::tableCacheCount;
+%nothread FastLogicle::bins;
+%nothread FastLogicle::tableFile;
+%nothread Hlog::b;
+%nothread Hlog::r;
+%nothread Hlog::d;
+%nothread FastHlog::bins;
+%nothread Arcsinh::cofactor;
+%nothread FastArcsinh::T;
+%nothread FastArcsinh::bins;
+%nothread FcsData::events;
+%nothread FcsData::parameters;
+%nothread DensityGrid::cells;
+%nothread DensityGrid::events;
+%nothread ChannelStats::count;
+%nothread ChannelStats::maximum;
+%nothread ChannelStats::negatives;
+%nothread ChannelStats::negativeQuantile;
+%nothread NearestCentroid::clusters;
+%nothread NearestCentroid::columns;
+%nothread GaussianMixture::components;
+%nothread GaussianMixture::columns;
+%nothread TransformStats::TransformStats;
+%nothread TransformStats::enabled;
+%nothread TransformStats::reset;
+%nothread TransformStats::count;
+%nothread TransformStats::histogram;
 
 %{
 #define SWIG_FILE_WITH_INIT
 #include "logicle.h"
+#include "hlog.h"
+#include "arcsinh.h"
+#include "fcs.h"
+#include "histogram.h"
+#include "density.h"
+#include "gate.h"
+#include "statistics.h"
+#include "columns.h"
+#include "kde.h"
+#include "clusters.h"
+#include "stats.h"
+#include <cstring>
+#include <stdexcept>
+
+// a contiguous array of doubles (or floats) borrowed from a Python object
+// through the buffer protocol, so that numpy arrays (and array.array,
+// memoryview, etc.) can be transformed in a single call without copying.
+class LogicleArray
+{
+public:
+        // one of these is set, depending on the element type
+        double * data;
+        float * floats;
+        size_t size;
+
+        LogicleArray () : data(NULL), floats(NULL), size(0), acquired(false) { }
+
+        ~LogicleArray ()
+        {
+                if (acquired)
+                        PyBuffer_Release(&view);
+        }
+
+        bool acquire (PyObject * obj, bool writable)
+        {
+                int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+                if (writable)
+                        flags |= PyBUF_WRITABLE;
+                if (PyObject_GetBuffer(obj, &view, flags) != 0)
+                        return false;
+                acquired = true;
+
+                char type = element(view.format);
+                if (type == 'd' && view.itemsize == sizeof(double))
+                        data = (double *) view.buf;
+                else if (type == 'f' && view.itemsize == sizeof(float))
+                        floats = (float *) view.buf;
+                else
+                {
+                        PyErr_SetString(PyExc_TypeError, "expected a contiguous array of float64 or float32");
+                        return false;
+                }
+
+                size = (size_t) (view.len / view.itemsize);
+                return true;
+        }
+
+private:
+        Py_buffer view;
+        bool acquired;
+
+        LogicleArray (const LogicleArray &);
+        LogicleArray & operator= (const LogicleArray &);
+
+        // the element type of a buffer of native numbers, or 0
+        static char element (const char * format)
+        {
+                if (format == NULL)
+                        return 0;
+
+                // native or standard size, in native byte order
+                const int one = 1;
+                bool little = *(const char *) &one == 1;
+                if (*format == '@' || *format == '=' || *format == (little ? '<' : '>'))
+                        ++format;
+                else if (*format == '!' && !little)
+                        ++format;
+
+                return format[1] == '\0' ? format[0] : 0;
+        }
+};
+
+// check that a batch's input and output arrays match
+static void logicle_check (const LogicleArray & in, const LogicleArray & out)
+{
+        if (in.size != out.size)
+                throw std::length_error("input and output arrays are different sizes");
+        if ((in.data == NULL) != (out.data == NULL))
+                throw std::invalid_argument("input and output arrays are different types");
+}
+
+// a contiguous, writable array of bytes (eg. numpy bool) borrowed from a
+// Python object, for the gates' results
+class LogicleMask
+{
+public:
+        unsigned char * data;
+        size_t size;
+
+        LogicleMask () : data(NULL), size(0), acquired(false) { }
+
+        ~LogicleMask ()
+        {
+                if (acquired)
+                        PyBuffer_Release(&view);
+        }
+
+        bool acquire (PyObject * obj)
+        {
+                int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE;
+                if (PyObject_GetBuffer(obj, &view, flags) != 0)
+                        return false;
+                acquired = true;
+
+                // a single byte is the same in any byte order
+                const char * format = view.format;
+                if (format != NULL && *format != '\0' && strchr("@=<>!", *format) != NULL)
+                        ++format;
+                if (view.itemsize != 1 || format == NULL || format[0] == '\0'
+                        || format[1] != '\0' || strchr("?bB", format[0]) == NULL)
+                {
+                        PyErr_SetString(PyExc_TypeError, "expected a contiguous array of bool or bytes");
+                        return false;
+                }
+
+                data = (unsigned char *) view.buf;
+                size = (size_t) view.len;
+                return true;
+        }
+
+private:
+        Py_buffer view;
+        bool acquired;
+
+        LogicleMask (const LogicleMask &);
+        LogicleMask & operator= (const LogicleMask &);
+};
+
+// a contiguous, writable array of native ints (eg. numpy int32) borrowed
+// from a Python object, for the clusters' assignments
+class LogicleLabels
+{
+public:
+        int * data;
+        size_t size;
+
+        LogicleLabels () : data(NULL), size(0), acquired(false) { }
+
+        ~LogicleLabels ()
+        {
+                if (acquired)
+                        PyBuffer_Release(&view);
+        }
+
+        bool acquire (PyObject * obj)
+        {
+                int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE;
+                if (PyObject_GetBuffer(obj, &view, flags) != 0)
+                        return false;
+                acquired = true;
+
+                const char * format = view.format;
+                if (format != NULL && (*format == '@' || *format == '='))
+                        ++format;
+                if (view.itemsize != sizeof(int) || format == NULL || format[0] == '\0'
+                        || format[1] != '\0' || strchr("il", format[0]) == NULL)
+                {
+                        PyErr_SetString(PyExc_TypeError, "expected a contiguous array of int32");
+                        return false;
+                }
+
+                data = (int *) view.buf;
+                size = (size_t) view.len / sizeof(int);
+                return true;
+        }
+
+private:
+        Py_buffer view;
+        bool acquired;
+
+        LogicleLabels (const LogicleLabels &);
+        LogicleLabels & operator= (const LogicleLabels &);
+};
 %}
 
+%typemap(in) const LogicleArray & (LogicleArray temp)
+{
+   if (!temp.acquire($input, false))
+      SWIG_fail;
+   $1 = &temp;
+}
+
+%typemap(in) LogicleArray & (LogicleArray temp)
+{
+   if (!temp.acquire($input, true))
+      SWIG_fail;
+   $1 = &temp;
+}
+
+%typemap(typecheck, precedence=SWIG_TYPECHECK_DOUBLE_ARRAY) const LogicleArray &, LogicleArray &
+{
+   $1 = PyObject_CheckBuffer($input);
+}
+
+%typemap(in) LogicleMask & (LogicleMask temp)
+{
+   if (!temp.acquire($input))
+      SWIG_fail;
+   $1 = &temp;
+}
+
+%typemap(in) LogicleLabels & (LogicleLabels temp)
+{
+   if (!temp.acquire($input))
+      SWIG_fail;
+   $1 = &temp;
+}
+
+%exception scale {
+   try {
+      $action
+   } catch (Logicle::IllegalArgument &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (Logicle::DidNotConverge &e) {
+      PyErr_SetString(PyExc_RuntimeError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+
+// bad parameters
+%exception Logicle::Logicle {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception FastLogicle::FastLogicle {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+// can't save the table
+%exception FastLogicle::save {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_OSError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception HermiteLogicle::HermiteLogicle {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception Hlog::Hlog {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception FastHlog::FastHlog {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception Arcsinh::Arcsinh {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception FastArcsinh::FastArcsinh {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception clipScale {
+   try {
+      $action
+   } catch (Logicle::IllegalArgument &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+
 %exception intScale {
    try {
       $action
@@ -31,10 +406,104 @@ except:
    } catch (Logicle::IllegalArgument &e) {
       PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
       return NULL;
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+
+// the exact inverse doesn't use the table, so it takes any scale value
+%exception exactInverse {
+   try {
+      $action
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+
+// nor do the ones that handle values off the table themselves
+%exception scaleOutside {
+   try {
+      $action
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+
+%exception inverseOutside {
+   try {
+      $action
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
    }
 }
 
-class Logicle
+// axisLabels and axisTicks fill in vectors, which come back to Python as
+// lists; axisTicks returns [major, minor]
+%typemap(in, numinputs=0) std::vector<double> & OUTPUT (std::vector<double> temp)
+{
+   $1 = &temp;
+}
+
+%typemap(argout) std::vector<double> & OUTPUT
+{
+   PyObject * list = PyList_New($1->size());
+   if (list == NULL)
+      SWIG_fail;
+   for (size_t i = 0; i < $1->size(); ++i)
+      PyList_SET_ITEM(list, i, PyFloat_FromDouble((*$1)[i]));
+   $result = SWIG_Python_AppendOutput($result, list);
+}
+
+%apply std::vector<double> & OUTPUT { std::vector<double> & label };
+%apply std::vector<double> & OUTPUT { std::vector<double> & major };
+%apply std::vector<double> & OUTPUT { std::vector<double> & minor };
+
+// and scaleOutside and inverseOutside return the indices of the values
+// that were outside, as a list of ints
+%typemap(in, numinputs=0) std::vector<size_t> & OUTPUT (std::vector<size_t> temp)
+{
+   $1 = &temp;
+}
+
+%typemap(argout) std::vector<size_t> & OUTPUT
+{
+   PyObject * list = PyList_New($1->size());
+   if (list == NULL)
+      SWIG_fail;
+   for (size_t i = 0; i < $1->size(); ++i)
+      PyList_SET_ITEM(list, i, PyLong_FromSize_t((*$1)[i]));
+   $result = SWIG_Python_AppendOutput($result, list);
+}
+
+%apply std::vector<size_t> & OUTPUT { std::vector<size_t> & outside };
+
+// the interface all of the transforms share
+class Transform
+{
+public:
+        virtual ~Transform ();
+
+        virtual double scale (double value) const = 0;
+        virtual double inverse (double scale) const = 0;
+};
+
+class Logicle : public Transform
 {
 public:
         static const double DEFAULT_DECADES;
@@ -62,20 +531,15 @@ public:
 
         class IllegalArgument : public Exception
         {
-        private:
+        public:
                 IllegalArgument (double value);
                 IllegalArgument (int value);
-
-                friend class Logicle;
-                friend class FastLogicle;
         };
 
         class IllegalParameter : public Exception
         {
-        private:
+        public:
                 IllegalParameter (const char * const message);
-
-                friend class Logicle;
         };
 
         class DidNotConverge : public Exception
@@ -84,6 +548,7 @@ public:
                 DidNotConverge (const char * const message);
 
                 friend class Logicle;
+                friend class Hlog;
         };
 
         Logicle (double T, double W, double M = DEFAULT_DECADES, double A = 0);
@@ -109,8 +574,31 @@ public:
 
         virtual double scale (double value) const;
         virtual double inverse (double scale) const;
+
         double dynamicRange () const;
         void axisLabels (std::vector<double> & label) const;
+        void axisTicks (double vmin, double vmax,
+                std::vector<double> & major, std::vector<double> & minor) const;
+
+        // the instruction set the batch transforms use, and a way to
+        // choose another one (mostly for testing.)  setSimd returns false
+        // if the CPU doesn't support it.
+        static const char * simd ();
+        static bool setSimd (const char * name);
+
+        // the number of threads the batch transforms use.  0 (the
+        // default) means one per CPU.  arrays too small to be worth
+        // splitting up always run on the calling thread.
+        static int threads ();
+        static void setThreads (int threads);
+
+        // the fast transforms share their lookup tables through a cache
+        // of the most recently built ones, and this is how many it keeps
+        // (32 by default; 0 turns it off.)  tableCacheCount is how many
+        // it has now.
+        static int tableCacheSize ();
+        static void setTableCacheSize (int size);
+        static int tableCacheCount ();
 
 protected:
         static const double LN_10;
@@ -148,6 +636,8 @@ public:
         FastLogicle (double T, double W, double M);
         FastLogicle (double T, double W);
 
+        FastLogicle (const char * path);
+
         FastLogicle (const FastLogicle & logicle);
 
         virtual ~FastLogicle ();
@@ -155,14 +645,898 @@ public:
         virtual double scale (double value) const;
         virtual double inverse (double scale) const;
 
-        inline int bins () const { return p->bins; };
+        virtual double clipScale (double value) const;
+
+        inline int bins () const { return p->table.bins; };
 
         int intScale (double value) const;
         double inverse (int scale) const;
 
+        enum Outside { CLIP_OUTSIDE, NAN_OUTSIDE };
+
+        void save (const char * path) const;
+        const char * tableFile () const;
+
 private:
         void initialize (int bins);
 
         friend class TestLogicle;
 };
 
+// the transforms are all virtual, so FastLogicle's wrappers (including the
+// batches) already run the cubics
+class HermiteLogicle : public FastLogicle
+{
+public:
+        HermiteLogicle (double T, double W, double M, double A, int bins);
+        HermiteLogicle (double T, double W, double M, int bins);
+        HermiteLogicle (double T, double W, int bins);
+
+        HermiteLogicle (double T, double W, double M, double A);
+        HermiteLogicle (double T, double W, double M);
+        HermiteLogicle (double T, double W);
+
+        HermiteLogicle (const HermiteLogicle & logicle);
+
+        virtual ~HermiteLogicle ();
+};
+
+class Hlog : public Transform
+{
+public:
+        Hlog (double b, double r, double d);
+        Hlog (const Hlog & hlog);
+
+        virtual ~Hlog ();
+
+        inline double b () const { return p->b; };
+        inline double r () const { return p->r; };
+        inline double d () const { return p->d; };
+
+        virtual double scale (double value) const;
+        virtual double inverse (double scale) const;
+
+protected:
+        hlog_params * p;
+
+private:
+        Hlog & operator= (const Hlog & hlog);
+};
+
+class FastHlog : public Hlog
+{
+public:
+        static const int DEFAULT_BINS;
+
+        FastHlog (double b, double r, double d, int bins = DEFAULT_BINS);
+        FastHlog (const FastHlog & hlog);
+
+        virtual ~FastHlog ();
+
+        virtual double scale (double value) const;
+        virtual double inverse (double scale) const;
+
+        inline int bins () const { return p->table.bins; };
+
+private:
+        FastHlog & operator= (const FastHlog & hlog);
+};
+
+class Arcsinh : public Transform
+{
+public:
+        Arcsinh (double cofactor);
+        Arcsinh (const Arcsinh & arcsinh);
+
+        virtual ~Arcsinh ();
+
+        inline double cofactor () const { return p->cofactor; };
+
+        virtual double scale (double value) const;
+        virtual double inverse (double scale) const;
+
+protected:
+        arcsinh_params * p;
+
+private:
+        Arcsinh & operator= (const Arcsinh & arcsinh);
+};
+
+class FastArcsinh : public Arcsinh
+{
+public:
+        static const int DEFAULT_BINS;
+
+        FastArcsinh (double cofactor, double T, int bins = DEFAULT_BINS);
+        FastArcsinh (const FastArcsinh & arcsinh);
+
+        virtual ~FastArcsinh ();
+
+        virtual double scale (double value) const;
+        virtual double inverse (double scale) const;
+
+        inline double T () const { return p->T; };
+        inline int bins () const { return p->table.bins; };
+
+private:
+        FastArcsinh & operator= (const FastArcsinh & arcsinh);
+};
+
+// from Python, the batch transforms take an input array and an output array
+// of the same size and type (float64 or float32), eg. logicle.scale(data,
+// out).  out may be data itself.
+%define LOGICLE_BATCH(cls)
+%extend cls {
+        void scale (const LogicleArray & value, LogicleArray & scale) const
+        {
+                logicle_check(value, scale);
+                if (value.floats)
+                        $self->scale(value.floats, scale.floats, value.size);
+                else
+                        $self->scale(value.data, scale.data, value.size);
+        }
+
+        void inverse (const LogicleArray & scale, LogicleArray & value) const
+        {
+                logicle_check(scale, value);
+                if (scale.floats)
+                        $self->inverse(scale.floats, value.floats, scale.size);
+                else
+                        $self->inverse(scale.data, value.data, scale.size);
+        }
+}
+%enddef
+
+LOGICLE_BATCH(Transform)
+LOGICLE_BATCH(Logicle)
+LOGICLE_BATCH(FastLogicle)
+LOGICLE_BATCH(Hlog)
+LOGICLE_BATCH(FastHlog)
+LOGICLE_BATCH(Arcsinh)
+LOGICLE_BATCH(FastArcsinh)
+
+%extend FastLogicle {
+        void clipScale (const LogicleArray & value, LogicleArray & scale) const
+        {
+                logicle_check(value, scale);
+                if (value.floats)
+                        $self->clipScale(value.floats, scale.floats, value.size);
+                else
+                        $self->clipScale(value.data, scale.data, value.size);
+        }
+
+        void exactInverse (const LogicleArray & scale, LogicleArray & value) const
+        {
+                logicle_check(scale, value);
+                if (scale.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                $self->exactInverse(scale.data, value.data, scale.size);
+        }
+
+        // like scale and inverse, except that values off the table are
+        // clipped or become NaN (by policy) rather than raising, and the
+        // indices of those that were come back as a list
+        void scaleOutside (const LogicleArray & value, LogicleArray & scale,
+                FastLogicle::Outside policy, std::vector<size_t> & outside) const
+        {
+                logicle_check(value, scale);
+                if (value.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                $self->scale(value.data, scale.data, value.size, policy, &outside);
+        }
+
+        void inverseOutside (const LogicleArray & scale, LogicleArray & value,
+                FastLogicle::Outside policy, std::vector<size_t> & outside) const
+        {
+                logicle_check(scale, value);
+                if (scale.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                $self->inverse(scale.data, value.data, scale.size, policy, &outside);
+        }
+}
+
+// transforms pickle as their parameters; unpickled in a process that
+// already has the same table, they share it from the cache.  copies share
+// their tables too, since tables never change.
+%extend Transform {
+%pythoncode %{
+    def __copy__(self):
+        return type(self)(self)
+
+    def __deepcopy__(self, memo):
+        return type(self)(self)
+%}
+}
+
+%extend Logicle {
+%pythoncode %{
+    def __reduce__(self):
+        return (Logicle, (self.T(), self.W(), self.M(), self.A()))
+%}
+}
+
+%extend FastLogicle {
+%pythoncode %{
+    def __reduce__(self):
+        # a table mapped from a file is mapped from the same file again.
+        # (A has already been put on a bin boundary, and doing it again
+        # doesn't change it.)
+        if self.tableFile():
+            return (FastLogicle, (self.tableFile(),))
+        return (FastLogicle, (self.T(), self.W(), self.M(), self.A(), self.bins()))
+%}
+}
+
+%extend HermiteLogicle {
+%pythoncode %{
+    def __reduce__(self):
+        return (HermiteLogicle, (self.T(), self.W(), self.M(), self.A(), self.bins()))
+%}
+}
+
+%extend Hlog {
+%pythoncode %{
+    def __reduce__(self):
+        return (Hlog, (self.b(), self.r(), self.d()))
+%}
+}
+
+%extend FastHlog {
+%pythoncode %{
+    def __reduce__(self):
+        return (FastHlog, (self.b(), self.r(), self.d(), self.bins()))
+%}
+}
+
+%extend Arcsinh {
+%pythoncode %{
+    def __reduce__(self):
+        return (Arcsinh, (self.cofactor(),))
+%}
+}
+
+%extend FastArcsinh {
+%pythoncode %{
+    def __reduce__(self):
+        return (FastArcsinh, (self.cofactor(), self.T(), self.bins()))
+%}
+}
+
+// FcsData decodes an FCS file's DATA segment from a memory mapping of it.
+// the TEXT segment stays in Python (fcsparser), and what it says about
+// the DATA segment comes in as plain sequences.
+%typemap(in) const std::vector<int> & (std::vector<int> temp)
+{
+   PyObject * seq = PySequence_Fast($input, "expected a sequence of integers");
+   if (seq == NULL)
+      SWIG_fail;
+   for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i)
+   {
+      long value = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+      if (value == -1 && PyErr_Occurred())
+      {
+         Py_DECREF(seq);
+         SWIG_fail;
+      }
+      temp.push_back((int) value);
+   }
+   Py_DECREF(seq);
+   $1 = &temp;
+}
+
+%typemap(in) const std::vector<double> & (std::vector<double> temp)
+{
+   PyObject * seq = PySequence_Fast($input, "expected a sequence of numbers");
+   if (seq == NULL)
+      SWIG_fail;
+   for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i)
+   {
+      double value = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, i));
+      if (value == -1 && PyErr_Occurred())
+      {
+         Py_DECREF(seq);
+         SWIG_fail;
+      }
+      temp.push_back(value);
+   }
+   Py_DECREF(seq);
+   $1 = &temp;
+}
+
+// a file we can't read, or a DATA segment we can't decode
+%exception FcsData::FcsData {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%define FCS_DECODE(method)
+%exception FcsData::method {
+   try {
+      $action
+   } catch (Logicle::IllegalArgument &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (Logicle::DidNotConverge &e) {
+      PyErr_SetString(PyExc_RuntimeError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+%enddef
+
+FCS_DECODE(decode)
+FCS_DECODE(decodeScale)
+FCS_DECODE(decodeClipScale)
+
+class FcsData
+{
+public:
+        FcsData (const char * path, size_t begin, size_t end, char datatype,
+                bool bigEndian, size_t events, const std::vector<int> & bits,
+                const std::vector<double> & range);
+
+        ~FcsData ();
+
+        inline size_t events () const { return count; };
+        inline int parameters () const { return (int) width.size(); };
+
+private:
+        FcsData (const FcsData &);
+        FcsData & operator= (const FcsData &);
+};
+
+// from Python, a parameter decodes into an array of events() values, eg.
+// fcs.decode(0, out).  decode takes float64 or float32; the transforms
+// take float64.
+%{
+static void fcs_check (const FcsData & fcs, const LogicleArray & out, bool floats)
+{
+        if (out.size != fcs.events())
+                throw std::length_error("the output array isn't the size of the data");
+        if (out.floats && !floats)
+                throw std::invalid_argument("expected an array of float64");
+}
+%}
+
+%extend FcsData {
+        void decode (int parameter, LogicleArray & out) const
+        {
+                fcs_check(*$self, out, true);
+                if (out.floats)
+                        $self->decode(parameter, out.floats);
+                else
+                        $self->decode(parameter, out.data);
+        }
+
+        void decodeScale (int parameter, const Transform & transform, LogicleArray & out) const
+        {
+                fcs_check(*$self, out, false);
+                $self->decodeScale(parameter, transform, out.data);
+        }
+
+        void decodeClipScale (int parameter, const FastLogicle & logicle, LogicleArray & out) const
+        {
+                fcs_check(*$self, out, false);
+                $self->decodeClipScale(parameter, logicle, out.data);
+        }
+}
+
+// histograms on a transform's scale, counted from the data values (see
+// histogram.h).  from Python, eg. histogram(logicle, data, 0.1, 0.9, counts)
+// counts data into bins evenly spaced on logicle's scale from 0.1 to 0.9,
+// as many as counts (a float64 array) has, adding to what's there.
+%define HISTOGRAM_EXCEPTION(function)
+%exception function {
+   try {
+      $action
+   } catch (Logicle::DidNotConverge &e) {
+      PyErr_SetString(PyExc_RuntimeError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   } catch (std::length_error &e) {
+      PyErr_SetString(PyExc_ValueError, e.what());
+      return NULL;
+   } catch (std::invalid_argument &e) {
+      PyErr_SetString(PyExc_TypeError, e.what());
+      return NULL;
+   }
+}
+%enddef
+
+HISTOGRAM_EXCEPTION(histogram)
+HISTOGRAM_EXCEPTION(histogram2d)
+
+%inline %{
+void histogram (const Transform & transform, const LogicleArray & value,
+        double lo, double hi, LogicleArray & counts)
+{
+        if (value.floats || counts.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        Histogram h(transform, lo, hi, (int) counts.size);
+        h.count(value.data, value.size, counts.data);
+}
+
+// counts is xbins rows of y bins, in C order
+void histogram2d (const Transform & x, const LogicleArray & xvalue,
+        double xlo, double xhi, const Transform & y, const LogicleArray & yvalue,
+        double ylo, double yhi, int xbins, LogicleArray & counts)
+{
+        if (xvalue.floats || yvalue.floats || counts.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        if (xvalue.size != yvalue.size)
+                throw std::length_error("x and y are different sizes");
+        if (xbins <= 0 || counts.size % xbins != 0)
+                throw std::length_error("counts isn't xbins rows of y bins");
+        Histogram hx(x, xlo, xhi, xbins);
+        Histogram hy(y, ylo, yhi, (int) (counts.size / xbins));
+        Histogram::count(hx, hy, xvalue.data, yvalue.data, xvalue.size, counts.data);
+}
+%}
+
+// a density plot's counts, which can be re-binned for any zoom without
+// going back to the events (see density.h)
+%exception DensityGrid::DensityGrid {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+HISTOGRAM_EXCEPTION(DensityGrid::add)
+HISTOGRAM_EXCEPTION(DensityGrid::raster)
+
+class DensityGrid
+{
+public:
+        static const int DEFAULT_CELLS;
+
+        DensityGrid (const FastLogicle & xlogicle, const FastLogicle & ylogicle,
+                int cells = DEFAULT_CELLS);
+
+        inline int cells () const { return n; };
+        inline double events () const { return total; };
+};
+
+// from Python, grid.add(x, y) counts two float64 arrays of the same size,
+// and grid.raster(xlo, xhi, xbins, ylo, yhi, out) bins the counts into out,
+// a float64 array of xbins rows of y bins.
+%extend DensityGrid {
+        void add (const LogicleArray & xvalue, const LogicleArray & yvalue)
+        {
+                if (xvalue.floats || yvalue.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                if (xvalue.size != yvalue.size)
+                        throw std::length_error("x and y are different sizes");
+                $self->add(xvalue.data, yvalue.data, xvalue.size);
+        }
+
+        void raster (double xlo, double xhi, int xbins, double ylo, double yhi,
+                LogicleArray & out) const
+        {
+                if (out.floats)
+                        throw std::invalid_argument("expected an array of float64");
+                if (xbins <= 0 || out.size % xbins != 0)
+                        throw std::length_error("out isn't xbins rows of y bins");
+                $self->raster(xlo, xhi, xbins, ylo, yhi, (int) (out.size / xbins), out.data);
+        }
+}
+
+// binned kernel density estimates, on float64 arrays of values that are
+// already on the plot's scales (see kde.h)
+%exception KernelDensity::KernelDensity {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+HISTOGRAM_EXCEPTION(KernelDensity::density)
+HISTOGRAM_EXCEPTION(KernelDensity::density2d)
+
+class KernelDensity
+{
+public:
+        enum Kernel { GAUSSIAN, TOPHAT, EPANECHNIKOV, EXPONENTIAL, LINEAR, COSINE };
+
+        static const int DEFAULT_BINS;
+
+        KernelDensity (Kernel kernel, double bandwidth, int bins = DEFAULT_BINS);
+};
+
+// kde.density(value, point, out) estimates the density at each point into
+// out, which is the same size as point; kde.density2d(x, y, xpoint,
+// ypoint, out) into out, len(ypoint) rows of len(xpoint).
+%extend KernelDensity {
+        void density (const LogicleArray & value, const LogicleArray & point,
+                LogicleArray & out) const
+        {
+                if (value.floats || point.floats || out.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                if (point.size != out.size)
+                        throw std::length_error("point and out are different sizes");
+                $self->density(value.data, value.size, point.data, point.size, out.data);
+        }
+
+        void density2d (const LogicleArray & xvalue, const LogicleArray & yvalue,
+                const LogicleArray & xpoint, const LogicleArray & ypoint,
+                LogicleArray & out) const
+        {
+                if (xvalue.floats || yvalue.floats || xpoint.floats || ypoint.floats || out.floats)
+                        throw std::invalid_argument("expected arrays of float64");
+                if (xvalue.size != yvalue.size)
+                        throw std::length_error("x and y are different sizes");
+                if (out.size != xpoint.size * ypoint.size)
+                        throw std::length_error("out isn't a row of x points for each y point");
+                $self->density2d(xvalue.data, yvalue.data, xvalue.size, xpoint.data, xpoint.size,
+                        ypoint.data, ypoint.size, out.data);
+        }
+}
+
+// gates, evaluated on the data values in one pass (see gate.h).  a GateAxis
+// made from a transform keeps a reference to it, and a PolygonGate to its
+// axes, so the transforms live as long as the gates that use them.
+%pythonappend GateAxis::GateAxis %{
+    self._transform = args[0] if args else None
+%}
+
+%pythonappend GateAxis::clipped %{
+    val._transform = logicle
+%}
+
+%pythonappend PolygonGate::PolygonGate %{
+    self._axes = (x, y)
+%}
+
+%exception GateAxis::log {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception PolygonGate::PolygonGate {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+HISTOGRAM_EXCEPTION(PolygonGate::contains)
+HISTOGRAM_EXCEPTION(gateRange)
+HISTOGRAM_EXCEPTION(gateRange2d)
+HISTOGRAM_EXCEPTION(gateQuad)
+
+class GateAxis
+{
+public:
+        GateAxis ();
+        GateAxis (const Transform & transform);
+
+        static GateAxis clipped (const FastLogicle & logicle);
+        static GateAxis log (double threshold, bool mask);
+};
+
+class PolygonGate
+{
+public:
+        PolygonGate (const GateAxis & x, const GateAxis & y,
+                const std::vector<double> & xvertex, const std::vector<double> & yvertex);
+};
+
+// from Python, the gates take float64 arrays of data and write their
+// results into a bool (or int8, or uint8) array of the same size
+%{
+static void gate_check (const LogicleArray & x, const LogicleArray & y, const LogicleMask & out)
+{
+        if (x.floats || y.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        if (x.size != y.size || x.size != out.size)
+                throw std::length_error("the arrays are different sizes");
+}
+%}
+
+%extend PolygonGate {
+        void contains (const LogicleArray & xvalue, const LogicleArray & yvalue,
+                LogicleMask & in) const
+        {
+                gate_check(xvalue, yvalue, in);
+                $self->contains(xvalue.data, yvalue.data, xvalue.size, in.data);
+        }
+}
+
+%inline %{
+void gateRange (const LogicleArray & value, double lo, double hi, LogicleMask & in)
+{
+        gate_check(value, value, in);
+        logicle_gate_range(value.data, value.size, lo, hi, in.data);
+}
+
+void gateRange2d (const LogicleArray & xvalue, const LogicleArray & yvalue,
+        double xlo, double xhi, double ylo, double yhi, LogicleMask & in)
+{
+        gate_check(xvalue, yvalue, in);
+        logicle_gate_range2d(xvalue.data, yvalue.data, xvalue.size, xlo, xhi, ylo, yhi, in.data);
+}
+
+void gateQuad (const LogicleArray & xvalue, const LogicleArray & yvalue,
+        double xthreshold, double ythreshold, LogicleMask & quadrant)
+{
+        gate_check(xvalue, yvalue, quadrant);
+        logicle_gate_quad(xvalue.data, yvalue.data, xvalue.size, xthreshold, ythreshold, quadrant.data);
+}
+%}
+
+// the statistics LogicleScale estimates its parameters from, in one pass
+// over a float64 (or float32) array of events (see statistics.h)
+%exception ChannelStats::ChannelStats {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+class ChannelStats
+{
+public:
+        inline size_t count () const { return counted; };
+        inline double maximum () const { return largest; };
+        inline size_t negatives () const { return negative; };
+        inline double negativeQuantile () const { return quantile; };
+};
+
+%extend ChannelStats {
+        ChannelStats (const LogicleArray & value, double r)
+        {
+                if (value.floats)
+                        return new ChannelStats(value.floats, value.size, r);
+                return new ChannelStats(value.data, value.size, r);
+        }
+}
+
+// the bootstrap and percentiles behind cytoflow.utility.algorithms, on
+// float64 arrays.  the bootstrap makes as many resamples as there is room
+// for in out; the percentiles come back as a list.
+HISTOGRAM_EXCEPTION(bootstrapStatistic)
+HISTOGRAM_EXCEPTION(selectPercentiles)
+
+enum logicle_statistic
+{
+        LOGICLE_MEAN,
+        LOGICLE_MEDIAN,
+        LOGICLE_GEOM_MEAN
+};
+
+%apply std::vector<double> & OUTPUT { std::vector<double> & percentile };
+
+%inline %{
+void bootstrapStatistic (const LogicleArray & value, logicle_statistic statistic,
+        unsigned long long seed, LogicleArray & out)
+{
+        if (value.floats || out.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        logicle_bootstrap(value.data, value.size, statistic, seed, out.data, out.size);
+}
+
+void selectPercentiles (const LogicleArray & value, const std::vector<double> & percent,
+        std::vector<double> & percentile)
+{
+        if (value.floats)
+                throw std::invalid_argument("expected an array of float64");
+        percentile.resize(percent.size());
+        logicle_percentiles(value.data, value.size, percent.data(), percent.size(), percentile.data());
+}
+%}
+
+// every column of a float64 event matrix on its own scale, in one pass (see
+// columns.h.)  the matrix comes as a flat array in C (or Fortran) order,
+// eg. from numpy's ravel(order = 'K'), with a GateAxis for each column.
+%typemap(in) const std::vector<GateAxis> & (std::vector<GateAxis> temp)
+{
+   PyObject * seq = PySequence_Fast($input, "expected a sequence of GateAxis");
+   if (seq == NULL)
+      SWIG_fail;
+   for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i)
+   {
+      void * axis = 0;
+      int res = SWIG_ConvertPtr(PySequence_Fast_GET_ITEM(seq, i), &axis, $descriptor(GateAxis *), 0);
+      if (!SWIG_IsOK(res) || !axis)
+      {
+         Py_DECREF(seq);
+         SWIG_exception_fail(SWIG_TypeError, "expected a sequence of GateAxis");
+      }
+      temp.push_back(*(GateAxis *) axis);
+   }
+   Py_DECREF(seq);
+   $1 = &temp;
+}
+
+HISTOGRAM_EXCEPTION(scaleColumns)
+HISTOGRAM_EXCEPTION(compensateColumns)
+
+%inline %{
+void scaleColumns (const std::vector<GateAxis> & axis, const LogicleArray & in,
+        LogicleArray & out, bool fortran)
+{
+        logicle_check(in, out);
+        if (in.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        if (axis.empty() ? in.size != 0 : in.size % axis.size() != 0)
+                throw std::length_error("in isn't a whole number of rows");
+        logicle_scale_columns(axis, in.data, out.data,
+                axis.empty() ? 0 : in.size / axis.size(), fortran);
+}
+
+// the same, compensated by the columns x columns matrix (flattened in C
+// order) first.  with no axes, the compensated values aren't scaled.
+void compensateColumns (const std::vector<double> & matrix, const std::vector<GateAxis> & axis,
+        const LogicleArray & in, LogicleArray & out, size_t columns, bool fortran)
+{
+        logicle_check(in, out);
+        if (in.floats)
+                throw std::invalid_argument("expected arrays of float64");
+        if (matrix.size() != columns * columns)
+                throw std::length_error("the matrix isn't columns x columns");
+        if (!axis.empty() && axis.size() != columns)
+                throw std::length_error("there isn't an axis for each column");
+        if (columns == 0 ? in.size != 0 : in.size % columns != 0)
+                throw std::length_error("in isn't a whole number of rows");
+        logicle_compensate_columns(matrix, axis, in.data, out.data,
+                columns == 0 ? 0 : in.size / columns, columns, fortran);
+}
+%}
+
+// fitted clusters' assignments of a float64 event matrix, scaled on the
+// way (see clusters.h).  the matrix comes as it does to scaleColumns, and
+// the assignments go into an int32 array with an element for each row.
+// a mixture's posteriors and distances are only computed into arrays
+// that aren't empty.
+%exception NearestCentroid::NearestCentroid {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+%exception GaussianMixture::GaussianMixture {
+   try {
+      $action
+   } catch (Logicle::Exception &e) {
+      PyErr_SetString(PyExc_ValueError, const_cast<char*>(e.message()));
+      return NULL;
+   }
+}
+
+HISTOGRAM_EXCEPTION(NearestCentroid::assign)
+HISTOGRAM_EXCEPTION(GaussianMixture::assign)
+
+class NearestCentroid
+{
+public:
+        NearestCentroid (const std::vector<double> & centroid, size_t columns);
+
+        inline size_t clusters () const { return k; };
+        inline size_t columns () const { return d; };
+};
+
+class GaussianMixture
+{
+public:
+        GaussianMixture (const std::vector<double> & weight, const std::vector<double> & mean,
+                const std::vector<double> & precisionCholesky);
+
+        inline size_t components () const { return k; };
+        inline size_t columns () const { return d; };
+};
+
+%{
+static void cluster_check (const std::vector<GateAxis> & axis, const LogicleArray & in,
+        size_t columns, const LogicleLabels & label)
+{
+        if (in.floats)
+                throw std::invalid_argument("expected an array of float64");
+        if (!axis.empty() && axis.size() != columns)
+                throw std::length_error("there isn't an axis for each column");
+        if (in.size != label.size * columns)
+                throw std::length_error("in doesn't have a row for each label");
+}
+
+static double * cluster_output (const LogicleArray & out, size_t rows, size_t k)
+{
+        if (out.floats)
+                throw std::invalid_argument("expected an array of float64");
+        if (out.size == 0)
+                return NULL;
+        if (out.size != rows * k)
+                throw std::length_error("the output isn't a row for each event");
+        return out.data;
+}
+%}
+
+%extend NearestCentroid {
+        void assign (const std::vector<GateAxis> & axis, const LogicleArray & in, bool fortran,
+                LogicleLabels & cluster) const
+        {
+                cluster_check(axis, in, $self->columns(), cluster);
+                $self->assign(axis, in.data, cluster.size, fortran, cluster.data);
+        }
+}
+
+%extend GaussianMixture {
+        void assign (const std::vector<GateAxis> & axis, const LogicleArray & in, bool fortran,
+                LogicleLabels & component, LogicleArray & posterior, LogicleArray & distance) const
+        {
+                cluster_check(axis, in, $self->columns(), component);
+                size_t rows = component.size, k = $self->components();
+                $self->assign(axis, in.data, rows, fortran, component.data,
+                        cluster_output(posterior, rows, k), cluster_output(distance, rows, k));
+        }
+}
+
+// what the transforms have done, when the extension is built with
+// LOGICLE_STATS (see stats.h).  a TransformStats is a snapshot of the
+// counts since the last reset; histogram() returns a list of LOGICLE_BUCKETS
+// counts.
+HISTOGRAM_EXCEPTION(TransformStats::count)
+HISTOGRAM_EXCEPTION(TransformStats::histogram)
+
+enum logicle_counter
+{
+        LOGICLE_EXACT_SCALES,
+        LOGICLE_TAYLOR_SCALES,
+        LOGICLE_HALLEY_ITERATIONS,
+        LOGICLE_TABLE_VALUES,
+        LOGICLE_TABLE_FALLBACKS,
+        LOGICLE_TABLE_HITS,
+        LOGICLE_TABLE_BUILDS,
+        LOGICLE_TABLE_BINS,
+        LOGICLE_TABLE_NANOSECONDS,
+        LOGICLE_ILLEGAL_ARGUMENTS,
+        LOGICLE_DID_NOT_CONVERGE,
+        LOGICLE_COUNTERS
+};
+
+enum logicle_histogram
+{
+        LOGICLE_HALLEY_HISTOGRAM,
+        LOGICLE_TABLE_HISTOGRAM,
+        LOGICLE_HISTOGRAMS
+};
+
+const int LOGICLE_BUCKETS = 32;
+
+%apply std::vector<double> & OUTPUT { std::vector<double> & counts };
+
+class TransformStats
+{
+public:
+        TransformStats ();
+
+        static bool enabled ();
+        static void reset ();
+
+        unsigned long long count (int counter) const;
+        void histogram (int histogram, std::vector<double> & counts) const;
+};
@@ -62,7 +62,30 @@ class _SwigNonDynamicMeta(type):
     __setattr__ = _swig_setattr_nondynamic_class_variable(type.__setattr__)
 
 
-class Logicle(object):
+class Transform(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+
+    def __init__(self, *args, **kwargs):
+        raise AttributeError("No constructor defined - class is abstract")
+    __repr__ = _swig_repr
+    __swig_destroy__ = _Logicle.delete_Transform
+
+    def scale(self, *args) -> "double":
+        return _Logicle.Transform_scale(self, *args)
+
+    def inverse(self, *args) -> "double":
+        return _Logicle.Transform_inverse(self, *args)
+
+    def __copy__(self):
+        return type(self)(self)
+
+    def __deepcopy__(self, memo):
+        return type(self)(self)
+
+# Register Transform in _Logicle:
+_Logicle.Transform_swigregister(Transform)
+
+class Logicle(Transform):
     thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
     __repr__ = _swig_repr
 
@@ -109,23 +132,78 @@ class Logicle(object):
     def x2(self) -> "double":
         return _Logicle.Logicle_x2(self)
 
-    def scale(self, value: "double") -> "double":
-        return _Logicle.Logicle_scale(self, value)
+    def scale(self, *args) -> "double":
+        return _Logicle.Logicle_scale(self, *args)
 
-    def inverse(self, scale: "double") -> "double":
-        return _Logicle.Logicle_inverse(self, scale)
+    def inverse(self, *args) -> "double":
+        return _Logicle.Logicle_inverse(self, *args)
 
     def dynamicRange(self) -> "double":
         return _Logicle.Logicle_dynamicRange(self)
 
-    def axisLabels(self, label: "std::vector< double > &") -> "void":
-        return _Logicle.Logicle_axisLabels(self, label)
+    def axisLabels(self) -> "void":
+        return _Logicle.Logicle_axisLabels(self)
+
+    def axisTicks(self, vmin: "double", vmax: "double") -> "void":
+        return _Logicle.Logicle_axisTicks(self, vmin, vmax)
+
+    @staticmethod
+    def simd() -> "char const *":
+        return _Logicle.Logicle_simd()
+
+    @staticmethod
+    def setSimd(name: "char const *") -> "bool":
+        return _Logicle.Logicle_setSimd(name)
+
+    @staticmethod
+    def threads() -> "int":
+        return _Logicle.Logicle_threads()
+
+    @staticmethod
+    def setThreads(threads: "int") -> "void":
+        return _Logicle.Logicle_setThreads(threads)
+
+    @staticmethod
+    def tableCacheSize() -> "int":
+        return _Logicle.Logicle_tableCacheSize()
+
+    @staticmethod
+    def setTableCacheSize(size: "int") -> "void":
+        return _Logicle.Logicle_setTableCacheSize(size)
+
+    @staticmethod
+    def tableCacheCount() -> "int":
+        return _Logicle.Logicle_tableCacheCount()
+
+    def __reduce__(self):
+        return (Logicle, (self.T(), self.W(), self.M(), self.A()))
 
 # Register Logicle in _Logicle:
 _Logicle.Logicle_swigregister(Logicle)
 cvar = _Logicle.cvar
 Logicle.DEFAULT_DECADES = _Logicle.cvar.Logicle_DEFAULT_DECADES
 
+def Logicle_simd() -> "char const *":
+    return _Logicle.Logicle_simd()
+
+def Logicle_setSimd(name: "char const *") -> "bool":
+    return _Logicle.Logicle_setSimd(name)
+
+def Logicle_threads() -> "int":
+    return _Logicle.Logicle_threads()
+
+def Logicle_setThreads(threads: "int") -> "void":
+    return _Logicle.Logicle_setThreads(threads)
+
+def Logicle_tableCacheSize() -> "int":
+    return _Logicle.Logicle_tableCacheSize()
+
+def Logicle_setTableCacheSize(size: "int") -> "void":
+    return _Logicle.Logicle_setTableCacheSize(size)
+
+def Logicle_tableCacheCount() -> "int":
+    return _Logicle.Logicle_tableCacheCount()
+
 class FastLogicle(Logicle):
     thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
     __repr__ = _swig_repr
@@ -134,8 +212,11 @@ class FastLogicle(Logicle):
         _Logicle.FastLogicle_swiginit(self, _Logicle.new_FastLogicle(*args))
     __swig_destroy__ = _Logicle.delete_FastLogicle
 
-    def scale(self, value: "double") -> "double":
-        return _Logicle.FastLogicle_scale(self, value)
+    def scale(self, *args) -> "double":
+        return _Logicle.FastLogicle_scale(self, *args)
+
+    def clipScale(self, *args) -> "double":
+        return _Logicle.FastLogicle_clipScale(self, *args)
 
     def bins(self) -> "int":
         return _Logicle.FastLogicle_bins(self)
@@ -145,10 +226,421 @@ class FastLogicle(Logicle):
 
     def inverse(self, *args) -> "double":
         return _Logicle.FastLogicle_inverse(self, *args)
+    CLIP_OUTSIDE = _Logicle.FastLogicle_CLIP_OUTSIDE
+    NAN_OUTSIDE = _Logicle.FastLogicle_NAN_OUTSIDE
+
+    def save(self, path: "char const *") -> "void":
+        return _Logicle.FastLogicle_save(self, path)
+
+    def tableFile(self) -> "char const *":
+        return _Logicle.FastLogicle_tableFile(self)
+
+    def exactInverse(self, scale: "LogicleArray const &", value: "LogicleArray &") -> "void":
+        return _Logicle.FastLogicle_exactInverse(self, scale, value)
+
+    def scaleOutside(self, value: "LogicleArray const &", scale: "LogicleArray &", policy: "FastLogicle::Outside") -> "void":
+        return _Logicle.FastLogicle_scaleOutside(self, value, scale, policy)
+
+    def inverseOutside(self, scale: "LogicleArray const &", value: "LogicleArray &", policy: "FastLogicle::Outside") -> "void":
+        return _Logicle.FastLogicle_inverseOutside(self, scale, value, policy)
+
+    def __reduce__(self):
+        # a table mapped from a file is mapped from the same file again.
+        # (A has already been put on a bin boundary, and doing it again
+        # doesn't change it.)
+        if self.tableFile():
+            return (FastLogicle, (self.tableFile(),))
+        return (FastLogicle, (self.T(), self.W(), self.M(), self.A(), self.bins()))
 
 # Register FastLogicle in _Logicle:
 _Logicle.FastLogicle_swigregister(FastLogicle)
 FastLogicle.DEFAULT_BINS = _Logicle.cvar.FastLogicle_DEFAULT_BINS
 
+class HermiteLogicle(FastLogicle):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.HermiteLogicle_swiginit(self, _Logicle.new_HermiteLogicle(*args))
+    __swig_destroy__ = _Logicle.delete_HermiteLogicle
+
+    def __reduce__(self):
+        return (HermiteLogicle, (self.T(), self.W(), self.M(), self.A(), self.bins()))
+
+# Register HermiteLogicle in _Logicle:
+_Logicle.HermiteLogicle_swigregister(HermiteLogicle)
+
+
+
+
+class Hlog(Transform):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.Hlog_swiginit(self, _Logicle.new_Hlog(*args))
+    __swig_destroy__ = _Logicle.delete_Hlog
+
+    def b(self) -> "double":
+        return _Logicle.Hlog_b(self)
+
+    def r(self) -> "double":
+        return _Logicle.Hlog_r(self)
+
+    def d(self) -> "double":
+        return _Logicle.Hlog_d(self)
+
+    def scale(self, *args) -> "double":
+        return _Logicle.Hlog_scale(self, *args)
+
+    def inverse(self, *args) -> "double":
+        return _Logicle.Hlog_inverse(self, *args)
+
+    def __reduce__(self):
+        return (Hlog, (self.b(), self.r(), self.d()))
+
+# Register Hlog in _Logicle:
+_Logicle.Hlog_swigregister(Hlog)
+
+class FastHlog(Hlog):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.FastHlog_swiginit(self, _Logicle.new_FastHlog(*args))
+    __swig_destroy__ = _Logicle.delete_FastHlog
+
+    def scale(self, *args) -> "double":
+        return _Logicle.FastHlog_scale(self, *args)
+
+    def inverse(self, *args) -> "double":
+        return _Logicle.FastHlog_inverse(self, *args)
+
+    def bins(self) -> "int":
+        return _Logicle.FastHlog_bins(self)
+
+    def __reduce__(self):
+        return (FastHlog, (self.b(), self.r(), self.d(), self.bins()))
+
+# Register FastHlog in _Logicle:
+_Logicle.FastHlog_swigregister(FastHlog)
+FastHlog.DEFAULT_BINS = _Logicle.cvar.FastHlog_DEFAULT_BINS
+
+class Arcsinh(Transform):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.Arcsinh_swiginit(self, _Logicle.new_Arcsinh(*args))
+    __swig_destroy__ = _Logicle.delete_Arcsinh
+
+    def cofactor(self) -> "double":
+        return _Logicle.Arcsinh_cofactor(self)
+
+    def scale(self, *args) -> "double":
+        return _Logicle.Arcsinh_scale(self, *args)
+
+    def inverse(self, *args) -> "double":
+        return _Logicle.Arcsinh_inverse(self, *args)
+
+    def __reduce__(self):
+        return (Arcsinh, (self.cofactor(),))
+
+# Register Arcsinh in _Logicle:
+_Logicle.Arcsinh_swigregister(Arcsinh)
+
+class FastArcsinh(Arcsinh):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.FastArcsinh_swiginit(self, _Logicle.new_FastArcsinh(*args))
+    __swig_destroy__ = _Logicle.delete_FastArcsinh
+
+    def scale(self, *args) -> "double":
+        return _Logicle.FastArcsinh_scale(self, *args)
+
+    def inverse(self, *args) -> "double":
+        return _Logicle.FastArcsinh_inverse(self, *args)
+
+    def T(self) -> "double":
+        return _Logicle.FastArcsinh_T(self)
+
+    def bins(self) -> "int":
+        return _Logicle.FastArcsinh_bins(self)
+
+    def __reduce__(self):
+        return (FastArcsinh, (self.cofactor(), self.T(), self.bins()))
+
+# Register FastArcsinh in _Logicle:
+_Logicle.FastArcsinh_swigregister(FastArcsinh)
+FastArcsinh.DEFAULT_BINS = _Logicle.cvar.FastArcsinh_DEFAULT_BINS
+
+class FcsData(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, path: "char const *", begin: "size_t", end: "size_t", datatype: "char", bigEndian: "bool", events: "size_t", bits: "std::vector< int > const &", range: "std::vector< double > const &"):
+        _Logicle.FcsData_swiginit(self, _Logicle.new_FcsData(path, begin, end, datatype, bigEndian, events, bits, range))
+    __swig_destroy__ = _Logicle.delete_FcsData
+
+    def events(self) -> "size_t":
+        return _Logicle.FcsData_events(self)
+
+    def parameters(self) -> "int":
+        return _Logicle.FcsData_parameters(self)
+
+    def decode(self, parameter: "int", out: "LogicleArray &") -> "void":
+        return _Logicle.FcsData_decode(self, parameter, out)
+
+    def decodeScale(self, parameter: "int", transform: "Transform", out: "LogicleArray &") -> "void":
+        return _Logicle.FcsData_decodeScale(self, parameter, transform, out)
+
+    def decodeClipScale(self, parameter: "int", logicle: "FastLogicle", out: "LogicleArray &") -> "void":
+        return _Logicle.FcsData_decodeClipScale(self, parameter, logicle, out)
+
+# Register FcsData in _Logicle:
+_Logicle.FcsData_swigregister(FcsData)
+
+
+def histogram(transform: "Transform", value: "LogicleArray const &", lo: "double", hi: "double", counts: "LogicleArray &") -> "void":
+    return _Logicle.histogram(transform, value, lo, hi, counts)
+
+def histogram2d(x: "Transform", xvalue: "LogicleArray const &", xlo: "double", xhi: "double", y: "Transform", yvalue: "LogicleArray const &", ylo: "double", yhi: "double", xbins: "int", counts: "LogicleArray &") -> "void":
+    return _Logicle.histogram2d(x, xvalue, xlo, xhi, y, yvalue, ylo, yhi, xbins, counts)
+
+class DensityGrid(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.DensityGrid_swiginit(self, _Logicle.new_DensityGrid(*args))
+
+    def cells(self) -> "int":
+        return _Logicle.DensityGrid_cells(self)
+
+    def events(self) -> "double":
+        return _Logicle.DensityGrid_events(self)
+
+    def add(self, xvalue: "LogicleArray const &", yvalue: "LogicleArray const &") -> "void":
+        return _Logicle.DensityGrid_add(self, xvalue, yvalue)
+
+    def raster(self, xlo: "double", xhi: "double", xbins: "int", ylo: "double", yhi: "double", out: "LogicleArray &") -> "void":
+        return _Logicle.DensityGrid_raster(self, xlo, xhi, xbins, ylo, yhi, out)
+    __swig_destroy__ = _Logicle.delete_DensityGrid
+
+# Register DensityGrid in _Logicle:
+_Logicle.DensityGrid_swigregister(DensityGrid)
+DensityGrid.DEFAULT_CELLS = _Logicle.cvar.DensityGrid_DEFAULT_CELLS
+
+class KernelDensity(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+    GAUSSIAN = _Logicle.KernelDensity_GAUSSIAN
+    TOPHAT = _Logicle.KernelDensity_TOPHAT
+    EPANECHNIKOV = _Logicle.KernelDensity_EPANECHNIKOV
+    EXPONENTIAL = _Logicle.KernelDensity_EXPONENTIAL
+    LINEAR = _Logicle.KernelDensity_LINEAR
+    COSINE = _Logicle.KernelDensity_COSINE
+
+    def __init__(self, *args):
+        _Logicle.KernelDensity_swiginit(self, _Logicle.new_KernelDensity(*args))
+
+    def density(self, value: "LogicleArray const &", point: "LogicleArray const &", out: "LogicleArray &") -> "void":
+        return _Logicle.KernelDensity_density(self, value, point, out)
+
+    def density2d(self, xvalue: "LogicleArray const &", yvalue: "LogicleArray const &", xpoint: "LogicleArray const &", ypoint: "LogicleArray const &", out: "LogicleArray &") -> "void":
+        return _Logicle.KernelDensity_density2d(self, xvalue, yvalue, xpoint, ypoint, out)
+    __swig_destroy__ = _Logicle.delete_KernelDensity
+
+# Register KernelDensity in _Logicle:
+_Logicle.KernelDensity_swigregister(KernelDensity)
+KernelDensity.DEFAULT_BINS = _Logicle.cvar.KernelDensity_DEFAULT_BINS
+
+class GateAxis(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, *args):
+        _Logicle.GateAxis_swiginit(self, _Logicle.new_GateAxis(*args))
+        self._transform = args[0] if args else None
+
+
+    @staticmethod
+    def clipped(logicle: "FastLogicle") -> "GateAxis":
+        val = _Logicle.GateAxis_clipped(logicle)
+        val._transform = logicle
+
+
+        return val
+
+    @staticmethod
+    def log(threshold: "double", mask: "bool") -> "GateAxis":
+        return _Logicle.GateAxis_log(threshold, mask)
+    __swig_destroy__ = _Logicle.delete_GateAxis
+
+# Register GateAxis in _Logicle:
+_Logicle.GateAxis_swigregister(GateAxis)
+
+def GateAxis_clipped(logicle: "FastLogicle") -> "GateAxis":
+    val = _Logicle.GateAxis_clipped(logicle)
+    val._transform = logicle
+
+
+    return val
+
+def GateAxis_log(threshold: "double", mask: "bool") -> "GateAxis":
+    return _Logicle.GateAxis_log(threshold, mask)
+
+class PolygonGate(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, x: "GateAxis", y: "GateAxis", xvertex: "std::vector< double > const &", yvertex: "std::vector< double > const &"):
+        _Logicle.PolygonGate_swiginit(self, _Logicle.new_PolygonGate(x, y, xvertex, yvertex))
+        self._axes = (x, y)
+
+    def contains(self, xvalue: "LogicleArray const &", yvalue: "LogicleArray const &", _in: "LogicleMask &") -> "void":
+        return _Logicle.PolygonGate_contains(self, xvalue, yvalue, _in)
+    __swig_destroy__ = _Logicle.delete_PolygonGate
+
+# Register PolygonGate in _Logicle:
+_Logicle.PolygonGate_swigregister(PolygonGate)
+
+
+def gateRange(value: "LogicleArray const &", lo: "double", hi: "double", _in: "LogicleMask &") -> "void":
+    return _Logicle.gateRange(value, lo, hi, _in)
+
+def gateRange2d(xvalue: "LogicleArray const &", yvalue: "LogicleArray const &", xlo: "double", xhi: "double", ylo: "double", yhi: "double", _in: "LogicleMask &") -> "void":
+    return _Logicle.gateRange2d(xvalue, yvalue, xlo, xhi, ylo, yhi, _in)
+
+def gateQuad(xvalue: "LogicleArray const &", yvalue: "LogicleArray const &", xthreshold: "double", ythreshold: "double", quadrant: "LogicleMask &") -> "void":
+    return _Logicle.gateQuad(xvalue, yvalue, xthreshold, ythreshold, quadrant)
+
+class ChannelStats(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def count(self) -> "size_t":
+        return _Logicle.ChannelStats_count(self)
+
+    def maximum(self) -> "double":
+        return _Logicle.ChannelStats_maximum(self)
+
+    def negatives(self) -> "size_t":
+        return _Logicle.ChannelStats_negatives(self)
+
+    def negativeQuantile(self) -> "double":
+        return _Logicle.ChannelStats_negativeQuantile(self)
+
+    def __init__(self, value: "LogicleArray const &", r: "double"):
+        _Logicle.ChannelStats_swiginit(self, _Logicle.new_ChannelStats(value, r))
+    __swig_destroy__ = _Logicle.delete_ChannelStats
+
+# Register ChannelStats in _Logicle:
+_Logicle.ChannelStats_swigregister(ChannelStats)
+
+LOGICLE_MEAN = _Logicle.LOGICLE_MEAN
+LOGICLE_MEDIAN = _Logicle.LOGICLE_MEDIAN
+LOGICLE_GEOM_MEAN = _Logicle.LOGICLE_GEOM_MEAN
+
+def bootstrapStatistic(value: "LogicleArray const &", statistic: "logicle_statistic", seed: "unsigned long long", out: "LogicleArray &") -> "void":
+    return _Logicle.bootstrapStatistic(value, statistic, seed, out)
+
+def selectPercentiles(value: "LogicleArray const &", percent: "std::vector< double > const &") -> "void":
+    return _Logicle.selectPercentiles(value, percent)
+
+
+def scaleColumns(axis: "std::vector< GateAxis > const &", _in: "LogicleArray const &", out: "LogicleArray &", fortran: "bool") -> "void":
+    return _Logicle.scaleColumns(axis, _in, out, fortran)
+
+def compensateColumns(matrix: "std::vector< double > const &", axis: "std::vector< GateAxis > const &", _in: "LogicleArray const &", out: "LogicleArray &", columns: "size_t", fortran: "bool") -> "void":
+    return _Logicle.compensateColumns(matrix, axis, _in, out, columns, fortran)
+
+class NearestCentroid(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, centroid: "std::vector< double > const &", columns: "size_t"):
+        _Logicle.NearestCentroid_swiginit(self, _Logicle.new_NearestCentroid(centroid, columns))
+
+    def clusters(self) -> "size_t":
+        return _Logicle.NearestCentroid_clusters(self)
+
+    def columns(self) -> "size_t":
+        return _Logicle.NearestCentroid_columns(self)
+
+    def assign(self, axis: "std::vector< GateAxis > const &", _in: "LogicleArray const &", fortran: "bool", cluster: "LogicleLabels &") -> "void":
+        return _Logicle.NearestCentroid_assign(self, axis, _in, fortran, cluster)
+    __swig_destroy__ = _Logicle.delete_NearestCentroid
+
+# Register NearestCentroid in _Logicle:
+_Logicle.NearestCentroid_swigregister(NearestCentroid)
+
+class GaussianMixture(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self, weight: "std::vector< double > const &", mean: "std::vector< double > const &", precisionCholesky: "std::vector< double > const &"):
+        _Logicle.GaussianMixture_swiginit(self, _Logicle.new_GaussianMixture(weight, mean, precisionCholesky))
+
+    def components(self) -> "size_t":
+        return _Logicle.GaussianMixture_components(self)
+
+    def columns(self) -> "size_t":
+        return _Logicle.GaussianMixture_columns(self)
+
+    def assign(self, axis: "std::vector< GateAxis > const &", _in: "LogicleArray const &", fortran: "bool", component: "LogicleLabels &", posterior: "LogicleArray &", distance: "LogicleArray &") -> "void":
+        return _Logicle.GaussianMixture_assign(self, axis, _in, fortran, component, posterior, distance)
+    __swig_destroy__ = _Logicle.delete_GaussianMixture
+
+# Register GaussianMixture in _Logicle:
+_Logicle.GaussianMixture_swigregister(GaussianMixture)
+
+LOGICLE_EXACT_SCALES = _Logicle.LOGICLE_EXACT_SCALES
+LOGICLE_TAYLOR_SCALES = _Logicle.LOGICLE_TAYLOR_SCALES
+LOGICLE_HALLEY_ITERATIONS = _Logicle.LOGICLE_HALLEY_ITERATIONS
+LOGICLE_TABLE_VALUES = _Logicle.LOGICLE_TABLE_VALUES
+LOGICLE_TABLE_FALLBACKS = _Logicle.LOGICLE_TABLE_FALLBACKS
+LOGICLE_TABLE_HITS = _Logicle.LOGICLE_TABLE_HITS
+LOGICLE_TABLE_BUILDS = _Logicle.LOGICLE_TABLE_BUILDS
+LOGICLE_TABLE_BINS = _Logicle.LOGICLE_TABLE_BINS
+LOGICLE_TABLE_NANOSECONDS = _Logicle.LOGICLE_TABLE_NANOSECONDS
+LOGICLE_ILLEGAL_ARGUMENTS = _Logicle.LOGICLE_ILLEGAL_ARGUMENTS
+LOGICLE_DID_NOT_CONVERGE = _Logicle.LOGICLE_DID_NOT_CONVERGE
+LOGICLE_COUNTERS = _Logicle.LOGICLE_COUNTERS
+LOGICLE_HALLEY_HISTOGRAM = _Logicle.LOGICLE_HALLEY_HISTOGRAM
+LOGICLE_TABLE_HISTOGRAM = _Logicle.LOGICLE_TABLE_HISTOGRAM
+LOGICLE_HISTOGRAMS = _Logicle.LOGICLE_HISTOGRAMS
+LOGICLE_BUCKETS = _Logicle.LOGICLE_BUCKETS
+class TransformStats(object):
+    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
+    __repr__ = _swig_repr
+
+    def __init__(self):
+        _Logicle.TransformStats_swiginit(self, _Logicle.new_TransformStats())
+
+    @staticmethod
+    def enabled() -> "bool":
+        return _Logicle.TransformStats_enabled()
+
+    @staticmethod
+    def reset() -> "void":
+        return _Logicle.TransformStats_reset()
+
+    def count(self, counter: "int") -> "unsigned long long":
+        return _Logicle.TransformStats_count(self, counter)
+
+    def histogram(self, histogram: "int") -> "void":
+        return _Logicle.TransformStats_histogram(self, histogram)
+    __swig_destroy__ = _Logicle.delete_TransformStats
+
+# Register TransformStats in _Logicle:
+_Logicle.TransformStats_swigregister(TransformStats)
+
+def TransformStats_enabled() -> "bool":
+    return _Logicle.TransformStats_enabled()
 
+def TransformStats_reset() -> "void":
+    return _Logicle.TransformStats_reset()
 
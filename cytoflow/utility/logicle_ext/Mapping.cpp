@@ -0,0 +1,85 @@
+#include "mapping.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const void * logicle_map (const char * path, size_t & length, const char * & error)
+{
+	void * mapping;
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		error = "can't open the file";
+		return 0;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		error = "the file is empty";
+		return 0;
+	}
+	length = (size_t) size.QuadPart;
+
+	// the view keeps the file open once the handles are closed
+	HANDLE view = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!view)
+	{
+		error = "can't map the file";
+		return 0;
+	}
+	mapping = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(view);
+	if (!mapping)
+	{
+		error = "can't map the file";
+		return 0;
+	}
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+	{
+		error = "can't open the file";
+		return 0;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		error = "the file is empty";
+		return 0;
+	}
+	length = (size_t) status.st_size;
+
+	mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (mapping == MAP_FAILED)
+	{
+		error = "can't map the file";
+		return 0;
+	}
+#endif
+	return mapping;
+}
+
+void logicle_unmap (const void * mapping, size_t length)
+{
+#if defined(_WIN32)
+	(void) length;
+	UnmapViewOfFile(mapping);
+#else
+	munmap(const_cast<void *>(mapping), length);
+#endif
+}
@@ -0,0 +1,240 @@
+#include "statistics.h"
+#include "threads.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+// the hth smallest of the values (h need not be a whole number), between
+// the ones either side of it the way numpy interpolates.  this reorders
+// the values.
+static double select_quantile (std::vector<double> & values, double h)
+{
+	size_t lo = (size_t) floor(h);
+	std::nth_element(values.begin(), values.begin() + lo, values.end());
+	double below = values[lo];
+	if (lo + 1 == values.size())
+		return below;
+
+	// nth_element leaves everything above lo after it
+	double above = *std::min_element(values.begin() + lo + 1, values.end());
+	double t = h - lo;
+	double diff = above - below;
+	return t >= 0.5 ? above - diff * (1 - t) : below + diff * t;
+}
+
+// splitmix64: small, fast, and good enough to resample with.  every
+// resample starts its own stream.
+namespace {
+
+class Random
+{
+public:
+	Random (unsigned long long seed, size_t stream)
+		: state(seed ^ (0x9E3779B97F4A7C15ULL * (stream + 1)))
+	{	}
+
+	unsigned long long next ()
+	{
+		unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// uniform on [0, n), without the bias of next() % n
+	size_t below (size_t n)
+	{
+		unsigned long long limit = -(unsigned long long) n % n;
+		for (;;)
+		{
+			unsigned long long x = next();
+			if (x >= limit)
+				return (size_t) (x % n);
+		}
+	}
+
+private:
+	unsigned long long state;
+};
+
+}
+
+ChannelStats::ChannelStats (const double * value, size_t n, double r)
+{
+	compute(value, n, r);
+}
+
+ChannelStats::ChannelStats (const float * value, size_t n, double r)
+{
+	compute(value, n, r);
+}
+
+template <typename T>
+void ChannelStats::compute (const T * value, size_t n, double r)
+{
+	if (!(r > 0 && r < 1))
+		throw Logicle::IllegalParameter("r is not between 0 and 1");
+
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	counted = 0;
+	largest = NaN;
+
+	// each chunk keeps its own negative values and maximum, and adds them
+	// to the totals when it's done
+	std::vector<double> negatives;
+	std::mutex mutex;
+	logicle_parallel(n, [this, value, &negatives, &mutex] (size_t begin, size_t end) {
+		std::vector<double> local;
+		size_t count = 0;
+		double top = -std::numeric_limits<double>::infinity();
+		for (size_t i = begin; i < end; ++i)
+		{
+			double x = value[i];
+			if (x != x)
+				continue;
+			++count;
+			if (x > top)
+				top = x;
+			if (x < 0)
+				local.push_back(x);
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		negatives.insert(negatives.end(), local.begin(), local.end());
+		if (count > 0 && (counted == 0 || top > largest))
+			largest = top;
+		counted += count;
+	});
+
+	negative = negatives.size();
+	quantile = NaN;
+	if (negative == 0)
+		return;
+
+	// the value at position h in the sorted values (numpy's "linear"
+	// method)
+	quantile = select_quantile(negatives, (negative - 1) * r);
+}
+
+void logicle_bootstrap (const double * value, size_t n, logicle_statistic statistic,
+	unsigned long long seed, double * out, size_t boots)
+{
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	if (n == 0)
+	{
+		for (size_t b = 0; b < boots; ++b)
+			out[b] = NaN;
+		return;
+	}
+
+	// the median draws from the sorted values, and the geometric mean from
+	// their logs, so that neither has to be worked out for every draw
+	std::vector<double> sorted, logs;
+	if (statistic == LOGICLE_MEDIAN)
+	{
+		// like numpy, there's no median of values that include NaN
+		for (size_t i = 0; i < n; ++i)
+			if (value[i] != value[i])
+			{
+				for (size_t b = 0; b < boots; ++b)
+					out[b] = NaN;
+				return;
+			}
+
+		sorted.assign(value, value + n);
+		std::sort(sorted.begin(), sorted.end());
+	}
+	else if (statistic == LOGICLE_GEOM_MEAN)
+	{
+		logs.resize(n);
+		logicle_parallel(n, [value, &logs] (size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				logs[i] = value[i] != 0 ? log(std::abs(value[i])) : 0;
+		});
+	}
+
+	logicle_parallel(boots, [=, &sorted, &logs] (size_t begin, size_t end) {
+		std::vector<unsigned> counts(statistic == LOGICLE_MEDIAN ? n : 0);
+		for (size_t b = begin; b < end; ++b)
+		{
+			Random random(seed, b);
+			switch (statistic)
+			{
+			case LOGICLE_MEAN:
+			{
+				double sum = 0;
+				for (size_t i = 0; i < n; ++i)
+					sum += value[random.below(n)];
+				out[b] = sum / n;
+				break;
+			}
+
+			case LOGICLE_MEDIAN:
+			{
+				std::fill(counts.begin(), counts.end(), 0);
+				for (size_t i = 0; i < n; ++i)
+					++counts[random.below(n)];
+
+				// walk up the sorted values to the middle ones
+				size_t lo = (n - 1) / 2, hi = n / 2, seen = 0, i = 0;
+				while (seen + counts[i] <= lo)
+					seen += counts[i++];
+				double below = sorted[i];
+				while (seen + counts[i] <= hi)
+					seen += counts[i++];
+				out[b] = (below + sorted[i]) / 2;
+				break;
+			}
+
+			case LOGICLE_GEOM_MEAN:
+			{
+				double positive = 0, negative = 0;
+				size_t positives = 0, negatives = 0;
+				for (size_t i = 0; i < n; ++i)
+				{
+					size_t j = random.below(n);
+					if (value[j] > 0)
+					{
+						positive += logs[j];
+						++positives;
+					}
+					else if (value[j] < 0)
+					{
+						negative += logs[j];
+						++negatives;
+					}
+				}
+
+				// like scipy's gmean, there's no mean of no positive values
+				double p = positives ? exp(positive / positives) : NaN;
+				double q = negatives ? exp(negative / negatives) : 0;
+				out[b] = p * ((double) positives / n) - q * ((double) negatives / n);
+				break;
+			}
+			}
+		}
+	}, n);
+}
+
+void logicle_percentiles (const double * value, size_t n,
+	const double * percent, size_t m, double * out)
+{
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	bool missing = n == 0;
+	for (size_t i = 0; i < n && !missing; ++i)
+		missing = value[i] != value[i];
+
+	std::vector<double> values;
+	if (!missing)
+		values.assign(value, value + n);
+
+	for (size_t j = 0; j < m; ++j)
+	{
+		if (missing || !(percent[j] >= 0 && percent[j] <= 100))
+			out[j] = NaN;
+		else
+			out[j] = select_quantile(values, (n - 1) * (percent[j] / 100));
+	}
+}
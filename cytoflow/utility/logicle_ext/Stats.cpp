@@ -0,0 +1,185 @@
+#include "stats.h"
+#include "logicle.h"
+#include <atomic>
+#include <mutex>
+
+// each thread's counts.  only the thread itself writes them, so adding is
+// a relaxed load and store rather than a locked read-modify-write; the
+// atomics only make it safe for a snapshot to read them at the same time.
+struct logicle_stats_block
+{
+	std::atomic<unsigned long long> counter[LOGICLE_COUNTERS];
+	std::atomic<unsigned long long> histogram[LOGICLE_HISTOGRAMS][LOGICLE_BUCKETS];
+
+	logicle_stats_block ()
+	{
+		for (int i = 0; i < LOGICLE_COUNTERS; ++i)
+			counter[i].store(0, std::memory_order_relaxed);
+		for (int h = 0; h < LOGICLE_HISTOGRAMS; ++h)
+			for (int b = 0; b < LOGICLE_BUCKETS; ++b)
+				histogram[h][b].store(0, std::memory_order_relaxed);
+	}
+
+	void addTo (logicle_stats & stats) const
+	{
+		for (int i = 0; i < LOGICLE_COUNTERS; ++i)
+			stats.counter[i] += counter[i].load(std::memory_order_relaxed);
+		for (int h = 0; h < LOGICLE_HISTOGRAMS; ++h)
+			for (int b = 0; b < LOGICLE_BUCKETS; ++b)
+				stats.histogram[h][b] += histogram[h][b].load(std::memory_order_relaxed);
+	}
+};
+
+namespace
+{
+
+void clear (logicle_stats & stats)
+{
+	for (int i = 0; i < LOGICLE_COUNTERS; ++i)
+		stats.counter[i] = 0;
+	for (int h = 0; h < LOGICLE_HISTOGRAMS; ++h)
+		for (int b = 0; b < LOGICLE_BUCKETS; ++b)
+			stats.histogram[h][b] = 0;
+}
+
+// every live thread's block, and what the threads that have finished
+// counted.  resetting can't write other threads' blocks without racing
+// them, so instead it remembers the totals at the time and snapshots
+// subtract them.
+struct Registry
+{
+	std::mutex mutex;
+	std::vector<logicle_stats_block *> blocks;
+	logicle_stats retired, zero;
+
+	Registry ()
+	{
+		clear(retired);
+		clear(zero);
+	}
+
+	void total (logicle_stats & stats)
+	{
+		stats = retired;
+		for (size_t i = 0; i < blocks.size(); ++i)
+			blocks[i]->addTo(stats);
+	}
+};
+
+Registry & registry ()
+{
+	// never destroyed, so that threads that finish during exit can still
+	// hand in their counts
+	static Registry * r = new Registry;
+	return *r;
+}
+
+struct Local
+{
+	logicle_stats_block block;
+
+	Local ()
+	{
+		Registry & r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.blocks.push_back(&block);
+	}
+
+	~Local ()
+	{
+		Registry & r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		block.addTo(r.retired);
+		for (size_t i = 0; i < r.blocks.size(); ++i)
+			if (r.blocks[i] == &block)
+			{
+				r.blocks.erase(r.blocks.begin() + i);
+				break;
+			}
+	}
+};
+
+}
+
+logicle_stats_block & logicle_stats_local ()
+{
+	static thread_local Local local;
+	return local.block;
+}
+
+void logicle_stats_add (logicle_stats_block & block, int counter, unsigned long long n)
+{
+	std::atomic<unsigned long long> & c = block.counter[counter];
+	c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void logicle_stats_bucket (logicle_stats_block & block, int histogram, int bucket)
+{
+	if (bucket < 0)
+		bucket = 0;
+	if (bucket >= LOGICLE_BUCKETS)
+		bucket = LOGICLE_BUCKETS - 1;
+	std::atomic<unsigned long long> & c = block.histogram[histogram][bucket];
+	c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+logicle_stats_timer::logicle_stats_timer (int counter, int histogram)
+	: counter(counter), histogram(histogram), start(std::chrono::steady_clock::now())
+{	}
+
+logicle_stats_timer::~logicle_stats_timer ()
+{
+	std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+	unsigned long long ns = elapsed.count() > 0 ? elapsed.count() : 0;
+
+	// log2 of the microseconds
+	int bucket = 0;
+	for (unsigned long long us = ns / 1000; us > 1; us >>= 1)
+		++bucket;
+
+	logicle_stats_block & block = logicle_stats_local();
+	logicle_stats_add(block, counter, ns);
+	logicle_stats_bucket(block, histogram, bucket);
+}
+
+TransformStats::TransformStats ()
+{
+	Registry & r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.total(stats);
+	for (int i = 0; i < LOGICLE_COUNTERS; ++i)
+		stats.counter[i] -= r.zero.counter[i];
+	for (int h = 0; h < LOGICLE_HISTOGRAMS; ++h)
+		for (int b = 0; b < LOGICLE_BUCKETS; ++b)
+			stats.histogram[h][b] -= r.zero.histogram[h][b];
+}
+
+bool TransformStats::enabled ()
+{
+#ifdef LOGICLE_STATS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void TransformStats::reset ()
+{
+	Registry & r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.total(r.zero);
+}
+
+unsigned long long TransformStats::count (int counter) const
+{
+	if (counter < 0 || counter >= LOGICLE_COUNTERS)
+		throw Logicle::IllegalParameter("no such counter");
+	return stats.counter[counter];
+}
+
+void TransformStats::histogram (int histogram, std::vector<double> & counts) const
+{
+	if (histogram < 0 || histogram >= LOGICLE_HISTOGRAMS)
+		throw Logicle::IllegalParameter("no such histogram");
+	counts.assign(stats.histogram[histogram], stats.histogram[histogram] + LOGICLE_BUCKETS);
+}
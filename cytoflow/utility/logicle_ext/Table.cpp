@@ -0,0 +1,542 @@
+#include "table.h"
+#include "mapping.h"
+#include "threads.h"
+#include "stats.h"
+#include <memory.h>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+struct logicle_table_storage
+{
+	std::atomic<long> references;
+	double * lookup;
+	int * index;
+
+	// a mapped table's arrays are in the mapping, rather than allocated
+	const void * mapping;
+	size_t length;
+	std::string file;
+
+	logicle_table_storage (int bins)
+		: references(1), lookup(new double[bins + 1]), index(0),
+		mapping(0), length(0)
+	{	}
+
+	logicle_table_storage (const void * mapping, size_t length, const char * file)
+		: references(1), lookup(0), index(0), mapping(mapping), length(length),
+		file(file)
+	{	}
+
+	~logicle_table_storage ()
+	{
+		if (mapping)
+			logicle_unmap(mapping, length);
+		else
+		{
+			delete[] index;
+			delete[] lookup;
+		}
+	}
+};
+
+void logicle_table_init (logicle_table * table)
+{
+	memset(table, 0, sizeof(logicle_table));
+}
+
+void logicle_table_create (logicle_table * table, int bins, double offset, double width)
+{
+	logicle_table_init(table);
+	table->bins = bins;
+	table->offset = offset;
+	table->width = width;
+
+	table->storage = new logicle_table_storage(bins);
+	table->lookup = table->storage->lookup;
+}
+
+void logicle_table_share (logicle_table * table, const logicle_table * from)
+{
+	*table = *from;
+	if (table->storage)
+		++table->storage->references;
+}
+
+void logicle_table_destroy (logicle_table * table)
+{
+	if (table->storage && --table->storage->references == 0)
+		delete table->storage;
+	table->storage = 0;
+	table->index = 0;
+	table->lookup = 0;
+}
+
+// the bit pattern of a positive double is monotonic in its value and its
+// high bits are a piecewise linear approximation of its logarithm, so
+// shifting off the low bits of the mantissa gives log spaced cells
+static inline int magnitudeCell (const logicle_table * table, double magnitude)
+{
+	if (magnitude < table->indexFloor)
+		return 0;
+
+	unsigned long long bits;
+	memcpy(&bits, &magnitude, sizeof(double));
+	return (int)((bits >> table->indexShift) - table->indexBase) + 1;
+}
+
+// the smallest magnitude in a cell
+static inline double magnitudeEdge (const logicle_table * table, int cell)
+{
+	if (cell == 0)
+		return 0;
+	if (cell == 1)
+		return table->indexFloor;
+
+	double edge;
+	unsigned long long bits = (table->indexBase + cell - 1) << table->indexShift;
+	memcpy(&edge, &bits, sizeof(double));
+	return edge;
+}
+
+static inline int indexCell (const logicle_table * table, double value)
+{
+	// negative cells count down from zero
+	if (value < 0)
+		return table->indexZero - 1 - magnitudeCell(table, -value);
+	else
+		return table->indexZero + magnitudeCell(table, value);
+}
+
+// the index's parameters for a table, from its lookup array
+static void indexLayout (logicle_table * table)
+{
+	const double * lookup = table->lookup;
+	const int bins = table->bins;
+
+	// the narrowest bin is near data zero; below that, use a single cell
+	table->indexFloor = lookup[1] - lookup[0];
+	for (int i = 1; i < bins; ++i)
+		if (lookup[i + 1] - lookup[i] < table->indexFloor)
+			table->indexFloor = lookup[i + 1] - lookup[i];
+
+	// at the far end of the table, a bin is some fraction of its value
+	// wide.  keep enough bits of the mantissa to make cells of about the
+	// same relative width, but no more than a few cells per bin in all
+	double top = lookup[bins];
+	double last = lookup[bins] - lookup[bins - 1];
+	if (-lookup[0] > top)
+	{
+		top = -lookup[0];
+		last = lookup[1] - lookup[0];
+	}
+
+	double octaves = 0;
+	if (lookup[bins] > table->indexFloor)
+		octaves += log(lookup[bins] / table->indexFloor) / log(2.) + 1;
+	if (-lookup[0] > table->indexFloor)
+		octaves += log(-lookup[0] / table->indexFloor) / log(2.) + 1;
+
+	int mantissa = (int) floor(log(top / last) / log(2.));
+	if (mantissa > 20)
+		mantissa = 20;
+	while (mantissa > 0 && octaves * (1 << mantissa) > 4. * bins)
+		--mantissa;
+	if (mantissa < 0)
+		mantissa = 0;
+	table->indexShift = 52 - mantissa;
+
+	unsigned long long bits;
+	memcpy(&bits, &table->indexFloor, sizeof(double));
+	table->indexBase = bits >> table->indexShift;
+
+	// enough cells to cover both ends of the table
+	table->indexZero = lookup[0] < 0 ? magnitudeCell(table, -lookup[0]) + 1 : 0;
+	table->indexCells = indexCell(table, lookup[bins]) + 1;
+}
+
+void logicle_table_index (logicle_table * table)
+{
+	const double * lookup = table->lookup;
+	const int bins = table->bins;
+	indexLayout(table);
+
+	// for each cell, the last bin that starts at or below the cell's lower
+	// edge.  then a value in a cell is between index[cell] and
+	// index[cell + 1].  for big tables this is a good part of the work,
+	// so merge the cell edges with the table a chunk of cells at a time
+	int * index = table->index = table->storage->index = new int[table->indexCells + 1];
+	logicle_parallel(table->indexCells, [table, lookup, bins, index] (size_t begin, size_t end) {
+		int bin = -1;
+		for (int cell = (int) begin; cell < (int) end; ++cell)
+		{
+			double edge;
+			if (cell < table->indexZero)
+				edge = -magnitudeEdge(table, table->indexZero - cell);
+			else
+				edge = magnitudeEdge(table, cell - table->indexZero);
+
+			if (bin < 0)
+				bin = (int) (std::upper_bound(lookup + 1, lookup + bins, edge) - lookup) - 1;
+			else
+				while (bin < bins - 1 && lookup[bin + 1] <= edge)
+					++bin;
+			index[cell] = bin;
+		}
+	});
+	index[table->indexCells] = bins - 1;
+}
+
+int logicle_table_bin (const logicle_table * table, double value)
+{
+	int lo = 0;
+	int hi = table->bins;
+
+	// in range, the index narrows the search to a few bins.  anything
+	// else (including NaN) searches the whole table
+	if (value >= table->lookup[0] && value < table->lookup[table->bins])
+	{
+		int cell = indexCell(table, value);
+		lo = table->index[cell];
+		hi = table->index[cell + 1];
+	}
+
+	// binary search for the appropriate bin
+	while (lo <= hi)
+	{
+		int mid = (lo + hi) >> 1;
+		double key = table->lookup[mid];
+		if (value < key)
+			hi = mid - 1;
+		else if (value > key)
+			lo = mid + 1;
+		else if (mid < table->bins)
+			return mid;
+		else
+			// equal to table[bins] which is for interpolation only
+			return -1;
+	}
+
+	// check for out of range
+	if (hi < 0 || lo > table->bins)
+		return -1;
+
+	return lo - 1;
+}
+
+// the cache is a list of tables, most recently used first, and a map
+// from their keys to their places in the list
+namespace
+{
+	typedef std::tuple<int, double, double, double, double, int> Key;
+
+	struct Entry
+	{
+		Key key;
+		logicle_table table;
+	};
+
+	struct Cache
+	{
+		std::mutex mutex;
+		std::list<Entry> tables;
+		std::map<Key, std::list<Entry>::iterator> index;
+		int size;
+
+		Cache () : size(32) { }
+
+		// drop the least recently used tables until there are at most
+		// size of them.  call with the lock held.
+		void trim ()
+		{
+			while ((int) tables.size() > size)
+			{
+				index.erase(tables.back().key);
+				logicle_table_destroy(&tables.back().table);
+				tables.pop_back();
+			}
+		}
+	};
+
+	Cache & cache ()
+	{
+		// never destroyed, so that transforms that outlive it (eg. in
+		// static destructors) don't care
+		static Cache * cache = new Cache;
+		return *cache;
+	}
+}
+
+void logicle_table_cached (logicle_table * table, const logicle_table_key & key,
+	double offset, double width, const std::function<void (logicle_table * table)> & fill,
+	bool indexed)
+{
+	Key k(key.transform, key.parameter[0], key.parameter[1],
+		key.parameter[2], key.parameter[3], key.bins);
+	Cache & c = cache();
+
+	{
+		std::lock_guard<std::mutex> lock(c.mutex);
+		auto found = c.index.find(k);
+		if (found != c.index.end())
+		{
+			// move it to the front of the list
+			c.tables.splice(c.tables.begin(), c.tables, found->second);
+			logicle_table_share(table, &found->second->table);
+			LOGICLE_COUNT(LOGICLE_TABLE_HITS, 1);
+			return;
+		}
+	}
+
+	// build it without holding the lock, so that building one table
+	// doesn't hold up threads that want another one
+	logicle_table_create(table, key.bins, offset, width);
+	try
+	{
+		LOGICLE_TIME(LOGICLE_TABLE_NANOSECONDS, LOGICLE_TABLE_HISTOGRAM);
+		fill(table);
+		if (indexed)
+			logicle_table_index(table);
+	}
+	catch (...)
+	{
+		logicle_table_destroy(table);
+		throw;
+	}
+
+	LOGICLE_COUNT(LOGICLE_TABLE_BUILDS, 1);
+	LOGICLE_COUNT(LOGICLE_TABLE_BINS, key.bins);
+
+	std::lock_guard<std::mutex> lock(c.mutex);
+	if (c.size <= 0 || c.index.count(k))
+		// someone else built it first, which is fine; the tables are
+		// identical
+		return;
+
+	Entry entry;
+	entry.key = k;
+	logicle_table_share(&entry.table, table);
+	c.tables.push_front(entry);
+	c.index[k] = c.tables.begin();
+	c.trim();
+}
+
+int logicle_table_cache_size ()
+{
+	Cache & c = cache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	return c.size;
+}
+
+void logicle_table_set_cache_size (int size)
+{
+	Cache & c = cache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	c.size = size < 0 ? 0 : size;
+	c.trim();
+}
+
+int logicle_table_cache_count ()
+{
+	Cache & c = cache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	return (int) c.tables.size();
+}
+
+// a saved table is this header, then the lookup array and then the index,
+// each starting on a cache line.  everything is in the byte order of the
+// machine that saved it, which is checked when it's mapped.
+namespace
+{
+	const char MAGIC[8] = { 'L', 'O', 'G', 'I', 'C', 'L', 'E', 'T' };
+	const int VERSION = 1;
+	const int ORDER = 0x01020304;
+	const size_t ALIGNMENT = 64;
+
+	struct Header
+	{
+		char magic[8];
+		int version, order;
+		int sizes;
+
+		int transform;
+		double parameter[4];
+		int bins;
+		double offset, width;
+
+		int indexCells, indexZero, indexShift;
+		unsigned long long indexBase;
+		double indexFloor;
+	};
+
+	// the sizes of the types in the file, which have to match
+	const int SIZES = (int) (sizeof(double) << 8 | sizeof(int));
+
+	size_t aligned (size_t n)
+	{
+		return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+
+	// where the arrays go, and how long the file is
+	void layout (int bins, int indexCells, size_t & lookup, size_t & index, size_t & length)
+	{
+		lookup = aligned(sizeof(Header));
+		index = aligned(lookup + (bins + 1) * sizeof(double));
+		length = index + (indexCells + 1) * sizeof(int);
+	}
+}
+
+const char * logicle_table_save (const logicle_table * table,
+	const logicle_table_key & key, const char * path)
+{
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.order = ORDER;
+	header.sizes = SIZES;
+	header.transform = key.transform;
+	for (int i = 0; i < 4; ++i)
+		header.parameter[i] = key.parameter[i];
+	header.bins = table->bins;
+	header.offset = table->offset;
+	header.width = table->width;
+	header.indexCells = table->indexCells;
+	header.indexZero = table->indexZero;
+	header.indexShift = table->indexShift;
+	header.indexBase = table->indexBase;
+	header.indexFloor = table->indexFloor;
+
+	size_t lookup, index, length;
+	layout(table->bins, table->indexCells, lookup, index, length);
+
+	FILE * file = fopen(path, "wb");
+	if (!file)
+		return "can't create the table file";
+
+	static const char padding[ALIGNMENT] = { 0 };
+	bool ok = fwrite(&header, sizeof(Header), 1, file) == 1
+		&& fwrite(padding, 1, lookup - sizeof(Header), file) == lookup - sizeof(Header)
+		&& fwrite(table->lookup, sizeof(double), table->bins + 1, file) == (size_t) table->bins + 1
+		&& fwrite(padding, 1, index - lookup - (table->bins + 1) * sizeof(double), file)
+			== index - lookup - (table->bins + 1) * sizeof(double)
+		&& fwrite(table->index, sizeof(int), table->indexCells + 1, file) == (size_t) table->indexCells + 1;
+	if (fclose(file) != 0)
+		ok = false;
+
+	if (!ok)
+	{
+		remove(path);
+		return "can't write the table file";
+	}
+	return 0;
+}
+
+const char * logicle_table_map (logicle_table * table,
+	logicle_table_key & key, const char * path)
+{
+	logicle_table_init(table);
+
+	const char * error = 0;
+	size_t length;
+	const void * mapping = logicle_map(path, length, error);
+	if (!mapping)
+		return error;
+
+	// check that it's a table (of the right size) that we can read
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	if (length >= sizeof(Header))
+		memcpy(&header, mapping, sizeof(Header));
+	if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+		error = "not a lookup table file";
+	else if (header.version != VERSION || header.order != ORDER || header.sizes != SIZES)
+		error = "the table file is from another version or platform";
+	else if (header.bins < 1 || header.indexCells < 1 || header.bins > (1 << 28)
+		|| header.indexCells > (1 << 28))
+		error = "the table file is corrupt";
+
+	size_t lookup = 0, index = 0, expected = 0;
+	if (!error)
+	{
+		layout(header.bins, header.indexCells, lookup, index, expected);
+		if (length != expected)
+			error = "the table file is corrupt";
+	}
+
+	if (error)
+	{
+		logicle_unmap(mapping, length);
+		return error;
+	}
+
+	key.transform = header.transform;
+	for (int i = 0; i < 4; ++i)
+		key.parameter[i] = header.parameter[i];
+	key.bins = header.bins;
+
+	table->bins = header.bins;
+	table->offset = header.offset;
+	table->width = header.width;
+	table->indexCells = header.indexCells;
+	table->indexZero = header.indexZero;
+	table->indexShift = header.indexShift;
+	table->indexBase = header.indexBase;
+	table->indexFloor = header.indexFloor;
+
+	// logicle_table_bin trusts the index to keep its search inside the
+	// table, and a file of the right length can still be corrupt, so check
+	// the lookup array is increasing, that the index's parameters are the
+	// ones it would have, and that its cells are all bins of the table
+	const double * values = (const double *) ((const char *) mapping + lookup);
+	const int * cells = (const int *) ((const char *) mapping + index);
+	for (int i = 0; i <= table->bins && !error; ++i)
+		if (!std::isfinite(values[i]) || (i > 0 && !(values[i] > values[i - 1])))
+			error = "the table file is corrupt";
+
+	if (!error)
+	{
+		logicle_table check;
+		logicle_table_init(&check);
+		check.lookup = const_cast<double *>(values);
+		check.bins = table->bins;
+		indexLayout(&check);
+		if (check.indexCells != table->indexCells || check.indexZero != table->indexZero
+			|| check.indexShift != table->indexShift || check.indexBase != table->indexBase
+			|| check.indexFloor != table->indexFloor)
+			error = "the table file is corrupt";
+	}
+
+	for (int cell = 0; cell <= table->indexCells && !error; ++cell)
+		if (cells[cell] < 0 || cells[cell] >= table->bins
+			|| (cell > 0 && cells[cell] < cells[cell - 1]))
+			error = "the table file is corrupt";
+	if (!error && cells[table->indexCells] != table->bins - 1)
+		error = "the table file is corrupt";
+
+	if (error)
+	{
+		logicle_unmap(mapping, length);
+		logicle_table_init(table);
+		return error;
+	}
+
+	// the pages are read only, but then tables never change anyway
+	table->storage = new logicle_table_storage(mapping, length, path);
+	table->lookup = const_cast<double *>(values);
+	table->index = const_cast<int *>(cells);
+	return 0;
+}
+
+const char * logicle_table_file (const logicle_table * table)
+{
+	if (!table->storage || !table->storage->mapping)
+		return 0;
+	return table->storage->file.c_str();
+}
@@ -0,0 +1,228 @@
+#include "threads.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// one call to logicle_parallel
+struct Job
+{
+	const std::function<void (size_t, size_t)> * f;
+	size_t n, chunk, chunks;
+
+	std::atomic<size_t> next;
+
+	std::mutex mutex;
+	std::exception_ptr error;
+	size_t errorChunk;
+
+	// run chunks until they run out
+	void work ()
+	{
+		for (size_t c = next++; c < chunks; c = next++)
+		{
+			size_t begin = c * chunk;
+			size_t end = std::min(n, begin + chunk);
+			try
+			{
+				(*f)(begin, end);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!error || c < errorChunk)
+				{
+					error = std::current_exception();
+					errorChunk = c;
+				}
+			}
+		}
+	}
+};
+
+// set on the threads running a job, so a nested logicle_parallel runs
+// serially
+thread_local bool worker = false;
+
+class Pool
+{
+public:
+	Pool (int threads) : job(NULL), generation(0), active(0), stop(false)
+	{
+		for (int i = 0; i < threads - 1; ++i)
+			workers.push_back(std::thread(&Pool::wait, this));
+	}
+
+	~Pool ()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		wake.notify_all();
+		for (size_t i = 0; i < workers.size(); ++i)
+			workers[i].join();
+	}
+
+	int threads () const
+	{
+		return (int) workers.size() + 1;
+	}
+
+	// returns false if the pool is already busy
+	bool run (Job & j)
+	{
+		std::unique_lock<std::mutex> busy(running, std::try_to_lock);
+		if (!busy.owns_lock())
+			return false;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &j;
+			++generation;
+			active = (int) workers.size();
+		}
+		wake.notify_all();
+
+		worker = true;
+		j.work();
+		worker = false;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [this] { return active == 0; });
+		job = NULL;
+		return true;
+	}
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex running;
+	std::mutex mutex;
+	std::condition_variable wake, finished;
+	Job * job;
+	unsigned long generation;
+	int active;
+	bool stop;
+
+	void wait ()
+	{
+		worker = true;
+		unsigned long seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			wake.wait(lock, [&] { return stop || generation != seen; });
+			if (stop)
+				return;
+			seen = generation;
+
+			Job * j = job;
+			lock.unlock();
+			j->work();
+			lock.lock();
+
+			if (--active == 0)
+				finished.notify_all();
+		}
+	}
+
+	Pool (const Pool &);
+	Pool & operator= (const Pool &);
+};
+
+std::mutex poolMutex;
+std::shared_ptr<Pool> pool;
+int requested = 0;
+#if !defined(_WIN32)
+pid_t owner = 0;
+#endif
+
+int defaultThreads ()
+{
+	int threads = (int) std::thread::hardware_concurrency();
+	return threads > 0 ? threads : 1;
+}
+
+// the pool, (re)started as needed
+std::shared_ptr<Pool> getPool ()
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+#if !defined(_WIN32)
+	// after a fork the pool's threads are gone.  leak it rather than
+	// joining threads that don't exist.
+	if (pool && owner != getpid())
+		new std::shared_ptr<Pool>(std::move(pool));
+	owner = getpid();
+#endif
+
+	int threads = requested > 0 ? requested : defaultThreads();
+	if (!pool || pool->threads() != threads)
+		pool = std::make_shared<Pool>(threads);
+	return pool;
+}
+
+}
+
+void logicle_parallel (size_t n, const std::function<void (size_t begin, size_t end)> & f,
+	size_t cost)
+{
+	// the work, in values, without overflowing
+	size_t work = cost > 1 && n > SIZE_MAX / cost ? SIZE_MAX : n * (cost ? cost : 1);
+
+	size_t threads = (size_t) logicle_threads();
+	if (worker || threads < 2 || n < 2 || work < 2 * LOGICLE_PARALLEL_MINIMUM)
+	{
+		f(0, n);
+		return;
+	}
+
+	threads = std::min(threads, std::min(n, work / LOGICLE_PARALLEL_MINIMUM));
+
+	// a few chunks per thread evens out the load.  keep the boundaries
+	// of arrays of values on cache lines, too.
+	Job job;
+	job.f = &f;
+	job.n = n;
+	job.chunk = (n + 4 * threads - 1) / (4 * threads);
+	if (cost <= 1)
+		job.chunk = (job.chunk + 7) & ~(size_t) 7;
+	job.chunks = (n + job.chunk - 1) / job.chunk;
+	job.next = 0;
+	job.errorChunk = 0;
+
+	std::shared_ptr<Pool> p = getPool();
+	if (!p->run(job))
+	{
+		f(0, n);
+		return;
+	}
+
+	if (job.error)
+		std::rethrow_exception(job.error);
+}
+
+int logicle_threads ()
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return requested > 0 ? requested : defaultThreads();
+}
+
+void logicle_set_threads (int threads)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	requested = threads > 0 ? threads : 0;
+}
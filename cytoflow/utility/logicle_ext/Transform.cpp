@@ -0,0 +1,97 @@
+#include "transform.h"
+#include "table.h"
+#include "kernels.h"
+#include "threads.h"
+#include "stats.h"
+
+const size_t Transform::FLOAT_BLOCK = 1024;
+
+Transform::~Transform ()
+{	}
+
+void Transform::scale (const double * value, double * scale, size_t n) const
+{
+	logicle_parallel(n, [this, value, scale] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			scale[i] = this->scale(value[i]);
+	});
+}
+
+void Transform::inverse (const double * scale, double * value, size_t n) const
+{
+	logicle_parallel(n, [this, scale, value] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			value[i] = this->inverse(scale[i]);
+	});
+}
+
+void Transform::scale (const float * value, float * scale, size_t n) const
+{
+	inDouble(value, scale, n, [this] (double * block, size_t m) {
+		this->scale(block, block, m);
+	});
+}
+
+void Transform::inverse (const float * scale, float * value, size_t n) const
+{
+	inDouble(scale, value, n, [this] (double * block, size_t m) {
+		this->inverse(block, block, m);
+	});
+}
+
+void Transform::inDouble (const float * in, float * out, size_t n,
+	const std::function<void (double * block, size_t m)> & f)
+{
+	logicle_parallel(n, [in, out, &f] (size_t begin, size_t end) {
+		// small enough to stay in the cache.  the batch transforms that
+		// f calls run serially here, since we're already in parallel
+		double block[FLOAT_BLOCK];
+		for (size_t i = begin; i < end; i += FLOAT_BLOCK)
+		{
+			size_t m = end - i < FLOAT_BLOCK ? end - i : FLOAT_BLOCK;
+			for (size_t j = 0; j < m; ++j)
+				block[j] = in[i + j];
+			f(block, m);
+			for (size_t j = 0; j < m; ++j)
+				out[i + j] = (float) block[j];
+		}
+	});
+}
+
+void Transform::tableScale (const logicle_table * table,
+	const double * value, double * scale, size_t n) const
+{
+	const logicle_kernels & kernels = logicle_kernels_active();
+	LOGICLE_COUNT(LOGICLE_TABLE_VALUES, n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		// the kernel stops short at values outside the table, which
+		// the scalar code handles (or throws on)
+		if (kernels.fastScale)
+		{
+			i += kernels.fastScale(table, value + i, scale + i, n - i);
+			if (i == n)
+				break;
+		}
+		LOGICLE_COUNT(LOGICLE_TABLE_FALLBACKS, 1);
+		scale[i] = this->scale(value[i]);
+	}
+}
+
+void Transform::tableInverse (const logicle_table * table,
+	const double * scale, double * value, size_t n) const
+{
+	const logicle_kernels & kernels = logicle_kernels_active();
+	LOGICLE_COUNT(LOGICLE_TABLE_VALUES, n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (kernels.fastInverse)
+		{
+			i += kernels.fastInverse(table, scale + i, value + i, n - i);
+			if (i == n)
+				break;
+		}
+		LOGICLE_COUNT(LOGICLE_TABLE_FALLBACKS, 1);
+		value[i] = this->inverse(scale[i]);
+	}
+}
@@ -0,0 +1,76 @@
+// The arcsinh transform with a cofactor, as it's usually applied to mass
+// cytometry (and, with a larger cofactor, fluorescence) data:
+//
+//     y = asinh(x / cofactor)
+//
+// which is linear for |x| much less than the cofactor and logarithmic for
+// |x| much greater.  It's the biexponential with equal exponents, ie. a
+// logicle with W = 0, but parameterized the way it's usually used.
+// Arcsinh computes it directly; FastArcsinh interpolates a lookup table
+// over data [-T, T] (falling back on Arcsinh outside it), like FastHlog.
+
+#ifndef ARCSINH_H
+#define ARCSINH_H
+
+#include "logicle.h"
+
+struct arcsinh_params
+{
+	double cofactor;
+
+	// FastArcsinh's lookup table, over data [-T, T]
+	double T;
+	struct logicle_table table;
+};
+
+class Arcsinh : public Transform
+{
+public:
+	Arcsinh (double cofactor);
+	Arcsinh (const Arcsinh & arcsinh);
+
+	virtual ~Arcsinh ();
+
+	inline double cofactor () const { return p->cofactor; };
+
+	virtual double scale (double value) const;
+	virtual double inverse (double scale) const;
+
+	virtual void scale (const double * value, double * scale, size_t n) const;
+	virtual void inverse (const double * scale, double * value, size_t n) const;
+	using Transform::scale;
+	using Transform::inverse;
+
+protected:
+	arcsinh_params * p;
+
+private:
+	Arcsinh & operator= (const Arcsinh & arcsinh);
+};
+
+class FastArcsinh : public Arcsinh
+{
+public:
+	static const int DEFAULT_BINS;
+
+	FastArcsinh (double cofactor, double T, int bins = DEFAULT_BINS);
+	FastArcsinh (const FastArcsinh & arcsinh);
+
+	virtual ~FastArcsinh ();
+
+	virtual double scale (double value) const;
+	virtual double inverse (double scale) const;
+
+	virtual void scale (const double * value, double * scale, size_t n) const;
+	virtual void inverse (const double * scale, double * value, size_t n) const;
+	using Arcsinh::scale;
+	using Arcsinh::inverse;
+
+	inline double T () const { return p->T; };
+	inline int bins () const { return p->table.bins; };
+
+private:
+	FastArcsinh & operator= (const FastArcsinh & arcsinh);
+};
+
+#endif
@@ -0,0 +1,466 @@
+// Microbenchmarks for the Logicle extension.  This isn't part of the Python
+// build; compile it by hand in this directory with something like
+//
+//     g++ -O2 -ffp-contract=off -pthread -o benchmark *.cpp
+//
+// and run ./benchmark.  Each test reports its throughput in millions of
+// values per second (or table bins per second, for building tables) and,
+// for the fast transforms, the largest error against the exact one.  The
+// data come from fixed seeds, so runs on the same machine are comparable:
+//
+//     ./benchmark --save baseline.tsv
+//     (rebuild)
+//     ./benchmark --compare baseline.tsv
+//
+// prints each result against the baseline's, and exits with status 1 if
+// any of them is more than --tolerance (default 0.2, ie. 20%) slower, or
+// any error is larger than the baseline's.  --events sets how many values
+// each test transforms (default 2^20).
+
+#include "logicle.h"
+#include "hlog.h"
+#include "arcsinh.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// FastLogicle is friends with TestLogicle, which lets us get at the lookup
+// table to compare against a plain binary search
+class TestLogicle
+{
+public:
+	static int searchScale (const FastLogicle & logicle, double value)
+	{
+		const logicle_table * p = &logicle.p->table;
+		int lo = 0;
+		int hi = p->bins;
+		while (lo <= hi)
+		{
+			int mid = (lo + hi) >> 1;
+			double key = p->lookup[mid];
+			if (value < key)
+				hi = mid - 1;
+			else if (value > key)
+				lo = mid + 1;
+			else
+				return mid;
+		}
+		return lo - 1;
+	}
+
+	static int indexCells (const FastLogicle & logicle)
+	{
+		return logicle.p->table.indexCells;
+	}
+};
+
+template <typename F>
+static double eventsPerSecond (size_t n, F f)
+{
+	// best of a few runs
+	double best = 0;
+	for (int run = 0; run < 5; ++run)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (run == 0 || elapsed.count() < best)
+			best = elapsed.count();
+	}
+	return n / best;
+}
+
+// the largest difference between two arrays.  for data values (relative
+// set) it's relative to the exact value, or absolute below 1.
+static double maxError (const std::vector<double> & x, const std::vector<double> & exact,
+	bool relative)
+{
+	double error = 0;
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		double e = std::abs(x[i] - exact[i]);
+		if (relative && std::abs(exact[i]) > 1)
+			e /= std::abs(exact[i]);
+		if (e > error || e != e)
+			error = e;
+	}
+	return error;
+}
+
+// the test data.  all of them stay within the range a table covers.
+enum Distribution { DISPLAY, CELLS, LINEAR };
+static const char * const DISTRIBUTION[] = { "display", "cells", "linear" };
+
+static std::vector<double> distribution (Distribution kind, const Transform & exact,
+	double lo, double hi, size_t n)
+{
+	std::mt19937_64 rng(42 + kind);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	std::normal_distribution<double> normal(0, 1);
+	std::vector<double> data(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		double x;
+		switch (kind)
+		{
+		case DISPLAY:
+			// uniformly distributed on the display
+			x = exact.inverse(uniform(rng));
+			break;
+		case CELLS:
+			// roughly what a compensated channel looks like:  a third of
+			// the events unstained, spread either side of zero, and the
+			// rest log-normal a couple of decades up
+			x = uniform(rng) < 1. / 3 ? 50 * normal(rng)
+				: std::pow(10, 3 + 0.5 * normal(rng));
+			break;
+		default:
+			// all in the linear region around zero
+			x = 100 * (2 * uniform(rng) - 1);
+			break;
+		}
+		data[i] = x < lo ? lo : x > hi ? hi : x;
+	}
+	return data;
+}
+
+struct Result
+{
+	std::string name;
+	double eventsPerSecond;
+	double error;
+};
+
+static std::vector<Result> results;
+
+static void report (const std::string & name, double eventsPerSecond, double error = -1)
+{
+	Result result = { name, eventsPerSecond, error };
+	results.push_back(result);
+
+	if (error < 0)
+		std::printf("%-40s %12.2f\n", name.c_str(), eventsPerSecond / 1e6);
+	else
+		std::printf("%-40s %12.2f %12.3g\n", name.c_str(), eventsPerSecond / 1e6, error);
+}
+
+static std::string label (const char * transform, const char * test, int bins, const char * data)
+{
+	char buffer[128];
+	if (bins)
+		std::snprintf(buffer, sizeof(buffer), "%s.%s/%d/%s", transform, test, bins, data);
+	else
+		std::snprintf(buffer, sizeof(buffer), "%s.%s/%s", transform, test, data);
+	return buffer;
+}
+
+// scale and inverse for any transform, with their errors against exact
+static void transform (const char * name, int bins, const Transform & fast,
+	const Transform & exact, double lo, double hi, size_t n)
+{
+	std::vector<double> out(n), truth(n);
+	for (int d = DISPLAY; d <= LINEAR; ++d)
+	{
+		std::vector<double> data = distribution((Distribution) d, exact, lo, hi, n);
+		exact.scale(&data[0], &truth[0], n);
+		fast.scale(&data[0], &out[0], n);
+		double error = maxError(out, truth, false);
+		double speed = eventsPerSecond(n, [&] {
+			fast.scale(&data[0], &out[0], n);
+		});
+		report(label(name, "scale", bins, DISTRIBUTION[d]), speed, &fast == &exact ? -1 : error);
+	}
+
+	// and back, from scale values spread over the display
+	std::mt19937_64 rng(7);
+	std::uniform_real_distribution<double> uniform(exact.scale(lo), exact.scale(hi));
+	std::vector<double> scale(n);
+	for (size_t i = 0; i < n; ++i)
+		scale[i] = uniform(rng);
+	exact.inverse(&scale[0], &truth[0], n);
+	fast.inverse(&scale[0], &out[0], n);
+	double error = maxError(out, truth, true);
+	double speed = eventsPerSecond(n, [&] {
+		fast.inverse(&scale[0], &out[0], n);
+	});
+	report(label(name, "inverse", bins, "display"), speed, &fast == &exact ? -1 : error);
+}
+
+static void logicle (size_t n)
+{
+	const double T = 262144, W = 0.5, M = 4.5, A = 0;
+	const int bins[] = { 1 << 8, 1 << 10, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20 };
+
+	// a little way inside the display, so that the data are within the
+	// tables whatever the bins (which move A slightly)
+	Logicle exact(T, W, M, A);
+	const double lo = exact.inverse(0.01), hi = exact.inverse(0.99);
+
+	std::printf("\n%-40s %12s %12s\n", "transform", "Mevents/s", "max error");
+	transform("Logicle", 0, exact, exact, lo, hi, n);
+
+	for (size_t b = 0; b < sizeof(bins) / sizeof(bins[0]); ++b)
+	{
+		FastLogicle fast(T, W, M, A, bins[b]);
+		HermiteLogicle hermite(T, W, M, A, bins[b]);
+		// fitting zero to a bin boundary moves A a little, so compare
+		// each table against the exact transform with its own parameters
+		transform("FastLogicle", bins[b], fast, Logicle(fast), lo, hi, n);
+		transform("HermiteLogicle", bins[b], hermite, Logicle(hermite), lo, hi, n);
+
+		// looking up the bin, against a plain binary search of the table
+		std::vector<double> data = distribution(CELLS, exact, lo, hi, n);
+		for (size_t i = 0; i < n; ++i)
+			if (fast.intScale(data[i]) != TestLogicle::searchScale(fast, data[i]))
+			{
+				std::printf("mismatch at %.17g\n", data[i]);
+				std::exit(1);
+			}
+
+		volatile int sink = 0;
+		double search = eventsPerSecond(n, [&] {
+			int sum = 0;
+			for (size_t i = 0; i < n; ++i)
+				sum += TestLogicle::searchScale(fast, data[i]);
+			sink = sum;
+		});
+		double index = eventsPerSecond(n, [&] {
+			int sum = 0;
+			for (size_t i = 0; i < n; ++i)
+				sum += fast.intScale(data[i]);
+			sink = sum;
+		});
+		std::vector<int> bin(n);
+		double batch = eventsPerSecond(n, [&] {
+			fast.intScale(&data[0], &bin[0], n);
+		});
+		(void) sink;
+
+		report(label("FastLogicle", "search", bins[b], "cells"), search);
+		report(label("FastLogicle", "intScale", bins[b], "cells"), index);
+		report(label("FastLogicle", "intScales", bins[b], "cells"), batch);
+		std::printf("%40s %d index cells, %.1fx the search\n", "",
+			TestLogicle::indexCells(fast), index / search);
+	}
+
+	// building the tables, per bin.  with the cache off, so this measures
+	// building them rather than finding them
+	const int cacheSize = Logicle::tableCacheSize();
+	Logicle::setTableCacheSize(0);
+
+	std::printf("\n%-40s %12s\n", "initialize", "Mbins/s");
+
+	for (size_t b = 0; b < sizeof(bins) / sizeof(bins[0]); ++b)
+	{
+		double build = eventsPerSecond(bins[b], [&] {
+			FastLogicle logicle(T, W, M, A, bins[b]);
+		});
+		double hermite = eventsPerSecond(bins[b], [&] {
+			HermiteLogicle logicle(T, W, M, A, bins[b]);
+		});
+
+		report(label("FastLogicle", "initialize", bins[b], "table"), build);
+		report(label("HermiteLogicle", "initialize", bins[b], "table"), hermite);
+	}
+
+	Logicle::setTableCacheSize(cacheSize);
+}
+
+static void others (size_t n)
+{
+	std::printf("\n%-40s %12s %12s\n", "transform", "Mevents/s", "max error");
+
+	// the defaults cytoflow's scales use, on an 18 bit range
+	const double T = 262144;
+	Hlog hlog(200, 1, std::log10(T));
+	FastHlog fastHlog(200, 1, std::log10(T));
+	transform("Hlog", 0, hlog, hlog, -T, T, n);
+	transform("FastHlog", fastHlog.bins(), fastHlog, hlog, -T, T, n);
+
+	Arcsinh arcsinh(150);
+	FastArcsinh fastArcsinh(150, T);
+	transform("Arcsinh", 0, arcsinh, arcsinh, -T, T, n);
+	transform("FastArcsinh", fastArcsinh.bins(), fastArcsinh, arcsinh, -T, T, n);
+}
+
+static void simd (size_t n)
+{
+	// the batch kernels for each instruction set
+	const char * simd[] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+	const char * best = Logicle::simd();
+
+	FastLogicle logicle(262144, 0.5);
+	std::vector<double> data = distribution(DISPLAY, logicle, 0, 262144, n);
+	std::vector<double> scale(n);
+	std::vector<double> out(n);
+	logicle.scale(&data[0], &scale[0], n);
+
+	std::printf("\n%-40s %12s\n", "simd", "Mevents/s");
+
+	for (size_t s = 0; s < sizeof(simd) / sizeof(simd[0]); ++s)
+	{
+		if (!Logicle::setSimd(simd[s]))
+			continue;
+
+		report(label("Logicle", "inverse", 0, simd[s]), eventsPerSecond(n, [&] {
+			logicle.Logicle::inverse(&scale[0], &out[0], n);
+		}));
+		report(label("FastLogicle", "scale", 0, simd[s]), eventsPerSecond(n, [&] {
+			logicle.scale(&data[0], &out[0], n);
+		}));
+		report(label("FastLogicle", "inverse", 0, simd[s]), eventsPerSecond(n, [&] {
+			logicle.inverse(&scale[0], &out[0], n);
+		}));
+	}
+
+	Logicle::setSimd(best);
+
+	// and on more than one thread, with a bigger array
+	const int threads[] = { 1, 2, 4, 8, 16, 32 };
+	const size_t big = n * 16;
+	data.resize(big);
+	for (size_t i = n; i < big; ++i)
+		data[i] = data[i % n];
+	scale.resize(big);
+	out.resize(big);
+	logicle.scale(&data[0], &scale[0], big);
+
+	std::printf("\n%-40s %12s\n", "threads", "Mevents/s");
+
+	for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+	{
+		Logicle::setThreads(threads[t]);
+
+		char count[16];
+		std::snprintf(count, sizeof(count), "%d", threads[t]);
+		report(label("Logicle", "inverse", 0, count), eventsPerSecond(big, [&] {
+			logicle.Logicle::inverse(&scale[0], &out[0], big);
+		}));
+		report(label("FastLogicle", "scale", 0, count), eventsPerSecond(big, [&] {
+			logicle.scale(&data[0], &out[0], big);
+		}));
+		report(label("FastLogicle", "inverse", 0, count), eventsPerSecond(big, [&] {
+			logicle.inverse(&scale[0], &out[0], big);
+		}));
+	}
+
+	Logicle::setThreads(0);
+}
+
+static bool save (const char * path)
+{
+	FILE * file = std::fopen(path, "w");
+	if (!file)
+		return false;
+	for (size_t i = 0; i < results.size(); ++i)
+		std::fprintf(file, "%s\t%.6g\t%.6g\n", results[i].name.c_str(),
+			results[i].eventsPerSecond, results[i].error);
+	return std::fclose(file) == 0;
+}
+
+// compare against a saved baseline.  returns how many results regressed,
+// or -1 if the baseline can't be read.
+static int compare (const char * path, double tolerance)
+{
+	FILE * file = std::fopen(path, "r");
+	if (!file)
+		return -1;
+
+	std::map<std::string, Result> baseline;
+	char name[128];
+	Result result;
+	while (std::fscanf(file, "%127s %lg %lg", name, &result.eventsPerSecond, &result.error) == 3)
+		baseline[result.name = name] = result;
+	std::fclose(file);
+
+	std::printf("\n%-40s %12s %12s\n", "against baseline", "speed", "error");
+
+	int regressed = 0;
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		std::map<std::string, Result>::const_iterator old = baseline.find(results[i].name);
+		if (old == baseline.end())
+			continue;
+
+		double speed = results[i].eventsPerSecond / old->second.eventsPerSecond;
+		// errors are deterministic, so any growth beyond rounding counts
+		bool slower = speed < 1 - tolerance;
+		bool worse = old->second.error >= 0
+			&& results[i].error > old->second.error * (1 + 1e-6);
+		if (slower || worse)
+			++regressed;
+
+		if (results[i].error < 0)
+			std::printf("%-40s %11.2fx %12s%s\n", results[i].name.c_str(), speed,
+				"", slower ? "  REGRESSED" : "");
+		else
+			std::printf("%-40s %11.2fx %12.3g%s\n", results[i].name.c_str(), speed,
+				results[i].error, slower || worse ? "  REGRESSED" : "");
+	}
+
+	return regressed;
+}
+
+int main (int argc, char * argv[])
+{
+	std::setvbuf(stdout, 0, _IONBF, 0);
+	size_t n = 1 << 20;
+	double tolerance = 0.2;
+	const char * savePath = 0;
+	const char * comparePath = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--events") && i + 1 < argc)
+			n = std::strtoul(argv[++i], 0, 10);
+		else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc)
+			tolerance = std::strtod(argv[++i], 0);
+		else if (!std::strcmp(argv[i], "--save") && i + 1 < argc)
+			savePath = argv[++i];
+		else if (!std::strcmp(argv[i], "--compare") && i + 1 < argc)
+			comparePath = argv[++i];
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--events n] [--save file] "
+				"[--compare file] [--tolerance fraction]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (n == 0)
+		n = 1;
+
+	logicle(n);
+	others(n);
+	simd(n);
+
+	if (savePath && !save(savePath))
+	{
+		std::fprintf(stderr, "can't save %s\n", savePath);
+		return 2;
+	}
+
+	if (comparePath)
+	{
+		int regressed = compare(comparePath, tolerance);
+		if (regressed < 0)
+		{
+			std::fprintf(stderr, "can't read %s\n", comparePath);
+			return 2;
+		}
+		if (regressed)
+		{
+			std::printf("\n%d results regressed\n", regressed);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Assigning events to fitted clusters, natively.
+//
+// The clustering operations fit their models (with sklearn) on a sample
+// of each group's events, and then assign all of them.  These do the
+// assignment in one pass on the thread pool, straight from the events'
+// data values: each thread reads a block of events at a time onto the
+// stack, puts each channel on its scale there (see columns.h), and works
+// out the assignments a component at a time, in loops down the block's
+// columns that vectorize.  Neither the scaled events nor anything else
+// per event is kept but the results.
+//
+// An event with any channel NaN on its scale isn't assigned.
+
+#ifndef CLUSTERS_H
+#define CLUSTERS_H
+
+#include "gate.h"
+#include <vector>
+
+// k-means: each event goes to the nearest of the centroids
+class NearestCentroid
+{
+public:
+	// the centroids, a row of columns values for each, in C order (like
+	// sklearn's cluster_centers_)
+	NearestCentroid (const std::vector<double> & centroid, size_t columns);
+
+	inline size_t clusters () const { return k; };
+	inline size_t columns () const { return d; };
+
+	// cluster[i] is the index of the centroid nearest to row i of the
+	// rows x columns matrix in (in C or, if fortran, Fortran order), after
+	// column j is scaled on axis[j] (unless axis is empty), or -1.  the
+	// first of equally near centroids wins.
+	void assign (const std::vector<GateAxis> & axis, const double * in, size_t rows,
+		bool fortran, int * cluster) const;
+
+private:
+	size_t k, d;
+	std::vector<double> centroid;
+};
+
+// a gaussian mixture with full covariances: the E-step
+class GaussianMixture
+{
+public:
+	// the components' weights, means (a row for each) and the Cholesky
+	// factors of their precisions (a columns x columns matrix for each), the
+	// way sklearn's GaussianMixture has them.
+	GaussianMixture (const std::vector<double> & weight, const std::vector<double> & mean,
+		const std::vector<double> & precisionCholesky);
+
+	inline size_t components () const { return k; };
+	inline size_t columns () const { return d; };
+
+	// for each row of in, read as NearestCentroid::assign does: the most
+	// likely component (or -1), like sklearn's predict().  unless they're
+	// null, posterior gets each component's posterior probability (like
+	// predict_proba(), and 0 for an event that isn't assigned) and
+	// distance the squared Mahalanobis distance to each component's mean
+	// (NaN for an event that isn't assigned), in rows x components
+	// matrices in C order.
+	void assign (const std::vector<GateAxis> & axis, const double * in, size_t rows,
+		bool fortran, int * component, double * posterior, double * distance) const;
+
+private:
+	size_t k, d;
+	std::vector<double> mean, factor;
+
+	// log(weight) plus the log of the normalization, for each component
+	std::vector<double> offset;
+};
+
+#endif
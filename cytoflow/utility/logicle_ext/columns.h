@@ -0,0 +1,44 @@
+// Transforming all of an event matrix's channels at once.
+//
+// The clustering and decomposition operations put each of their channels
+// on its own scale before they fit anything.  logicle_scale_columns does
+// that for an events-by-channels matrix in one pass on the thread pool,
+// with a GateAxis (see gate.h) for each column.  Each thread takes a block
+// of rows at a time and scales it a column at a time through a buffer on
+// the stack, so that whichever way round the matrix is stored each value
+// is read and written once, and the block stays in the cache.
+//
+// logicle_compensate_columns does the same with a compensation matrix
+// applied first: the block's compensated values are computed a column at
+// a time on the stack, scaled there if there are axes, and only then
+// written out.
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include "gate.h"
+#include <vector>
+
+// scale the rows x axis.size() matrix in, column j on axis[j], into out.
+// the matrix is in C order (row by row) or, if fortran, column by column;
+// out is in the same order, and may be the same array as in.
+void logicle_scale_columns (const std::vector<GateAxis> & axis,
+	const double * in, double * out, size_t rows, bool fortran);
+
+// out = in . matrix (like numpy.dot), where in is rows x columns and the
+// matrix is columns x columns, in C order.  then, unless axis is empty,
+// column j of the result is scaled on axis[j].  the orders and in and out
+// are as above.
+void logicle_compensate_columns (const std::vector<double> & matrix,
+	const std::vector<GateAxis> & axis, const double * in, double * out,
+	size_t rows, size_t columns, bool fortran);
+
+// copy m of the matrix's rows, from row, into block a column at a time
+// (column j at block + j * stride), scaling column j on axis[j] unless
+// axis is empty.  this is how the kernels that work on whole events (see
+// clusters.h) read them, a block at a time.
+void logicle_read_rows (const std::vector<GateAxis> & axis, const double * in,
+	size_t rows, size_t columns, bool fortran, size_t row, size_t m,
+	double * block, size_t stride);
+
+#endif
@@ -0,0 +1,71 @@
+// Density plots that can be re-drawn at any zoom without going back to
+// the events.
+//
+// A DensityGrid counts pairs of values into a fine grid of cells on two
+// FastLogicle scales, once.  Each cell is a run of whole table bins, so
+// counting an event is just finding its bins in the tables -- nothing is
+// interpolated, and nothing is stored but the counts.  raster() then sums
+// the cells into however many bins a plot wants over whatever part of the
+// scales it shows.  A bin that only covers part of a cell gets that part
+// of its count, as though the cell's events were spread evenly across it,
+// so the coarse bins don't alias against the cells.  Zoomed in so far that
+// a bin is smaller than a cell, the plot is as blocky as the cells are.
+
+#ifndef DENSITY_H
+#define DENSITY_H
+
+#include "logicle.h"
+#include <vector>
+
+class DensityGrid
+{
+public:
+	static const int DEFAULT_CELLS;
+
+	// cells by cells cells, covering the whole of x's and y's tables.
+	// there can't be more cells on an axis than there are bins in its
+	// table.  the grid keeps its own copies of x and y (which share their
+	// tables.)
+	DensityGrid (const FastLogicle & xlogicle, const FastLogicle & ylogicle,
+		int cells = DEFAULT_CELLS);
+
+	inline int cells () const { return n; };
+
+	// the number of pairs counted so far
+	inline double events () const { return total; };
+
+	// count pairs of values, adding them to those already counted.  a pair
+	// with either value off the end of its table (or NaN) isn't counted.
+	void add (const double * xvalue, const double * yvalue, size_t m);
+
+	// sum the cells into xbins by ybins bins evenly spaced on the scales,
+	// from xlo to xhi and ylo to yhi.  out[i * ybins + j] is the count in
+	// x bin i and y bin j, as numpy.histogram2d has it.
+	void raster (double xlo, double xhi, int xbins, double ylo, double yhi,
+		int ybins, double * out) const;
+
+private:
+	FastLogicle x, y;
+	int n;
+	double total;
+
+	// the scale at the lower edge of each cell, and then the top of the
+	// table, for each axis
+	std::vector<double> xedge, yedge;
+
+	// the counts, a row of y cells for each x cell
+	std::vector<double> grid;
+
+	// the part of a cell that's in a bin
+	struct Piece
+	{
+		int cell, bin;
+		double weight;
+	};
+
+	void edges (const FastLogicle & logicle, std::vector<double> & edge) const;
+	static void pieces (const std::vector<double> & edge, double lo, double hi,
+		int bins, std::vector<Piece> & piece);
+};
+
+#endif
@@ -0,0 +1,74 @@
+// Decoding the DATA segment of an FCS file straight from a memory mapping
+// of it, a parameter (column) at a time.
+//
+// List mode data is a row of parameter values per event, each value $PnB
+// bits wide, in the byte order $BYTEORD gives.  FcsData handles integer
+// ($DATATYPE I, any whole number of bytes up to 8) and floating point (F
+// and D) data in either byte order.  It only reads the parameter it's
+// decoding -- the rest of the row is skipped -- and it writes the values
+// straight into the caller's array, optionally transforming them on the
+// way (a block at a time, while they're still in the cache.)
+//
+// The TEXT segment, which says where the DATA segment is and what's in it,
+// is left to the caller, which has usually parsed it already.
+
+#ifndef FCS_H
+#define FCS_H
+
+#include "logicle.h"
+#include <vector>
+
+class FcsData
+{
+public:
+	// begin and end are the offsets of the first and last bytes of the
+	// DATA segment, as the header or $BEGINDATA and $ENDDATA give them.
+	// datatype is $DATATYPE; bigEndian is whether $BYTEORD is 4,3,2,1
+	// (rather than 1,2,3,4); events is $TOT; and bits is each parameter's
+	// $PnB.  if range (each parameter's $PnR) isn't empty, integer values
+	// are masked to the bits the range needs, like ImportOp does, since
+	// some instruments use the rest for other things.
+	FcsData (const char * path, size_t begin, size_t end, char datatype,
+		bool bigEndian, size_t events, const std::vector<int> & bits,
+		const std::vector<double> & range);
+
+	~FcsData ();
+
+	inline size_t events () const { return count; };
+	inline int parameters () const { return (int) width.size(); };
+
+	// decode a parameter (counting from 0) into out, which holds events()
+	// values
+	void decode (int parameter, double * out) const;
+	void decode (int parameter, float * out) const;
+
+	// decode a parameter and transform it.  clipScale clips the values to
+	// the range of logicle's table first, which is what LogicleScale does.
+	void decodeScale (int parameter, const Transform & transform, double * out) const;
+	void decodeClipScale (int parameter, const FastLogicle & logicle, double * out) const;
+
+private:
+	const void * mapping;
+	size_t length;
+
+	const unsigned char * data;
+	size_t count, stride;
+	char datatype;
+	bool bigEndian;
+
+	// each parameter's width and offset in the row, in bytes, and its mask
+	std::vector<int> width;
+	std::vector<size_t> offset;
+	std::vector<unsigned long long> mask;
+
+	void check (int parameter) const;
+
+	// decode values [begin, end) of a parameter
+	template <typename T>
+	void decodeRange (int parameter, size_t begin, size_t end, T * out) const;
+
+	FcsData (const FcsData &);
+	FcsData & operator= (const FcsData &);
+};
+
+#endif
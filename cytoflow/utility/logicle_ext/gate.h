@@ -0,0 +1,83 @@
+// Gates evaluated on the events' data values, in one pass.
+//
+// The range and quadrant gates don't care what scale they were drawn on:
+// the scales are all monotone, so they compare the data values directly.
+// A polygon's edges are straight on the plot's scales, though, so
+// PolygonGate transforms a block of events at a time onto the gate's
+// scales (on the stack) and tests them there.  Nothing is kept but the
+// result, a byte per event.
+//
+// NaN is never in a gate.
+
+#ifndef GATE_H
+#define GATE_H
+
+#include "logicle.h"
+#include <vector>
+
+// how a gate gets from the data values on one of its axes to the scale it
+// was drawn on
+class GateAxis
+{
+public:
+	// a linear scale
+	GateAxis ();
+
+	// a transform's scale.  the transform must outlive the axis.
+	GateAxis (const Transform & transform);
+
+	// FastLogicle's clipScale, which is what LogicleScale uses
+	static GateAxis clipped (const FastLogicle & logicle);
+
+	// log10, with values below threshold either clipped to it or (if mask)
+	// masked out, like LogScale's modes
+	static GateAxis log (double threshold, bool mask);
+
+	// scale a block of values in place
+	void scale (double * value, size_t n) const;
+
+private:
+	enum Kind { LINEAR, TRANSFORM, CLIPPED, LOG };
+
+	Kind kind;
+	const Transform * transform;
+	double threshold;
+	bool mask;
+};
+
+class PolygonGate
+{
+public:
+	// the vertices are on the axes' scales (ie. already transformed.)  the
+	// polygon closes itself.
+	PolygonGate (const GateAxis & x, const GateAxis & y,
+		const std::vector<double> & xvertex, const std::vector<double> & yvertex);
+
+	// in[i] is 1 if (xvalue[i], yvalue[i]) is inside the polygon, or 0.
+	// this is the same crossing test that matplotlib's
+	// Path.contains_points uses, so points on an edge go the same way.
+	void contains (const double * xvalue, const double * yvalue, size_t n,
+		unsigned char * in) const;
+
+private:
+	GateAxis x, y;
+	std::vector<double> vx, vy;
+
+	bool inside (double px, double py) const;
+};
+
+// in[i] is 1 if lo <= value[i] <= hi (like pandas' between), or 0
+void logicle_gate_range (const double * value, size_t n, double lo, double hi,
+	unsigned char * in);
+
+// the same, for both of a pair of values at once
+void logicle_gate_range2d (const double * xvalue, const double * yvalue, size_t n,
+	double xlo, double xhi, double ylo, double yhi, unsigned char * in);
+
+// the quadrant of each pair of values around (xthreshold, ythreshold),
+// numbered like FACSDiva (and QuadOp) does: 1 is upper left, 2 upper
+// right, 3 lower left and 4 lower right.  pairs on a threshold are 0.
+void logicle_gate_quad (const double * xvalue, const double * yvalue, size_t n,
+	double xthreshold, double ythreshold, unsigned char * quadrant);
+
+#endif
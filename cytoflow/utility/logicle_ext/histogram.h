@@ -0,0 +1,63 @@
+// Histograms of data on a transform's scale, counted straight from the
+// data values.
+//
+// The views bin data into bins that are evenly spaced on the scale they
+// plot it on.  Rather than transforming a whole column and then binning
+// it, Histogram transforms a block of values at a time (on the stack) and
+// counts them as it goes, so the transformed data never exists all at
+// once.  Each chunk of the thread pool's work (see threads.h) counts into
+// a histogram of its own, and they're added up at the end.
+//
+// Like numpy.histogram, a bin includes its lower edge, and the last one
+// includes its upper edge too.  The outer edges are checked against the
+// data values themselves (ie. against transform.inverse(lo) and
+// transform.inverse(hi)), so values outside the histogram -- NaN, or
+// values off the end of a FastLogicle's table -- are never transformed.
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "logicle.h"
+
+class Histogram
+{
+public:
+	// bins evenly spaced on transform's scale, from lo to hi.  transform
+	// must outlive the Histogram.
+	Histogram (const Transform & transform, double lo, double hi, int bins);
+
+	inline int bins () const { return n; };
+
+	// count values into counts, which has bins() elements, adding to what's
+	// already there (so a histogram can be built up a piece at a time)
+	void count (const double * value, size_t m, double * counts) const;
+
+	// count pairs of values into a 2d histogram: the pair (xvalue[i],
+	// yvalue[i]) is counted in counts[xbin * y.bins() + ybin], like
+	// numpy.histogram2d
+	static void count (const Histogram & x, const Histogram & y,
+		const double * xvalue, const double * yvalue, size_t m, double * counts);
+
+private:
+	const Transform & transform;
+	double lo, perBin;
+	double bottom, top;
+	int n;
+
+	static const size_t BLOCK;
+
+	// whether a data value is counted at all
+	inline bool inside (double value) const
+	{
+		return value >= bottom && value <= top;
+	};
+
+	// the bin of a scale value of a value that's inside
+	inline int bin (double scale) const
+	{
+		int b = (int) ((scale - lo) * perBin);
+		return b < 0 ? 0 : b >= n ? n - 1 : b;
+	};
+};
+
+#endif
@@ -0,0 +1,83 @@
+// The hyperlog transform, as cytoflow's HlogScale defines it.
+//
+// The inverse maps a scale y to a data value
+//
+//     x = sign(y) * (10^(d |y| / r) - 1) + b * d * y / r
+//
+// which is linear near zero and logarithmic for large values: b sets where
+// the transition is, d is the number of decades of data and r is the scale
+// value of the top decade.  Hlog::scale inverts it with Halley's method,
+// like Logicle::scale; FastHlog interpolates a lookup table over scale
+// [-r, r] (falling back on Hlog outside it), like FastLogicle.
+//
+// See Bagwell CB. Hyperlog -- a flexible log-like transform for negative,
+// zero, and positive valued data. Cytometry A. 2005 Mar;64(1):34-42.
+
+#ifndef HLOG_H
+#define HLOG_H
+
+#include "logicle.h"
+
+struct hlog_params
+{
+	double b, r, d;
+
+	// x = expm1(c |y|) + beta |y|
+	double c, beta;
+
+	// FastHlog's lookup table
+	struct logicle_table table;
+};
+
+class Hlog : public Transform
+{
+public:
+	Hlog (double b, double r, double d);
+	Hlog (const Hlog & hlog);
+
+	virtual ~Hlog ();
+
+	inline double b () const { return p->b; };
+	inline double r () const { return p->r; };
+	inline double d () const { return p->d; };
+
+	virtual double scale (double value) const;
+	virtual double inverse (double scale) const;
+
+	virtual void scale (const double * value, double * scale, size_t n) const;
+	virtual void inverse (const double * scale, double * value, size_t n) const;
+	using Transform::scale;
+	using Transform::inverse;
+
+protected:
+	hlog_params * p;
+
+private:
+	Hlog & operator= (const Hlog & hlog);
+};
+
+class FastHlog : public Hlog
+{
+public:
+	static const int DEFAULT_BINS;
+
+	FastHlog (double b, double r, double d, int bins = DEFAULT_BINS);
+	FastHlog (const FastHlog & hlog);
+
+	virtual ~FastHlog ();
+
+	virtual double scale (double value) const;
+	virtual double inverse (double scale) const;
+
+	virtual void scale (const double * value, double * scale, size_t n) const;
+	virtual void inverse (const double * scale, double * value, size_t n) const;
+	using Hlog::scale;
+	using Hlog::inverse;
+
+	inline int bins () const { return p->table.bins; };
+
+private:
+	FastHlog & operator= (const FastHlog & hlog);
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Kernel density estimates of millions of events, in milliseconds.
+//
+// Evaluating a kernel density estimate directly costs a kernel for every
+// event at every point it's evaluated at.  KernelDensity bins the events
+// first instead: each value's weight is split linearly between the two
+// points of a fine, even grid either side of it, in one pass on the
+// thread pool.  The estimate at each point is then a sum over the grid,
+// which costs the same however many events there are.  The values are on
+// a plot's scale already, so on a logicle scale the grid is even on the
+// FastLogicle table's scale, like its bins.  Binning moves each event by
+// at most half a grid step, so the grid has at least STEPS_PER_BANDWIDTH
+// steps per bandwidth (and more intervals than bins, if that's finer);
+// the compact kernels would alias, or miss events altogether, on a grid
+// much coarser than they are wide.  If a far outlier or a small bandwidth
+// would need more than MAX_BINS intervals (MAX_BINS_2D in each dimension
+// in 2D), the estimate sums the kernel over the events directly instead,
+// which is exact but costs a kernel per event per point.
+//
+// In two dimensions the (gaussian) kernel is separable, so the sum over
+// the grid is two matrix products rather than one sum per point.
+//
+// The kernels are normalized the way sklearn's KernelDensity has them, so
+// the estimates are densities.  NaN (and infinity) isn't counted.
+
+#ifndef KDE_H
+#define KDE_H
+
+#include "logicle.h"
+#include <vector>
+
+class KernelDensity
+{
+public:
+	enum Kernel { GAUSSIAN, TOPHAT, EPANECHNIKOV, EXPONENTIAL, LINEAR, COSINE };
+
+	static const int DEFAULT_BINS;
+	static const int STEPS_PER_BANDWIDTH;
+	static const int MAX_BINS;
+	static const int MAX_BINS_2D;
+
+	// the grid has at least bins intervals between the smallest and
+	// largest values
+	KernelDensity (Kernel kernel, double bandwidth, int bins = DEFAULT_BINS);
+
+	// out[j] is the density of the n values at point[j]
+	void density (const double * value, size_t n, const double * point, size_t m,
+		double * out) const;
+
+	// out[k * mx + j] is the density of the n pairs of values at
+	// (xpoint[j], ypoint[k]), ie. the rows are y, as numpy.meshgrid has
+	// them.  a pair isn't counted unless both its values are.  this is
+	// only for the gaussian kernel.
+	void density2d (const double * xvalue, const double * yvalue, size_t n,
+		const double * xpoint, size_t mx, const double * ypoint, size_t my,
+		double * out) const;
+
+private:
+	Kernel kernel;
+	double h;
+	int bins;
+
+	// the kernel at distance d (normalized in one dimension)
+	double weight (double d) const;
+
+	// the grid's ends: the smallest and largest finite values
+	static void range (const double * value, size_t n, double & lo, double & hi);
+
+	// how many intervals a grid from lo to hi needs, or 0 if that's more
+	// than most
+	int intervals (double lo, double hi, int most) const;
+
+	// out[j * points + i] is the kernel from point[j] to grid point i,
+	// for a grid from lo by step
+	void weights (const double * point, size_t m, double lo, double step,
+		size_t points, std::vector<double> & out) const;
+
+	// the estimates summed over the values themselves, without a grid
+	void directDensity (const double * value, size_t n, const double * point,
+		size_t m, double * out) const;
+	void directDensity2d (const double * xvalue, const double * yvalue, size_t n,
+		const double * xpoint, size_t mx, const double * ypoint, size_t my,
+		double * out) const;
+};
+
+#endif
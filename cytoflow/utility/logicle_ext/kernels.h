@@ -0,0 +1,52 @@
+// Vectorized batch kernels for the Logicle transforms.
+//
+// The kernels are written once, in kernels.inc, and compiled by Kernels.cpp
+// for each instruction set it knows about (SSE2, AVX2 and AVX-512 on x86,
+// NEON on ARM).  The best one the CPU supports is chosen the first time a
+// batch transform runs.  A kernel that is NULL falls back to the scalar
+// member functions, which is always the case with compilers that don't
+// support GCC-style vector extensions (eg. MSVC).
+//
+// The table kernels (FastLogicle::scale and FastLogicle::inverse) do the
+// same arithmetic as the scalar code, and give identical results.  The
+// exact inverse (Logicle::inverse) uses a polynomial exp() that's within
+// 2 ULP of the C library's, so it agrees with the scalar code to within a
+// few ULP of the exponential terms.  That's within 32 ULP of the result
+// over the display range, except right around data zero when W = 0, where
+// the result is the difference of two nearly equal terms.
+
+#ifndef LOGICLE_KERNELS_H
+#define LOGICLE_KERNELS_H
+
+#include <cstddef>
+
+struct logicle_params;
+struct logicle_table;
+
+struct logicle_kernels
+{
+	const char * name;
+
+	// Logicle::inverse
+	void (*inverse) (const logicle_params * p, int taylorLength,
+		const double * scale, double * value, size_t n);
+
+	// the lookup table transforms (eg. FastLogicle::scale and
+	// FastLogicle::inverse.)  These stop at the first value that's out
+	// of the range of the table and return
+	// the number of values they transformed; the caller deals with the
+	// rest using the scalar code.
+	size_t (*fastScale) (const logicle_table * table,
+		const double * value, double * scale, size_t n);
+	size_t (*fastInverse) (const logicle_table * table,
+		const double * scale, double * value, size_t n);
+};
+
+// the kernels in use
+const logicle_kernels & logicle_kernels_active ();
+
+// use the named kernels instead.  returns false if they aren't available
+// on this CPU.
+bool logicle_kernels_select (const char * name);
+
+#endif
@@ -1,11 +1,18 @@
+#ifndef LOGICLE_H
+#define LOGICLE_H
+
 #ifdef R_LOGICLE
 #include <R.h>
 #include <Rinternals.h>
 #include <R_ext/Rdynload.h>
 #endif
 
+#include "table.h"
+
 #ifdef __cplusplus
+#include <cstddef>
 #include <vector>
+#include "transform.h"
 
 extern "C" {
 
@@ -21,8 +28,8 @@ extern "C" {
                 double xTaylor;
                 double *taylor;
 
-                double *lookup;
-                int bins;
+                // FastLogicle's lookup table, over scale [0, 1]
+                struct logicle_table table;
         };
 
         const char * logicle_error ();
@@ -55,7 +62,7 @@ extern "C" {
 
 }
 
-class Logicle
+class Logicle : public Transform
 {
 public:
         static const double DEFAULT_DECADES;
@@ -83,20 +90,15 @@ public:
 
         class IllegalArgument : public Exception
         {
-        private:
+        public:
                 IllegalArgument (double value);
                 IllegalArgument (int value);
-
-                friend class Logicle;
-                friend class FastLogicle;
         };
 
         class IllegalParameter : public Exception
         {
-        private:
+        public:
                 IllegalParameter (const char * const message);
-
-                friend class Logicle;
         };
 
         class DidNotConverge : public Exception
@@ -105,6 +107,7 @@ public:
                 DidNotConverge (const char * const message);
 
                 friend class Logicle;
+                friend class Hlog;
         };
 
         Logicle (double T, double W, double M = DEFAULT_DECADES, double A = 0);
@@ -130,9 +133,42 @@ public:
 
         virtual double scale (double value) const;
         virtual double inverse (double scale) const;
+
+        virtual void scale (const double * value, double * scale, size_t n) const;
+        virtual void inverse (const double * scale, double * value, size_t n) const;
+        using Transform::scale;
+        using Transform::inverse;
+
         double dynamicRange () const;
         void axisLabels (std::vector<double> & label) const;
 
+        // the major and minor ticks for an axis that shows vmin to vmax,
+        // laid out the way LogicleMajorLocator and LogicleMinorLocator do:
+        // a major tick every decade (including zero and the negative
+        // decades) and a minor tick every tenth of a decade between them
+        void axisTicks (double vmin, double vmax,
+                std::vector<double> & major, std::vector<double> & minor) const;
+
+        // the instruction set the batch transforms use, and a way to
+        // choose another one (mostly for testing.)  setSimd returns false
+        // if the CPU doesn't support it.
+        static const char * simd ();
+        static bool setSimd (const char * name);
+
+        // the number of threads the batch transforms use.  0 (the
+        // default) means one per CPU.  arrays too small to be worth
+        // splitting up always run on the calling thread.
+        static int threads ();
+        static void setThreads (int threads);
+
+        // the fast transforms share their lookup tables through a cache
+        // of the most recently built ones, and this is how many it keeps
+        // (32 by default; 0 turns it off.)  tableCacheCount is how many
+        // it has now.
+        static int tableCacheSize ();
+        static void setTableCacheSize (int size);
+        static int tableCacheCount ();
+
 protected:
         static const double LN_10;
         static const double EPSILON;
@@ -169,6 +205,10 @@ public:
         FastLogicle (double T, double W, double M);
         FastLogicle (double T, double W);
 
+        // map a table saved by save() read only, so that every process
+        // that uses it shares one copy and none of them have to build it
+        FastLogicle (const char * path);
+
         FastLogicle (const FastLogicle & logicle);
 
         virtual ~FastLogicle ();
@@ -176,13 +216,113 @@ public:
         virtual double scale (double value) const;
         virtual double inverse (double scale) const;
 
-        inline int bins () const { return p->bins; };
+        virtual void scale (const double * value, double * scale, size_t n) const;
+        virtual void inverse (const double * scale, double * value, size_t n) const;
+        using Logicle::scale;
+        using Logicle::inverse;
+
+        // clip to the range of the lookup table, then scale, so that
+        // values off either end of the table map to 0 or (almost) 1
+        // instead of throwing.  scale may be the same array as value.
+        virtual double clipScale (double value) const;
+        virtual void clipScale (const double * value, double * scale, size_t n) const;
+        void clipScale (const float * value, float * scale, size_t n) const;
+
+        // Logicle's batch inverse rather than the table's, for scale values
+        // that may be off the ends of the table or need every digit
+        void exactInverse (const double * scale, double * value, size_t n) const;
+
+        inline int bins () const { return p->table.bins; };
 
         int intScale (double value) const;
         double inverse (int scale) const;
 
+        // the table bin of each value, like intScale, except that values
+        // off either end of the table (and NaN) get -1 instead of throwing
+        void intScale (const double * value, int * bin, size_t n) const;
+
+        // what the batch transforms below do with values off the table
+        // (or, for inverse, outside the scale it covers):  clip them to
+        // its ends, the way clipScale does, or give them NaN.  either way
+        // there's no exception, so a column with a few outliers costs no
+        // more than one without.
+        enum Outside { CLIP_OUTSIDE, NAN_OUTSIDE };
+
+        // scale or inverse n values, handling those outside by policy.
+        // returns how many there were, and if outside isn't 0 appends their
+        // indices to it in order.  NaN stays NaN and isn't counted.  the
+        // output may be the same array as the input.
+        size_t scale (const double * value, double * scale, size_t n,
+                Outside policy, std::vector<size_t> * outside = 0) const;
+        size_t inverse (const double * scale, double * value, size_t n,
+                Outside policy, std::vector<size_t> * outside = 0) const;
+
+        // save the parameters and the table to a file for the constructor
+        // above.  the file is only good on the kind of machine that saved
+        // it.
+        void save (const char * path) const;
+
+        // the file the table is mapped from, or 0 if it isn't
+        const char * tableFile () const;
+
+protected:
+        // the largest value clipScale() keeps
+        double clipMaximum () const;
+
 private:
+        static const int FILL_ANCHOR;
+
+        struct MappedTable;
+        FastLogicle (const MappedTable & mapped);
+
         void initialize (int bins);
+        void fill (logicle_table * table) const;
+
+        friend class TestLogicle;
+};
+
+// a FastLogicle that interpolates its table with cubic Hermite splines,
+// which match the slope of the transform at each end of a bin as well as
+// its value.  that's a little more arithmetic per value than FastLogicle,
+// and one more table, but no exponentials, and it agrees with Logicle to
+// within about 1e-13 of the scale.  the bins (and so intScale(),
+// histograms and gates) are FastLogicle's.
+class HermiteLogicle : public FastLogicle
+{
+public:
+        HermiteLogicle (double T, double W, double M, double A, int bins);
+        HermiteLogicle (double T, double W, double M, int bins);
+        HermiteLogicle (double T, double W, int bins);
+
+        HermiteLogicle (double T, double W, double M, double A);
+        HermiteLogicle (double T, double W, double M);
+        HermiteLogicle (double T, double W);
+
+        HermiteLogicle (const HermiteLogicle & logicle);
+
+        virtual ~HermiteLogicle ();
+
+        virtual double scale (double value) const;
+        virtual double inverse (double scale) const;
+
+        virtual void scale (const double * value, double * scale, size_t n) const;
+        virtual void inverse (const double * scale, double * value, size_t n) const;
+        using FastLogicle::scale;
+        using FastLogicle::inverse;
+
+        virtual double clipScale (double value) const;
+        virtual void clipScale (const double * value, double * scale, size_t n) const;
+        using FastLogicle::clipScale;
+
+private:
+        // the data value per bin at each point of the table, ie. the slope
+        // of the inverse in units of bins
+        logicle_table slopes;
+
+        void initialize ();
+
+        double hermiteScale (int bin, double value) const;
+        double hermiteInverse (int bin, double position) const;
 
         friend class TestLogicle;
 };
@@ -191,3 +331,5 @@ private:
 int PullInMyLibrary ();
 
 #endif
+
+#endif
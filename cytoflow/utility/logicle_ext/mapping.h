@@ -0,0 +1,15 @@
+// Mapping whole files read only into memory, for the saved lookup tables
+// (table.h) and for FCS files (fcs.h).  All of the processes that map the
+// same file share its pages.
+
+#ifndef LOGICLE_MAPPING_H
+#define LOGICLE_MAPPING_H
+
+#include <cstddef>
+
+// map path, and set length to its length.  returns 0 and sets error to a
+// message saying what went wrong if it can't (including if it's empty.)
+const void * logicle_map (const char * path, size_t & length, const char * & error);
+void logicle_unmap (const void * mapping, size_t length);
+
+#endif
@@ -0,0 +1,78 @@
+// Statistics of a channel's events, computed natively rather than through
+// pandas.
+//
+// ChannelStats is what LogicleScale needs to choose its parameters: the
+// largest value (for T, when the channel's range isn't known) and the rth
+// quantile of the negative values (for W.)  It gets them in one pass over
+// the events on the thread pool, keeping only the negative values, and
+// then selects the quantile from those rather than sorting them.  The
+// quantile is exact, and interpolated linearly between the values either
+// side of it the way numpy (and so pandas) does by default.
+//
+// logicle_bootstrap resamples an array with replacement, many times, and
+// reduces each resample to a statistic, on the thread pool.  Each resample
+// draws from its own random stream (seeded from the seed and which
+// resample it is), so the results don't depend on the number of threads.
+// The resamples are drawn as indices into the values and not copied:
+// the mean and geometric mean are summed as the indices are drawn, and
+// the median counts how many times each of the (sorted) values is drawn.
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "logicle.h"
+
+class ChannelStats
+{
+public:
+	// NaN isn't counted, and doesn't count as negative.  r must be
+	// between 0 and 1.
+	ChannelStats (const double * value, size_t n, double r);
+	ChannelStats (const float * value, size_t n, double r);
+
+	// the number of values that aren't NaN
+	inline size_t count () const { return counted; };
+
+	// the largest value, or NaN if there aren't any
+	inline double maximum () const { return largest; };
+
+	// the number of negative values, and the rth quantile of them (NaN if
+	// there aren't any)
+	inline size_t negatives () const { return negative; };
+	inline double negativeQuantile () const { return quantile; };
+
+private:
+	size_t counted, negative;
+	double largest, quantile;
+
+	template <typename T>
+	void compute (const T * value, size_t n, double r);
+};
+
+// the statistics logicle_bootstrap can compute
+enum logicle_statistic
+{
+	LOGICLE_MEAN,
+
+	// the middle value, or the mean of the middle two, like numpy.median
+	LOGICLE_MEDIAN,
+
+	// like cytoflow's geom_mean: the geometric means of the positive and
+	// of the (absolute) negative values, weighted by how many of each
+	// there are, and zeros left out
+	LOGICLE_GEOM_MEAN
+};
+
+// out[i] is the statistic of the ith of boots resamples of the n values.
+// with no values, the statistics are NaN.
+void logicle_bootstrap (const double * value, size_t n, logicle_statistic statistic,
+	unsigned long long seed, double * out, size_t boots);
+
+// the percent[j]th percentile of the n values, interpolated linearly like
+// numpy.percentile (and scipy's scoreatpercentile.)  it's found by
+// selection rather than sorting.  if there are NaNs (or no values) all
+// the percentiles are NaN, as is any percentile outside [0, 100].
+void logicle_percentiles (const double * value, size_t n,
+	const double * percent, size_t m, double * out);
+
+#endif
@@ -0,0 +1,118 @@
+// Opt-in counters for the transforms' hot paths.
+//
+// Built with LOGICLE_STATS defined (setup.py defines it when the
+// LOGICLE_STATS environment variable is True), the extension counts how
+// often the exact logicle takes the Taylor series and how many Halley
+// iterations it needs, how many values fall off the lookup tables, how
+// often the transforms throw, and how many tables are built and how long
+// that takes.  Each thread counts into its own block, so counting costs a
+// few instructions and never contends; a snapshot adds the blocks up.
+//
+// Without LOGICLE_STATS the LOGICLE_COUNT macros expand to nothing, so
+// there's no cost at all, and snapshots are all zeroes.
+
+#ifndef LOGICLE_STATS_H
+#define LOGICLE_STATS_H
+
+#include <chrono>
+#include <vector>
+
+enum logicle_counter
+{
+	// Logicle::scale calls, those that used the Taylor series near zero,
+	// and the Halley iterations they took all together
+	LOGICLE_EXACT_SCALES,
+	LOGICLE_TAYLOR_SCALES,
+	LOGICLE_HALLEY_ITERATIONS,
+
+	// values the table transforms handled, and those of them that were
+	// off the table and went to the scalar transform instead
+	LOGICLE_TABLE_VALUES,
+	LOGICLE_TABLE_FALLBACKS,
+
+	// tables found in the cache or built, the bins built, and the time
+	// spent building them
+	LOGICLE_TABLE_HITS,
+	LOGICLE_TABLE_BUILDS,
+	LOGICLE_TABLE_BINS,
+	LOGICLE_TABLE_NANOSECONDS,
+
+	// exceptions thrown
+	LOGICLE_ILLEGAL_ARGUMENTS,
+	LOGICLE_DID_NOT_CONVERGE,
+
+	LOGICLE_COUNTERS
+};
+
+enum logicle_histogram
+{
+	// Logicle::scale calls by the number of iterations they took
+	LOGICLE_HALLEY_HISTOGRAM,
+
+	// tables built, by how long they took:  bucket i counts those that
+	// took at least 2^i microseconds (and less than 2^(i + 1)), and the
+	// first and last buckets anything quicker or slower
+	LOGICLE_TABLE_HISTOGRAM,
+
+	LOGICLE_HISTOGRAMS
+};
+
+const int LOGICLE_BUCKETS = 32;
+
+struct logicle_stats
+{
+	unsigned long long counter[LOGICLE_COUNTERS];
+	unsigned long long histogram[LOGICLE_HISTOGRAMS][LOGICLE_BUCKETS];
+};
+
+// this thread's counts, for the macros below
+struct logicle_stats_block;
+logicle_stats_block & logicle_stats_local ();
+void logicle_stats_add (logicle_stats_block & block, int counter, unsigned long long n);
+void logicle_stats_bucket (logicle_stats_block & block, int histogram, int bucket);
+
+// times the scope it's declared in into a counter and a histogram
+class logicle_stats_timer
+{
+public:
+	logicle_stats_timer (int counter, int histogram);
+	~logicle_stats_timer ();
+
+private:
+	int counter, histogram;
+	std::chrono::steady_clock::time_point start;
+};
+
+#ifdef LOGICLE_STATS
+#define LOGICLE_COUNT(counter, n) \
+	logicle_stats_add(logicle_stats_local(), (counter), (n))
+#define LOGICLE_BUCKET(histogram, bucket) \
+	logicle_stats_bucket(logicle_stats_local(), (histogram), (bucket))
+#define LOGICLE_TIME(counter, histogram) \
+	logicle_stats_timer logicle_stats_timer_(counter, histogram)
+#else
+#define LOGICLE_COUNT(counter, n) ((void) 0)
+#define LOGICLE_BUCKET(histogram, bucket) ((void) 0)
+#define LOGICLE_TIME(counter, histogram) ((void) 0)
+#endif
+
+// a snapshot of the counts since the last reset, across all threads
+class TransformStats
+{
+public:
+	TransformStats ();
+
+	// whether the extension was built with LOGICLE_STATS
+	static bool enabled ();
+
+	// start counting again from zero
+	static void reset ();
+
+	unsigned long long count (int counter) const;
+	void histogram (int histogram, std::vector<double> & counts) const;
+
+private:
+	logicle_stats stats;
+};
+
+#endif
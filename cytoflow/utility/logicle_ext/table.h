@@ -0,0 +1,137 @@
+// Lookup tables for the fast transforms (FastLogicle and FastHlog).
+//
+// A table samples the inverse of a monotone transform at bins + 1 evenly
+// spaced points in scale space, from offset to offset + width.  Scaling
+// a value inverse interpolates the table linearly, and inverting a scale
+// interpolates it.  The index over data space narrows the search of the
+// table to a few bins; it's exact, so it doesn't change the answers.
+//
+// Tables are immutable once they're built, and their arrays are reference
+// counted so that transforms with the same parameters can share them.
+// They can also be saved to a file and mapped back into memory, so that
+// separate processes can share them too.  A
+// process-wide cache keeps the most recently built tables around, so (eg.)
+// rebuilding a FastLogicle for every subplot of a faceted plot only builds
+// its table once.
+
+#ifndef LOGICLE_TABLE_H
+#define LOGICLE_TABLE_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <functional>
+#endif
+
+// the arrays behind a table, which copies of it share
+struct logicle_table_storage;
+
+struct logicle_table
+{
+	// lookup[i] is the data value at scale offset + width * i / bins.
+	// lookup[bins] is only there for interpolation.
+	double *lookup;
+	int bins;
+	double offset, width;
+
+	// a coarse index over data space that narrows the search of lookup
+	// to a few bins.  cells are log spaced in the magnitude of the value,
+	// above a floor near zero where the bins are uniformly spaced.
+	int *index;
+	int indexCells, indexZero, indexShift;
+	unsigned long long indexBase;
+	double indexFloor;
+
+	struct logicle_table_storage *storage;
+};
+
+#ifdef __cplusplus
+
+// what a table is a table of: the transform (any character constant that
+// names it, eg. 'L' for logicle), its parameters and the number of bins
+struct logicle_table_key
+{
+	int transform;
+	double parameter[4];
+	int bins;
+};
+
+// an empty table, with nothing to destroy
+void logicle_table_init (logicle_table * table);
+
+// allocate the lookup array (which the caller fills in) of an empty table
+void logicle_table_create (logicle_table * table, int bins, double offset, double width);
+
+// build the index of a table once its lookup array is filled in
+void logicle_table_index (logicle_table * table);
+
+// share from's arrays (tables never change, so sharing is safe)
+void logicle_table_share (logicle_table * table, const logicle_table * from);
+
+// release the table's arrays, freeing them if nothing else shares them
+void logicle_table_destroy (logicle_table * table);
+
+// share the table for key from the cache, or else create it (covering
+// scale offset to offset + width), have fill() fill in its lookup array,
+// index it and add it to the cache.  safe to call from any thread.  a
+// table of something other than a monotone transform's inverse (eg. its
+// slopes) can't be indexed (or searched), so pass indexed = false for those.
+void logicle_table_cached (logicle_table * table, const logicle_table_key & key,
+	double offset, double width, const std::function<void (logicle_table * table)> & fill,
+	bool indexed = true);
+
+// the most tables the cache holds on to; 0 turns it off.  shrinking it
+// evicts the least recently used tables, which stay around for as long as
+// the transforms using them do.
+int logicle_table_cache_size ();
+void logicle_table_set_cache_size (int size);
+
+// the number of tables in the cache
+int logicle_table_cache_count ();
+
+// save a table (and what it's a table of) to a file that can be mapped
+// into memory, or map one read only.  all of the processes that map the
+// same file share one copy of the table, and don't have to build it.  the
+// file is only good on the kind of machine that saved it.  replace it
+// rather than overwriting it once it's in use.  these return 0, or else
+// a message saying what went wrong.
+const char * logicle_table_save (const logicle_table * table,
+	const logicle_table_key & key, const char * path);
+const char * logicle_table_map (logicle_table * table,
+	logicle_table_key & key, const char * path);
+
+// the path of the file a table is mapped from, or 0
+const char * logicle_table_file (const logicle_table * table);
+
+// the bin value falls in, or -1 if it's out of the range of the table.
+// NaN gets an arbitrary bin, and so scales to NaN.
+int logicle_table_bin (const logicle_table * table, double value);
+
+// the interpolated scale of a value in bin
+inline double logicle_table_scale (const logicle_table * table, int bin, double value)
+{
+	// inverse interpolate the table linearly
+	double delta = (value - table->lookup[bin])
+		/ (table->lookup[bin + 1] - table->lookup[bin]);
+
+	return (bin + delta) / (double) table->bins * table->width + table->offset;
+}
+
+// the position of scale in the table, in bins; its floor is the bin
+inline double logicle_table_position (const logicle_table * table, double scale)
+{
+	return (scale - table->offset) * (table->bins / table->width);
+}
+
+// the interpolated value at a position in the table, which must be in
+// [0, bins)
+inline double logicle_table_inverse (const logicle_table * table, int bin, double position)
+{
+	// interpolate the table linearly
+	double delta = position - bin;
+
+	return (1 - delta) * table->lookup[bin] + delta * table->lookup[bin + 1];
+}
+
+#endif
+
+#endif
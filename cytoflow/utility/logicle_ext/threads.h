@@ -0,0 +1,36 @@
+// A small thread pool for the batch transforms.
+//
+// logicle_parallel() splits [0, n) into chunks and runs them on a pool of
+// worker threads, with the calling thread lending a hand.  Arrays smaller
+// than LOGICLE_PARALLEL_MINIMUM values per thread aren't worth the trouble
+// and run on the calling thread, as do calls made while the pool is busy
+// with someone else's array (so independent callers don't wait for each
+// other.)
+//
+// Where each of the n items is more work than a single value (eg. a row
+// of a matrix, or a whole resample of an array), cost says about how many
+// values' worth it is, so that short arrays of expensive items are still
+// worth splitting up.
+//
+// If f throws, logicle_parallel waits for the rest of the chunks and then
+// rethrows the exception from the earliest chunk, so the caller sees the
+// same exception the serial loop would have thrown.
+
+#ifndef LOGICLE_THREADS_H
+#define LOGICLE_THREADS_H
+
+#include <cstddef>
+#include <functional>
+
+const size_t LOGICLE_PARALLEL_MINIMUM = 1 << 16;
+
+void logicle_parallel (size_t n, const std::function<void (size_t begin, size_t end)> & f,
+	size_t cost = 1);
+
+// the number of threads logicle_parallel uses, including the caller's
+int logicle_threads ();
+
+// 0 uses one thread per CPU, which is the default
+void logicle_set_threads (int threads);
+
+#endif
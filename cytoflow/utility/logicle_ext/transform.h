@@ -0,0 +1,56 @@
+// The interface the transforms in this extension share.
+//
+// Each family (Logicle, Hlog, Arcsinh) has an exact transform and a Fast
+// variant that interpolates a lookup table (see table.h).  They all map
+// data values to scale values and back, one at a time or in batches, and
+// the batches all run the same way: on the thread pool (threads.h), using
+// the best SIMD kernels the CPU supports (kernels.h) where there are any.
+
+#ifndef LOGICLE_TRANSFORM_H
+#define LOGICLE_TRANSFORM_H
+
+#include <cstddef>
+#include <functional>
+
+struct logicle_table;
+
+class Transform
+{
+public:
+	virtual ~Transform ();
+
+	virtual double scale (double value) const = 0;
+	virtual double inverse (double scale) const = 0;
+
+	// transform n values at once.  value and scale may be the same array.
+	// by default these run the scalar transform on the thread pool.
+	virtual void scale (const double * value, double * scale, size_t n) const;
+	virtual void inverse (const double * scale, double * value, size_t n) const;
+
+	// the same, for single precision data.  these widen a block of values
+	// at a time to double precision and run the transforms above on it,
+	// so the results are the double precision ones rounded to the nearest
+	// float (ie. within half a float ULP of them.)  subclasses that
+	// declare their own scale and inverse bring these in with using
+	// declarations.
+	virtual void scale (const float * value, float * scale, size_t n) const;
+	virtual void inverse (const float * scale, float * value, size_t n) const;
+
+protected:
+	// run f on the values in double precision, a block of at most
+	// FLOAT_BLOCK at a time, on the thread pool
+	static const size_t FLOAT_BLOCK;
+	static void inDouble (const float * in, float * out, size_t n,
+		const std::function<void (double * block, size_t m)> & f);
+
+	// transform a range of values through a lookup table, on the calling
+	// thread.  the kernels transform what they can and the scalar
+	// transform above deals with the rest (eg. values off the ends of the
+	// table.)
+	void tableScale (const logicle_table * table,
+		const double * value, double * scale, size_t n) const;
+	void tableInverse (const logicle_table * table,
+		const double * scale, double * value, size_t n) const;
+};
+
+#endif
@@ -27,7 +27,7 @@ from warnings import warn
 
 from traits.api import (HasStrictTraits, HasTraits, Float, Property, Instance, Str,
                         cached_property, Undefined, provides, Constant, Dict,
-                        Tuple, Array)
+                        Tuple, Array, Enum, Any)
                        
 import numpy as np
 import pandas as pd
@@ -39,10 +39,128 @@ from matplotlib.ticker import Locator
 import matplotlib.colors
 
 from .scale import IScale, register_scale
-from .logicle_ext.Logicle import FastLogicle
+from .logicle_ext.Logicle import (FastLogicle, HermiteLogicle, DensityGrid, 
+                                  GateAxis, ChannelStats, histogram, histogram2d)
 from .util_functions import is_numeric
 from .cytoflow_errors import CytoflowError, CytoflowWarning
 
+def _batch(f, data):
+    """
+    Apply one of the native transforms' batch methods (eg. `scale`, 
+    `clipScale` or `inverse`) to an entire array in a single call, instead 
+    of once per element.  float32 data stays float32 (the native code still
+    computes in double precision); anything else is converted to float64.
+    """
+    data = np.asarray(data, order = 'C')
+    dtype = np.float32 if data.dtype == np.float32 else np.float64
+    data = np.asarray(data, dtype = dtype, order = 'C')
+    ret = np.empty_like(data)
+    f(data, ret)
+    return ret
+
+def _exact(logicle, data):
+    """
+    The exact inverse of `logicle` (a `FastLogicle`) on an array, in one 
+    native call.  The result is float64, whatever the data are.
+    """
+    data = np.asarray(data, dtype = np.float64, order = 'C')
+    ret = np.empty_like(data)
+    logicle.exactInverse(data, ret)
+    return ret
+
+def _clip_inverse(logicle):
+    """
+    A batch inverse of `logicle` (a `FastLogicle`) for `_batch` and 
+    `_stream`, which clips scale values off either end of the table as it
+    goes instead of raising, and leaves NaN alone.  float32 is inverted in 
+    double precision.
+    """
+    def f(scale, value):
+        if scale.dtype == np.float64:
+            logicle.inverseOutside(scale, value, FastLogicle.CLIP_OUTSIDE)
+        else:
+            ret = np.empty(scale.shape, dtype = np.float64)
+            logicle.inverseOutside(np.asarray(scale, dtype = np.float64), ret,
+                                   FastLogicle.CLIP_OUTSIDE)
+            value[:] = ret
+    return f
+
+def _apply(f, data):
+    """
+    Apply one of the native transforms' methods to `data`.  A `pandas.Series`
+    (which keeps its index and name) or a `numpy.ndarray` is transformed in a 
+    single batch call; a number or a list of numbers, one at a time.
+    """
+    if isinstance(data, pd.Series):            
+        return pd.Series(_batch(f, data.values),
+                         index = data.index,
+                         name = data.name)
+    elif isinstance(data, np.ndarray):
+        return _batch(f, data)
+    elif isinstance(data, (int, float)):
+        return f(float(data))
+    else:
+        return [f(float(x)) for x in data]
+
+# big enough that the batch transforms still split each chunk across threads
+STREAM_CHUNK = 1 << 20
+
+def _chunks(source, chunk_size):
+    """
+    Split `source` into 1-d arrays of at most `chunk_size` values without
+    reading it all in: an array (including a `numpy.memmap` or a strided,
+    byte-swapped column of an FCS DATA segment) is sliced into views, and an
+    iterable of arrays (eg. blocks read from a file) is taken a piece at a
+    time.
+    """
+    if isinstance(source, pd.Series):
+        source = source.values
+    if isinstance(source, np.ndarray):
+        source = source.reshape(-1)
+        for i in range(0, len(source), chunk_size):
+            yield source[i : i + chunk_size]
+    else:
+        for piece in source:
+            piece = np.asarray(piece).reshape(-1)
+            for i in range(0, len(piece), chunk_size):
+                yield piece[i : i + chunk_size]
+
+def _stream(f, source, out, chunk_size):
+    """
+    Apply one of the native transforms' batch methods to `source` a chunk 
+    at a time, so that only a chunk's worth of it has to be in memory (and
+    converted, if it isn't already contiguous float32 or float64) at once.
+    Each transformed chunk is written to the next part of `out`; or, if 
+    `out` is None, yielded as it's done.
+    """
+    if chunk_size < 1:
+        raise CytoflowError("chunk_size must be positive")
+
+    at = 0
+    for piece in _chunks(source, chunk_size):
+        piece = np.asarray(piece, order = 'C')
+        if piece.dtype != np.float32:
+            piece = np.asarray(piece, dtype = np.float64, order = 'C')
+
+        if out is None:
+            ret = np.empty_like(piece)
+            f(piece, ret)
+            yield ret
+            continue
+
+        if at + len(piece) > len(out):
+            raise CytoflowError("out is shorter than the data")
+        dest = out[at : at + len(piece)]
+        if dest.dtype == piece.dtype and dest.flags.c_contiguous:
+            # straight into the output (eg. a writable memmap)
+            f(piece, dest)
+        else:
+            dest[:] = _batch(f, piece)
+        at += len(piece)
+
+    if out is not None and at != len(out):
+        raise CytoflowError("out is longer than the data")
+
 @provides(IScale)
 class LogicleScale(HasStrictTraits):
     """
@@ -96,6 +214,13 @@ class LogicleScale(HasStrictTraits):
     
     r : Float (default = 0.05)
         Quantile used to estimate `W`.
+        
+    mode : Enum("fast", "accurate") (default = "fast")
+        How closely to compute the transform.  ``fast`` interpolates a 
+        lookup table linearly, and is within about 1e-7 of the exact scale.
+        ``accurate`` interpolates the same table with cubics, and is within
+        about 1e-13 of it; it's a few times slower than ``fast``, but still
+        much faster than computing the transform exactly.
     
     References
     ----------
@@ -131,10 +256,17 @@ class LogicleScale(HasStrictTraits):
     M = Float(4.5, desc = "the width of the display in log10 decades")
     A = Float(0.0, desc = "additional decades of negative data to include.")
     r = Float(0.05, desc = "quantile to use for estimating the W parameter.")
+    mode = Enum("fast", "accurate", desc = "how closely to compute the transform")
 
     _W = Float(Undefined)
     _T = Property(Float, depends_on = "[experiment, condition, channel]")
-    _logicle = Property(Instance(FastLogicle), depends_on = "[_T, W, M, A]")
+    
+    # the channel's maximum and negative quantile, from one native pass
+    _stats = Property(Instance(ChannelStats), depends_on = "[experiment, channel, r]")
+    _logicle = Property(Instance(FastLogicle), depends_on = "[_T, W, M, A, mode]")
+    
+    # the data values at either end of the scale
+    _limits = Property(Tuple(Float, Float), depends_on = "_logicle")
     
     def __call__(self, data):
         """
@@ -145,22 +277,16 @@ class LogicleScale(HasStrictTraits):
         """
         
         try:
-            logicle_min = self._logicle.inverse(0.0)
-            logicle_max = self._logicle.inverse(1.0 - sys.float_info.epsilon)
             if isinstance(data, pd.Series):            
-                data = data.clip(logicle_min, logicle_max)
-                return data.apply(self._logicle.scale)
+                return pd.Series(_batch(self._logicle.clipScale, data.values),
+                                 index = data.index,
+                                 name = data.name)
             elif isinstance(data, np.ndarray):
-                data = np.clip(data, logicle_min, logicle_max)
-                scale = np.vectorize(self._logicle.scale)
-                return scale(data)
+                return _batch(self._logicle.clipScale, data)
             elif isinstance(data, float):
-                data = max(min(data, logicle_max), logicle_min)
-                return self._logicle.scale(data)
+                return self._logicle.clipScale(data)
             elif isinstance(data, int):
-                data = float(data)
-                data = max(min(data, logicle_max), logicle_min)
-                return self._logicle.scale(data)
+                return self._logicle.clipScale(float(data))
             else:
                 try:
                     return list(map(self._logicle.scale, data))
@@ -176,12 +302,11 @@ class LogicleScale(HasStrictTraits):
         """
         try:
             if isinstance(data, pd.Series):            
-                data = data.clip(0, 1.0 - sys.float_info.epsilon)
-                return data.apply(self._logicle.inverse)
+                return pd.Series(_batch(_clip_inverse(self._logicle), data.values),
+                                 index = data.index,
+                                 name = data.name)
             elif isinstance(data, np.ndarray):
-                data = np.clip(data, 0, 1.0 - sys.float_info.epsilon)
-                inverse = np.vectorize(self._logicle.inverse)
-                return inverse(data)
+                return _batch(_clip_inverse(self._logicle), data)
             elif isinstance(data, float):
                 data = max(min(data, 1.0 - sys.float_info.epsilon), 0.0)
                 return self._logicle.inverse(data)
@@ -191,16 +316,146 @@ class LogicleScale(HasStrictTraits):
                 return self._logicle.inverse(data)
             else:
                 try:
-                    return list(map(self._logicle.inverse, data))
+                    return list(_batch(_clip_inverse(self._logicle), list(data)))
                 except TypeError as e:
                     raise CytoflowError("Unknown data type") from e
         except ValueError as e:
             raise CytoflowError(str(e))
+
+    def stream(self, source, out = None, chunk_size = STREAM_CHUNK, 
+               inverse = False):
+        """
+        Transforms `source` (or, if `inverse` is set, inverts it) a chunk of
+        `chunk_size` values at a time, for data that's too big to hold in 
+        memory all at once.  `source` can be an array -- usually a
+        `numpy.memmap` of a file, or a column of one -- or an iterable of
+        arrays.  
+        
+        If `out` is given, it's an array (eg. a writable `numpy.memmap`) as
+        long as the data, which the transformed values are written to;
+        `stream` returns it.  Otherwise, `stream` returns an iterator over 
+        the transformed chunks.  Either way, peak memory is a few chunks.
+        """
+        
+        if self._logicle is Undefined:
+            raise CytoflowError("The scale's parameters aren't set")
+        
+        if inverse:
+            f = _clip_inverse(self._logicle)
+        else:
+            f = self._logicle.clipScale
+            
+        def transform(f, out):
+            try:
+                yield from _stream(f, source, out, chunk_size)
+            except ValueError as e:
+                raise CytoflowError(str(e))
+            
+        if out is None:
+            return transform(f, None)
+        
+        for _ in transform(f, out):
+            pass
+        return out
+
+    def buffer(self, headroom = 1.0):
+        """
+        A `LogicleBuffer` with this scale's parameters, for events that are
+        still arriving (eg. during acquisition.)  Its `T` starts at this 
+        scale's and grows with the data, unless it's the channel's range 
+        from the experiment's metadata; `W`, `M` and `A` stay put.
+        """
+        
+        if self._logicle is Undefined:
+            raise CytoflowError("The scale's parameters aren't set")
+        
+        grow = not (self.channel and self.channel in self.experiment.channels
+                    and "range" in self.experiment.metadata[self.channel])
+        return LogicleBuffer(self._T, self.W, self.M, self.A, mode = self.mode,
+                             headroom = headroom, grow = grow)
+        
+    def histogram(self, data, bins, range):
+        """
+        Counts `data` into `bins` bins evenly spaced on this scale, from
+        `range[0]` to `range[1]` (both scale values.)  Like `numpy.histogram`
+        on the scaled data, but the data is never scaled all at once: the
+        native code scales a block of it at a time and counts it as it goes.
+        Values outside `range` and NaN aren't counted.
+        
+        Returns the counts, as a float64 array.
+        """
+        
+        if self._logicle is Undefined:
+            raise CytoflowError("The scale's parameters aren't set")
+        
+        data = np.ascontiguousarray(data, dtype = np.float64).reshape(-1)
+        counts = np.zeros(int(bins))
+        try:
+            histogram(self._logicle, data, float(range[0]), float(range[1]), counts)
+        except ValueError as e:
+            raise CytoflowError(str(e))
+        return counts
+    
+    def histogram2d(self, x, y, yscale, bins, range):
+        """
+        The two-dimensional version of `histogram`: counts the pairs of 
+        values in `x` (on this scale) and `y` (on `yscale`, another
+        `LogicleScale`) into `bins[0]` by `bins[1]` bins, evenly spaced on 
+        the scales from `range[0][0]` to `range[0][1]` and `range[1][0]` 
+        to `range[1][1]`.  Like `numpy.histogram2d`, the counts come back 
+        as a float64 array with a row for each x bin.
+        """
+        
+        if self._logicle is Undefined or yscale._logicle is Undefined:
+            raise CytoflowError("The scales' parameters aren't set")
+        
+        x = np.ascontiguousarray(x, dtype = np.float64).reshape(-1)
+        y = np.ascontiguousarray(y, dtype = np.float64).reshape(-1)
+        counts = np.zeros((int(bins[0]), int(bins[1])))
+        try:
+            histogram2d(self._logicle, x, float(range[0][0]), float(range[0][1]),
+                        yscale._logicle, y, float(range[1][0]), float(range[1][1]),
+                        int(bins[0]), counts)
+        except ValueError as e:
+            raise CytoflowError(str(e))
+        return counts
+        
+    def density(self, x, y, yscale, cells = None):
+        """
+        Counts the pairs of values in `x` (on this scale) and `y` (on 
+        `yscale`, another `LogicleScale`) into a fine grid of `cells` by
+        `cells` cells, which a density plot can then re-bin at any zoom 
+        without going back to the data: `grid.raster(xlo, xhi, xbins, 
+        ylo, yhi, out)` sums the cells into `out`, a float64 array of 
+        `xbins` by `ybins` bins evenly spaced on the scales.  More events
+        can be counted into the grid with `grid.add(x, y)`.
+        
+        Returns the grid.
+        """
+        
+        if self._logicle is Undefined or yscale._logicle is Undefined:
+            raise CytoflowError("The scales' parameters aren't set")
+        
+        x = np.ascontiguousarray(x, dtype = np.float64).reshape(-1)
+        y = np.ascontiguousarray(y, dtype = np.float64).reshape(-1)
+        try:
+            if cells is None:
+                grid = DensityGrid(self._logicle, yscale._logicle)
+            else:
+                grid = DensityGrid(self._logicle, yscale._logicle, int(cells))
+            grid.add(x, y)
+        except ValueError as e:
+            raise CytoflowError(str(e))
+        return grid
+        
+    def gate_axis(self):
+        if self._logicle is Undefined:
+            raise CytoflowError("The scale's parameters aren't set")
+        return GateAxis.clipped(self._logicle)
         
     def clip(self, data):
         try:
-            logicle_min = self._logicle.inverse(0.0)
-            logicle_max = self._logicle.inverse(1.0 - sys.float_info.epsilon)
+            logicle_min, logicle_max = self._limits
             if isinstance(data, pd.Series):            
                 return data.clip(logicle_min, logicle_max)
             elif isinstance(data, np.ndarray):
@@ -224,8 +479,7 @@ class LogicleScale(HasStrictTraits):
         class LogicleNormalize(matplotlib.colors.Normalize):
             def __init__(self, scale = None, vmin = None, vmax = None):
                 self._scale = scale
-                self.vmin = scale.inverse(0.0)
-                self.vmax = scale.inverse(1.0 - sys.float_info.epsilon)
+                self.vmin, self.vmax = scale._limits
                 
             def __call__(self, data, clip = None):
                 # it turns out that Logicle is already defined as a
@@ -245,7 +499,10 @@ class LogicleScale(HasStrictTraits):
         if self.channel and self.channel in self.experiment.channels:
             if "range" in self.experiment.metadata[self.channel]:
                 return float(self.experiment.metadata[self.channel]["range"])
+            elif self._stats is not None:
+                return float(self._stats.maximum())
             else:
+                # r is bad, but that's W's problem, not T's
                 return float(self.experiment.data[self.channel].max())
         elif self.condition and self.condition in self.experiment.conditions:
             return float(self.experiment.data[self.condition].max())
@@ -281,15 +538,12 @@ class LogicleScale(HasStrictTraits):
             return self._W
         
         if self.channel and self.channel in self.experiment.channels:
-            data = self.experiment[self.channel]
-            
             if self.r <= 0 or self.r >= 1:
                 raise CytoflowError("r must be between 0 and 1")
             
             # get the range by finding the rth quantile of the negative values
-            neg_values = data[data < 0]
-            if(not neg_values.empty):
-                r_value = neg_values.quantile(self.r)
+            if self._stats.negatives() > 0:
+                r_value = self._stats.negativeQuantile()
                 W = (self.M - math.log10(self._T/math.fabs(r_value)))/2
                 if W <= 0:
                     warn("Channel {0} doesn't have enough negative data. " 
@@ -313,13 +567,26 @@ class LogicleScale(HasStrictTraits):
     def _set_W(self, value):
         self._W = value
         
+    @cached_property
+    def _get__stats(self):
+        if self.experiment is None or self.channel not in self.experiment.channels:
+            return None
+        
+        # there's no quantile to take; _get_W says so
+        if self.r <= 0 or self.r >= 1:
+            return None
+        
+        data = self.experiment.data[self.channel].values
+        dtype = np.float32 if data.dtype == np.float32 else np.float64
+        return ChannelStats(np.ascontiguousarray(data, dtype = dtype), self.r)
+        
     @cached_property
     def _get__logicle(self):
         if self.W is Undefined or self._T is Undefined:
             return Undefined
         
-        if self._T <= 0:
-            raise CytoflowError("Logicle range must be > 0")
+        if not self._T > 0 or math.isinf(self._T):
+            raise CytoflowError("Logicle range must be > 0 and finite")
         
         if self.W < 0:
             raise CytoflowError("Logicle param W must be >= 0")
@@ -334,20 +601,188 @@ class LogicleScale(HasStrictTraits):
         if (-self.A > self.W or self.A + self.W > self.M - self.W):
             raise CytoflowError("Logicle param A is too large.")
          
+        if self.mode == "accurate":
+            return HermiteLogicle(self._T, self.W, self.M, self.A)
+        
         return FastLogicle(self._T, self.W, self.M, self.A)
     
+    @cached_property
+    def _get__limits(self):
+        if self._logicle is Undefined:
+            return Undefined
+        
+        limits = _batch(self._logicle.inverse, [0.0, 1.0 - sys.float_info.epsilon])
+        return (float(limits[0]), float(limits[1]))
+    
     def get_mpl_params(self, ax):
         return {"logicle" : self._logicle} 
     
 register_scale(LogicleScale)
+
+class LogicleBuffer(object):
+    """
+    A growing column of events and their logicle-scaled values, for data 
+    that arrives a chunk at a time.  `append` scales only the events it's 
+    given, in one native call, so keeping a live plot up to date costs the
+    new events rather than all of them.
+    
+    If an event is larger than `T` (and `grow` is set), `T` becomes that 
+    event's value times `headroom`, which changes the transform for every 
+    event.  There's no shortcut from the old scaled values to the new ones
+    -- they're a function of the data over `T`, so remapping one to the 
+    other is an inverse and a transform, which is no cheaper than scaling 
+    the data again -- so instead the events scaled with the old parameters
+    are marked stale, and `scaled` re-scales them in one pass the next time
+    it's asked for.  However many times `T` grows in between, each event 
+    is re-scaled at most once.  A `headroom` more than 1 makes `T` grow 
+    less often, at the cost of some unused display range at the top.
+    
+    Attributes
+    ----------
+    T, W, M, A : Float
+        The logicle parameters, as for `LogicleScale`.  Only `T` changes.
+        
+    mode : Enum("fast", "accurate") (default = "fast")
+        How closely to compute the transform, as for `LogicleScale`.
+        
+    headroom : Float (default = 1.0)
+        When an event is larger than `T`, `T` grows to that event times 
+        this.
+        
+    grow : Bool (default = True)
+        Whether `T` grows at all.  If not, events past `T` are clipped to 
+        the top of the scale, as `LogicleScale` does.
+    """
+    
+    def __init__(self, T, W, M = 4.5, A = 0.0, mode = "fast", 
+                 headroom = 1.0, grow = True):
+        if headroom < 1:
+            raise CytoflowError("headroom must be at least 1")
+        if mode not in ("fast", "accurate"):
+            raise CytoflowError("mode must be 'fast' or 'accurate'")
+        
+        self.W = W
+        self.M = M
+        self.A = A
+        self.mode = mode
+        self.headroom = headroom
+        self.grow = grow
+        
+        self._raw = np.empty(0)
+        self._scaled = np.empty(0)
+        self._events = 0
+        
+        # the first _stale events were scaled with an earlier T
+        self._stale = 0
+        self._set_T(T)
+        
+    def _set_T(self, T):
+        try:
+            if self.mode == "accurate":
+                self._logicle = HermiteLogicle(float(T), self.W, self.M, self.A)
+            else:
+                self._logicle = FastLogicle(float(T), self.W, self.M, self.A)
+        except ValueError as e:
+            raise CytoflowError(str(e)) from e
+        self._T = float(T)
+        self._stale = self._events
+        
+    def _reserve(self, events):
+        # double the buffers, so that appending is amortized constant time
+        if events <= len(self._raw):
+            return
+        size = max(events, 2 * len(self._raw), 1024)
+        for name in ["_raw", "_scaled"]:
+            old = getattr(self, name)
+            new = np.empty(size)
+            new[:self._events] = old[:self._events]
+            setattr(self, name, new)
+        
+    @property
+    def T(self):
+        return self._T
+    
+    @property
+    def logicle(self):
+        "The `FastLogicle` (or `HermiteLogicle`) with the current parameters"
+        return self._logicle
+    
+    def __len__(self):
+        return self._events
+        
+    def append(self, events):
+        """
+        Add `events` (an array-like of data values) to the end of the 
+        buffer, and scale them.
+        """
+        
+        events = np.ascontiguousarray(events, dtype = np.float64).reshape(-1)
+        if len(events) == 0:
+            return
+        
+        begin = self._events
+        end = begin + len(events)
+        self._reserve(end)
+        
+        raw = self._raw[begin:end]
+        raw[:] = events
+        self._events = end
+        
+        # the events off the table come back for free, and any of them 
+        # past the top of it are past T
+        outside = self._logicle.scaleOutside(raw, self._scaled[begin:end],
+                                             FastLogicle.CLIP_OUTSIDE)
+        if self.grow and outside:
+            high = raw[outside]
+            high = high[np.isfinite(high) & (high > self._T)]
+            if len(high) > 0:
+                self._set_T(high.max() * self.headroom)
+                
+    @property
+    def raw(self):
+        "The data values appended so far (a read-only view)"
+        ret = self._raw[:self._events]
+        ret.flags.writeable = False
+        return ret
+        
+    @property
+    def scaled(self):
+        """
+        The scaled values of the events appended so far, with the current
+        parameters (a read-only view, good until the next `append`.)
+        """
+        
+        if self._stale:
+            stale = self._stale
+            self._logicle.clipScale(self._raw[:stale], self._scaled[:stale])
+            self._stale = 0
+            
+        ret = self._scaled[:self._events]
+        ret.flags.writeable = False
+        return ret
         
 class MatplotlibLogicleScale(HasTraits, matplotlib.scale.ScaleBase):   
     name = "logicle"
     
     logicle = Instance(FastLogicle)
+    
+    # the last view's ticks, (logicle, (vmin, vmax), (major, minor))
+    _ticks = Any
 
     def __init__(self, axis, **kwargs):
         HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
+        
+    def axis_ticks(self, vmin, vmax):
+        """
+        The major and minor ticks for a view from `vmin` to `vmax`, as 
+        lists.  Both locators ask for them on every redraw, so the ticks
+        for the last view are kept rather than laid out twice.
+        """
+        view = (float(vmin), float(vmax))
+        if self._ticks is None or self._ticks[0] is not self.logicle \
+           or self._ticks[1] != view:
+            self._ticks = (self.logicle, view, self.logicle.axisTicks(*view))
+        return self._ticks[2]
     
     def get_transform(self):
         """
@@ -399,22 +834,16 @@ class MatplotlibLogicleScale(HasTraits, matplotlib.scale.ScaleBase):
         def transform_non_affine(self, values):
             
             try:        
-                logicle_min = self.logicle.inverse(0.0)
-                logicle_max = self.logicle.inverse(1.0 - sys.float_info.epsilon)
                 if isinstance(values, pd.Series):            
-                    values = values.clip(logicle_min, logicle_max)
-                    return values.apply(self.logicle.scale)
+                    return pd.Series(_batch(self.logicle.clipScale, values.values),
+                                     index = values.index,
+                                     name = values.name)
                 elif isinstance(values, np.ndarray):
-                    values = np.clip(values, logicle_min, logicle_max)
-                    scale = np.vectorize(self.logicle.scale)
-                    return scale(values)
+                    return _batch(self.logicle.clipScale, values)
                 elif isinstance(values, float):
-                    data = max(min(values, logicle_max), logicle_min)
-                    return self.logicle.scale(data)
+                    return self.logicle.clipScale(values)
                 elif isinstance(values, int):
-                    data = float(data)
-                    data = max(min(values, logicle_max), logicle_min)
-                    return self.logicle.scale(data)
+                    return self.logicle.clipScale(float(values))
                 else:
                     raise CytoflowError("Unknown data type in MatplotlibLogicleScale.transform_non_affine")
                 
@@ -439,21 +868,26 @@ class MatplotlibLogicleScale(HasTraits, matplotlib.scale.ScaleBase):
             HasTraits.__init__(self, **kwargs)  # @UndefinedVariable
         
         def transform_non_affine(self, values):
+            # these are (mostly) ticks, view limits and positions on the 
+            # plot, such as gate vertices, so use the exact inverse instead
+            # of the table's:  there are only a few of them, and they're
+            # worth getting exactly right.
             try:
                 if isinstance(values, pd.Series):            
                     values = values.clip(0, 1.0 - sys.float_info.epsilon)
-                    return values.apply(self.logicle.inverse)
+                    return pd.Series(_exact(self.logicle, values.values),
+                                     index = values.index,
+                                     name = values.name)
                 elif isinstance(values, np.ndarray):
                     values = np.clip(values, 0, 1.0 - sys.float_info.epsilon)
-                    inverse = np.vectorize(self.logicle.inverse)
-                    return inverse(values)
+                    return _exact(self.logicle, values)
                 elif isinstance(values, float):
                     values = max(min(values, 1.0 - sys.float_info.epsilon), 0.0)
-                    return self.logicle.inverse(values)
+                    return float(_exact(self.logicle, [values])[0])
                 elif isinstance(values, int):
                     values = float(values)
                     values = max(min(values, 1.0 - sys.float_info.epsilon), 0.0)
-                    return self.logicle.inverse(values)
+                    return float(_exact(self.logicle, [values])[0])
                 else:
                     raise CytoflowError("Unknown data type in LogicleScale.inverse")
             except ValueError as e:
@@ -481,21 +915,9 @@ class LogicleMajorLocator(Locator):
     def tick_values(self, vmin, vmax):
         'Every decade, including 0 and negative'
      
-        vmin, vmax = self.view_limits(vmin, vmax)
-        logicle = self.axis._scale.logicle
-        
-        max_decade = np.ceil(np.log10(vmax * 1.1))
-        min_positive_decade = np.ceil(np.log10(logicle.T()) - logicle.M()) + 1
-                
-        if vmin < 0:
-            max_negative_decade = np.floor(np.log10(-1.0 * vmin))
-            major_ticks = [-1.0 * 10 ** x for x in np.arange(max_negative_decade, 1, -1)]
-            major_ticks.append(0.0)
-        else:
-            max_negative_decade = "N/A"
-            major_ticks = [0.0] if vmin == 0.0 else []
-            
-        major_ticks.extend([10 ** x for x in np.arange(min_positive_decade, max_decade, 1)])
+        # the whole layout (including view_limits()) in one native call,
+        # shared with the minor locator
+        major_ticks, _ = self.axis._scale.axis_ticks(vmin, vmax)
 
         return self.raise_if_exceeds(np.asarray(major_ticks))
 
@@ -539,25 +961,7 @@ class LogicleMinorLocator(Locator):
     def tick_values(self, vmin, vmax):
         'Every tenth decade, including 0 and negative'
 
-        vmin, vmax = self.view_limits(vmin, vmax)
-        logicle = self.axis._scale.logicle
-        
-        max_decade = np.ceil(np.log10(vmax * 1.1)) + 1
-        min_positive_decade = np.ceil(np.log10(logicle.T()) - logicle.M()) + 1
-                
-        if vmin < 0:
-            max_negative_decade = np.floor(np.log10(-1.0 * vmin)) + 1
-            major_ticks = [-1.0 * 10 ** x for x in np.arange(max_negative_decade, 1, -1)]
-            major_ticks.append(0.0)
-        else:
-            max_negative_decade = "N/A"
-            major_ticks = [0.0] if vmin == 0.0 else []
-            
-        major_ticks.extend([10 ** x for x in np.arange(min_positive_decade, max_decade, 1)])
-                
-        major_tick_pairs = [(major_ticks[x], major_ticks[x+1]) for x in range(len(major_ticks) - 1)]
-        minor_ticks_lol = [np.arange(x, y, max(np.abs([x, y]) / 10)) for x, y in major_tick_pairs]
-        minor_ticks = [item for sublist in minor_ticks_lol for item in sublist]
+        _, minor_ticks = self.axis._scale.axis_ticks(vmin, vmax)
 
         return(minor_ticks)
     
@@ -103,6 +103,15 @@ class IScale(Interface):
         scale a color bar.
         """
         
+    def gate_axis(self):
+        """
+        Return a native ``GateAxis`` that transforms data onto this scale, so
+        that gates drawn on it (eg. polygons) can be evaluated on the data 
+        values in one native pass.  Optional: scales that don't have one
+        (or that return ``None``, eg. a log scale whose threshold isn't 
+        positive) are evaluated in Python instead.
+        """
+        
         
 class ScaleMixin(HasStrictTraits):
     def __init__(self, **kwargs):
@@ -193,3 +202,8 @@ import cytoflow.utility.logicle_scale  # @UnusedImport
 
 # import cytoflow.utility.hlog_scale     # @UnusedImport
 
+# the arcsinh scale (mostly for mass cytometry data) isn't registered by
+# default either.  import it the same way.
+
+# import cytoflow.utility.arcsinh_scale  # @UnusedImport
+
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3.4
+# coding: latin-1
+
+# (c) Massachusetts Institute of Technology 2015-2018
+# (c) Brian Teague 2018-2021
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+cytoflow.utility.transform_stats
+--------------------------------
+
+What the native transforms have been doing:  how often the exact logicle
+needs its Taylor series and how many iterations it takes, how many values
+fall off the fast transforms' lookup tables, how many tables are built and
+how long they take, and how often the transforms throw.  The extension only
+counts these when it's built with ``LOGICLE_STATS=True`` in the
+environment (see ``logicle_ext/stats.h``); otherwise they're all zero.
+'''
+
+import numpy as np
+
+from .logicle_ext.Logicle import (TransformStats,
+    LOGICLE_EXACT_SCALES, LOGICLE_TAYLOR_SCALES, LOGICLE_HALLEY_ITERATIONS,
+    LOGICLE_TABLE_VALUES, LOGICLE_TABLE_FALLBACKS, LOGICLE_TABLE_HITS,
+    LOGICLE_TABLE_BUILDS, LOGICLE_TABLE_BINS, LOGICLE_TABLE_NANOSECONDS,
+    LOGICLE_ILLEGAL_ARGUMENTS, LOGICLE_DID_NOT_CONVERGE,
+    LOGICLE_HALLEY_HISTOGRAM, LOGICLE_TABLE_HISTOGRAM)
+
+_counters = {"exact_scales" : LOGICLE_EXACT_SCALES,
+             "taylor_scales" : LOGICLE_TAYLOR_SCALES,
+             "halley_iterations" : LOGICLE_HALLEY_ITERATIONS,
+             "table_values" : LOGICLE_TABLE_VALUES,
+             "table_fallbacks" : LOGICLE_TABLE_FALLBACKS,
+             "table_hits" : LOGICLE_TABLE_HITS,
+             "table_builds" : LOGICLE_TABLE_BUILDS,
+             "table_bins" : LOGICLE_TABLE_BINS,
+             "table_nanoseconds" : LOGICLE_TABLE_NANOSECONDS,
+             "illegal_arguments" : LOGICLE_ILLEGAL_ARGUMENTS,
+             "did_not_converge" : LOGICLE_DID_NOT_CONVERGE}
+
+_histograms = {"halley_histogram" : LOGICLE_HALLEY_HISTOGRAM,
+               "table_histogram" : LOGICLE_TABLE_HISTOGRAM}
+
+def transform_stats(reset = False):
+    """
+    A snapshot of the native transforms' counters, across all threads, since
+    they were last reset.
+
+    Parameters
+    ----------
+    reset : bool (default = False)
+        Start counting from zero again after taking the snapshot.
+
+    Returns
+    -------
+    dict
+        ``enabled`` says whether the extension counts at all.  The counters
+        are ``exact_scales``, ``taylor_scales`` and ``halley_iterations``
+        (for the exact logicle's scale), ``table_values`` and
+        ``table_fallbacks`` (values the table transforms were asked for, and
+        those that were off the table), ``table_hits``, ``table_builds``,
+        ``table_bins`` and ``table_nanoseconds`` (tables found in the cache
+        or built), and ``illegal_arguments`` and ``did_not_converge``
+        (exceptions thrown).  ``halley_histogram`` counts the exact scales
+        by how many iterations they took, and ``table_histogram`` the tables
+        built by how long they took: element ``i`` counts those that took
+        between ``2 ** i`` and ``2 ** (i + 1)`` microseconds (and the first
+        and last elements anything quicker or slower.)
+    """
+
+    snapshot = TransformStats()
+    if reset:
+        TransformStats.reset()
+
+    ret = {"enabled" : TransformStats.enabled()}
+    for name, counter in _counters.items():
+        ret[name] = int(snapshot.count(counter))
+    for name, histogram in _histograms.items():
+        ret[name] = np.array(snapshot.histogram(histogram), dtype = np.int64)
+    return ret
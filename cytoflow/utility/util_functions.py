@@ -66,14 +66,37 @@ def num_hist_bins(a):
         The number of bins in the histogram
     """
     a = np.asarray(a)
-    h = 2 * iqr(a) / (len(a) ** (1 / 3))
+    return num_hist_bins_from_percentiles(np.nanpercentile(a, [1, 25, 75, 99]), len(a))
+
+def num_hist_bins_from_percentiles(p, n):
+    """
+    Calculate number of histogram bins using Freedman-Diaconis rule, like
+    `num_hist_bins`, from the 1st, 25th, 75th and 99th percentiles of the
+    data and the number of values in it.  (The percentiles of data on
+    a monotone scale are its percentiles on that scale, so they can be
+    found without scaling all of it.)
+    
+    Parameters
+    ----------
+    p : sequence of four floats
+        The 1st, 25th, 75th and 99th percentiles of the data
+        
+    n : int
+        The number of values in the data
+        
+    Returns
+    -------
+    int
+        The number of bins in the histogram
+    """
+    p1, q1, q3, p99 = p
+    h = 2 * (q3 - q1) / (n ** (1 / 3))
       
     # fall back to 10 bins if iqr is 0
     if h == 0:
         return 10.
     else:
-        return np.ceil((np.nanpercentile(a, 99) - 
-                        np.nanpercentile(a, 1)) / h)
+        return np.ceil((p99 - p1) / h)
     
 def geom_mean(a):
     """
@@ -22,12 +22,13 @@ cytoflow.views.densityplot
 --------------------------
 """
 
-from traits.api import provides, Constant
+from traits.api import provides, Constant, Any
 
 import matplotlib.pyplot as plt
 import numpy as np
 import scipy.ndimage.filters
 import copy
+import weakref
 
 import cytoflow.utility as util
 from .i_view import IView
@@ -90,6 +91,11 @@ class DensityView(Base2DView):
     
     huefacet = Constant(None)
     
+    # the density grids from the last plot on logicle scales, so that
+    # plotting the same data with different limits (eg. zooming in the GUI)
+    # only has to re-bin them
+    _density = Any(transient = True)
+    
     def plot(self, experiment, **kwargs):
         """
         Plot a faceted density plot view of a channel
@@ -158,14 +164,29 @@ class DensityView(Base2DView):
         xbins = xscale.inverse(np.linspace(xscale(xlim[0]), xscale(xlim[1]), gridsize))
         ybins = yscale.inverse(np.linspace(yscale(ylim[0]), yscale(ylim[1]), gridsize))
   
+        # on logicle scales, each facet's events are counted into a fine
+        # density grid once, and the grid is re-binned for these limits
+        rasters = None
+        if xscale.name == "logicle" and yscale.name == "logicle":
+            rasters = {}
+            for (row_i, col_j), density in self._density_grids(experiment, grid, xscale, yscale).items():
+                h = np.empty((gridsize - 1, gridsize - 1))
+                density.raster(xscale(xlim[0]), xscale(xlim[1]), gridsize - 1,
+                               yscale(ylim[0]), yscale(ylim[1]), h)
+                rasters[grid.facet_axis(row_i, col_j)] = h
+            kwargs['rasters'] = rasters
+  
         # set up the range of the color map
         if 'norm' not in kwargs:
             data_max = 0
-            for _, data_ijk in grid.facet_data():
-                x = data_ijk[self.xchannel]
-                y = data_ijk[self.ychannel]
-                h, _, _ = np.histogram2d(x, y, bins=[xbins, ybins])
-                data_max = max(data_max, h.max())
+            if rasters is not None:
+                data_max = max([h.max() for h in rasters.values()] + [0])
+            else:
+                for _, data_ijk in grid.facet_data():
+                    x = data_ijk[self.xchannel]
+                    y = data_ijk[self.ychannel]
+                    h, _, _ = np.histogram2d(x, y, bins=[xbins, ybins])
+                    data_max = max(data_max, h.max())
                 
             hue_scale = util.scale_factory(self.huescale, 
                                            experiment, 
@@ -181,10 +202,48 @@ class DensityView(Base2DView):
                     cmap = kwargs['cmap'], 
                     norm = kwargs['norm'])
         
+    def _density_grids(self, experiment, grid, xscale, yscale):
+        """
+        Count each facet of the grid into a density grid, or return the 
+        ones from the last plot if it plotted the same data on the same
+        scales.
+        """
+        
+        # the grids are counted on the scales' transforms, so key on those
+        # (including the table's bins and whether it's fast or accurate)
+        def transform(scale):
+            logicle = scale._logicle
+            return (type(logicle).__name__, logicle.T(), logicle.W(), 
+                    logicle.M(), logicle.A(), logicle.bins())
+        
+        key = (self.xchannel, self.ychannel, self.xfacet, self.yfacet, 
+               self.subset, len(grid.data), transform(xscale), transform(yscale))
+        
+        if self._density and self._density[0]() is experiment and self._density[1] == key:
+            return self._density[2]
+        
+        grids = {}
+        for (row_i, col_j, _), data_ijk in grid.facet_data():
+            if not data_ijk.values.size:
+                continue
+            grids[(row_i, col_j)] = xscale.density(data_ijk[self.xchannel],
+                                                   data_ijk[self.ychannel],
+                                                   yscale)
+            
+        # only a weak reference to the experiment, so that the view doesn't
+        # keep every event of the last one it plotted alive
+        self._density = (weakref.ref(experiment), key, grids)
+        return grids
+        
         
 def _densityplot(x, y, xbins, ybins, **kwargs):
     
-    h, X, Y = np.histogram2d(x, y, bins=[xbins, ybins])
+    rasters = kwargs.pop('rasters', None)
+    if rasters is not None:
+        h = rasters[plt.gca()]
+        X, Y = xbins, ybins
+    else:
+        h, X, Y = np.histogram2d(x, y, bins=[xbins, ybins])
     
     smoothed = kwargs.pop('smoothed', False)
     smoothed_sigma = kwargs.pop('smoothed_sigma', 1)
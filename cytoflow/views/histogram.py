@@ -30,6 +30,7 @@ import math
 import bottleneck
 
 import cytoflow.utility as util
+from cytoflow.utility.algorithms import percentiles
 from .i_view import IView
 from .base_views import Base1DView
 
@@ -130,9 +131,27 @@ class HistogramView(Base1DView):
         scale = kwargs.pop('scale')[self.channel]
         lim = kwargs.pop('lim')[self.channel]
         
-        scaled_data = scale(experiment[self.channel])
-        num_bins = kwargs.pop('num_bins', util.num_hist_bins(scaled_data))
-        num_bins = util.num_hist_bins(scaled_data) if num_bins is None else num_bins
+        # a logicle scale is monotone, so the scaled data's percentiles are
+        # the data's percentiles, scaled.  find those (and the ends of the
+        # data) on the data, rather than scaling the whole column: natively,
+        # unless there are NaNs, which make them all NaN.
+        data = experiment[self.channel]
+        if scale.name == "logicle":
+            pcts = [0, 1, 25, 75, 99, 100]
+            data_pcts = percentiles(data, pcts)
+            if np.isnan(data_pcts).any():
+                data_pcts = np.nanpercentile(data, pcts)
+            scaled_pcts = np.asarray(scale(np.asarray(data_pcts)))
+            xmin, xmax = scaled_pcts[0], scaled_pcts[-1]
+            default_bins = util.num_hist_bins_from_percentiles(scaled_pcts[1:-1], len(data))
+        else:
+            scaled_data = scale(data)
+            xmin = bottleneck.nanmin(scaled_data)
+            xmax = bottleneck.nanmax(scaled_data)
+            default_bins = util.num_hist_bins(scaled_data)
+            
+        num_bins = kwargs.pop('num_bins', default_bins)
+        num_bins = default_bins if num_bins is None else num_bins
         
         # clip num_bins to (100, 1000)
         num_bins = max(min(num_bins, 1000), 100)
@@ -166,10 +185,16 @@ class HistogramView(Base1DView):
                                                      endpoint = False))
 
             bins = scale.inverse(new_bins)
+            scaled_range = None
         else:
-            xmin = bottleneck.nanmin(scaled_data)
-            xmax = bottleneck.nanmax(scaled_data)
             bins = scale.inverse(np.linspace(xmin, xmax, num=int(num_bins), endpoint = True))
+            
+            # these bins are evenly spaced on the scale, so a logicle
+            # scale can count the data into them natively, without
+            # scaling it first -- unless the caller passed their own
+            scaled_range = ((xmin, xmax)
+                            if scale.name == "logicle" and xmin < xmax 
+                               and 'bins' not in kwargs else None)
                     
         kwargs.setdefault('bins', bins) 
         kwargs.setdefault('orientation', 'vertical')
@@ -188,10 +213,22 @@ class HistogramView(Base1DView):
             # of it.
             
             bins = kwargs.get('bins')
+            
+            if scaled_range is not None and len(args) == 1 and 'weights' not in kwargs:
+                counts = scale.histogram(args[0], len(bins) - 1, scaled_range)
+                if scale.name != "linear" and kwargs.get("density"):
+                    kwargs["density"] = False
+                    counts = counts / np.sum(counts)
+                n, _, _ = plt.hist(bins[:-1], weights = counts, **kwargs)
+                count_max.append(max(n))
+                return
+            
+            # keep the events on the outer edges, which hist() (and the
+            # native count above) put in the first and last bins
             new_args = []
             for x in args:
-                x = x[x > bins[0]]
-                x = x[x < bins[-1]]
+                x = x[x >= bins[0]]
+                x = x[x <= bins[-1]]
                 new_args.append(x)
                 
             if scale.name != "linear" and kwargs.get("density"):
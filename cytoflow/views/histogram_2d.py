@@ -128,6 +128,13 @@ class Histogram2DView(Base2DView):
         ybins = yscale.inverse(np.linspace(yscale(ylim[0]), yscale(ylim[1]), gridsize))
       
         kwargs.setdefault('smoothed', False)
+        
+        # these bins are evenly spaced on the scales, so logicle scales can
+        # count the data into them natively, without scaling it first
+        if xscale.name == "logicle" and yscale.name == "logicle":
+            kwargs['native'] = (xscale, yscale,
+                                (xscale(xlim[0]), xscale(xlim[1])),
+                                (yscale(ylim[0]), yscale(ylim[1])))
            
         grid.map(_hist2d, self.xchannel, self.ychannel, xbins = xbins, ybins = ybins, **kwargs)
         
@@ -138,7 +145,15 @@ class Histogram2DView(Base2DView):
 
 def _hist2d(x, y, xbins, ybins, **kwargs):
 
-    h, X, Y = np.histogram2d(x, y, bins=[xbins, ybins])
+    native = kwargs.pop('native', None)
+    if native:
+        xscale, yscale, xrange, yrange = native
+        h = xscale.histogram2d(x, y, yscale, 
+                               bins = (len(xbins) - 1, len(ybins) - 1),
+                               range = (xrange, yrange))
+        X, Y = xbins, ybins
+    else:
+        h, X, Y = np.histogram2d(x, y, bins=[xbins, ybins])
     
     smoothed = kwargs.pop('smoothed', False)
     smoothed_sigma = kwargs.pop('smoothed_sigma', 1)
@@ -26,7 +26,6 @@ from traits.api import provides, Constant
 import matplotlib.pyplot as plt
 
 import numpy as np
-from sklearn.neighbors import KernelDensity
 from statsmodels.nonparametric.bandwidths import bw_scott, bw_silverman
 
 import cytoflow.utility as util
@@ -176,11 +175,12 @@ def _univariate_kdeplot(data, scale=None, shade=False, kernel="gaussian",
     
     support = _kde_support(scaled_data, bw, gridsize, cut, clip)[:, np.newaxis]
 
-    kde = KernelDensity(kernel = kernel, bandwidth = bw).fit(scaled_data.to_numpy()[:, np.newaxis])
-    log_density = kde.score_samples(support)
+    try:
+        y = util.kde_density(scaled_data, support[:, 0], kernel = kernel, bw = bw)
+    except util.CytoflowError as e:
+        raise util.CytoflowViewError(None, str(e)) from e
 
     x = scale.inverse(support[:, 0])
-    y = np.exp(log_density)
 
     # Check if a label was specified in the call
     label = kwargs.pop("label", None)
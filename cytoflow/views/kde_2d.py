@@ -26,7 +26,6 @@ from traits.api import provides, Constant
 
 import matplotlib.pyplot as plt
 import numpy as np
-from sklearn.neighbors import KernelDensity
 from statsmodels.nonparametric.bandwidths import bw_scott, bw_silverman
 
 import cytoflow.utility as util
@@ -178,15 +177,13 @@ def _bivariate_kdeplot(x, y, xscale=None, yscale=None, shade=False,
         raise util.CytoflowViewError(None,
                                      "Bandwith must be 'scott', 'silverman' or a float")
 
-    kde = KernelDensity(bandwidth = bw, kernel = 'gaussian').fit(np.column_stack((x, y)))
-    
     x_support = _kde_support(x, bw_x, gridsize, cut, clip[0])
     y_support = _kde_support(y, bw_y, gridsize, cut, clip[1])
     
-    xx, yy = np.meshgrid(x_support, y_support)
-    z = kde.score_samples(np.column_stack((xx.ravel(), yy.ravel())))
-    z = z.reshape(xx.shape)
-    z = np.exp(z)
+    try:
+        z = util.kde_density_2d(x, y, x_support, y_support, bw = bw)
+    except util.CytoflowError as e:
+        raise util.CytoflowViewError(None, str(e)) from e
 
     n_levels = kwargs.pop("n_levels", 10)
     color = kwargs.pop("color")
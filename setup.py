@@ -18,13 +18,17 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 from setuptools import setup, find_packages, Extension
-import io, os
+import io, os, sys
 
 import versioneer
     
 on_rtd = os.environ.get('READTHEDOCS', None) == 'True'
 no_logicle = os.environ.get('NO_LOGICLE', None) == 'True'
 
+# count what the Logicle extension's transforms do (see logicle_ext/stats.h).
+# it's cheap, but not free, so it's off unless asked for.
+logicle_stats = os.environ.get('LOGICLE_STATS', None) == 'True'
+
 here = os.path.abspath(os.path.dirname(__file__))
 
 def read_rst(*filenames, **kwargs):
@@ -90,11 +94,73 @@ setup(
     ext_modules = [Extension("cytoflow.utility.logicle_ext._Logicle",
                              sources = ["cytoflow/utility/logicle_ext/FastLogicle.cpp",
                                         "cytoflow/utility/logicle_ext/Logicle.cpp",
+                                        "cytoflow/utility/logicle_ext/HermiteLogicle.cpp",
+                                        "cytoflow/utility/logicle_ext/FastHlog.cpp",
+                                        "cytoflow/utility/logicle_ext/Hlog.cpp",
+                                        "cytoflow/utility/logicle_ext/Histogram.cpp",
+                                        "cytoflow/utility/logicle_ext/FastArcsinh.cpp",
+                                        "cytoflow/utility/logicle_ext/Arcsinh.cpp",
+                                        "cytoflow/utility/logicle_ext/Density.cpp",
+                                        "cytoflow/utility/logicle_ext/Gate.cpp",
+                                        "cytoflow/utility/logicle_ext/Statistics.cpp",
+                                        "cytoflow/utility/logicle_ext/Columns.cpp",
+                                        "cytoflow/utility/logicle_ext/Kde.cpp",
+                                        "cytoflow/utility/logicle_ext/Clusters.cpp",
+                                        "cytoflow/utility/logicle_ext/Stats.cpp",
+                                        "cytoflow/utility/logicle_ext/Fcs.cpp",
+                                        "cytoflow/utility/logicle_ext/Kernels.cpp",
+                                        "cytoflow/utility/logicle_ext/Mapping.cpp",
+                                        "cytoflow/utility/logicle_ext/Table.cpp",
+                                        "cytoflow/utility/logicle_ext/Threads.cpp",
+                                        "cytoflow/utility/logicle_ext/Transform.cpp",
                                         "cytoflow/utility/logicle_ext/Logicle.i"],
                              depends = ["cytoflow/utility/logicle_ext/FastLogicle.cpp",
                                         "cytoflow/utility/logicle_ext/Logicle.cpp",
+                                        "cytoflow/utility/logicle_ext/HermiteLogicle.cpp",
+                                        "cytoflow/utility/logicle_ext/FastHlog.cpp",
+                                        "cytoflow/utility/logicle_ext/Hlog.cpp",
+                                        "cytoflow/utility/logicle_ext/Histogram.cpp",
+                                        "cytoflow/utility/logicle_ext/FastArcsinh.cpp",
+                                        "cytoflow/utility/logicle_ext/Arcsinh.cpp",
+                                        "cytoflow/utility/logicle_ext/Density.cpp",
+                                        "cytoflow/utility/logicle_ext/Gate.cpp",
+                                        "cytoflow/utility/logicle_ext/Statistics.cpp",
+                                        "cytoflow/utility/logicle_ext/Columns.cpp",
+                                        "cytoflow/utility/logicle_ext/Kde.cpp",
+                                        "cytoflow/utility/logicle_ext/Clusters.cpp",
+                                        "cytoflow/utility/logicle_ext/Stats.cpp",
+                                        "cytoflow/utility/logicle_ext/Fcs.cpp",
+                                        "cytoflow/utility/logicle_ext/Kernels.cpp",
+                                        "cytoflow/utility/logicle_ext/Mapping.cpp",
+                                        "cytoflow/utility/logicle_ext/Table.cpp",
+                                        "cytoflow/utility/logicle_ext/Threads.cpp",
+                                        "cytoflow/utility/logicle_ext/Transform.cpp",
                                         "cytoflow/utility/logicle_ext/Logicle.i",
-                                        "cytoflow/utility/logicle_ext/logicle.h"],
+                                        "cytoflow/utility/logicle_ext/logicle.h",
+                                        "cytoflow/utility/logicle_ext/arcsinh.h",
+                                        "cytoflow/utility/logicle_ext/density.h",
+                                        "cytoflow/utility/logicle_ext/gate.h",
+                                        "cytoflow/utility/logicle_ext/statistics.h",
+                                        "cytoflow/utility/logicle_ext/columns.h",
+                                        "cytoflow/utility/logicle_ext/kde.h",
+                                        "cytoflow/utility/logicle_ext/clusters.h",
+                                        "cytoflow/utility/logicle_ext/stats.h",
+                                        "cytoflow/utility/logicle_ext/fcs.h",
+                                        "cytoflow/utility/logicle_ext/hlog.h",
+                                        "cytoflow/utility/logicle_ext/histogram.h",
+                                        "cytoflow/utility/logicle_ext/kernels.h",
+                                        "cytoflow/utility/logicle_ext/kernels.inc",
+                                        "cytoflow/utility/logicle_ext/mapping.h",
+                                        "cytoflow/utility/logicle_ext/table.h",
+                                        "cytoflow/utility/logicle_ext/threads.h",
+                                        "cytoflow/utility/logicle_ext/transform.h"],
+                             # keep the compiler from fusing multiply-adds, so
+                             # the vector kernels round the same way as the
+                             # scalar code
+                             extra_compile_args = [] if sys.platform == 'win32'
+                                                  else ['-ffp-contract=off'],
+                             define_macros = [('LOGICLE_STATS', None)] if logicle_stats
+                                             else [],
                              swig_opts=['-c++', '-py3'])] \
                 if not (on_rtd or no_logicle) else None,
     
@@ -135,6 +201,7 @@ setup(
                  'Topic :: Software Development :: Libraries :: Python Modules'],
     
     entry_points={'console_scripts' : ['cf-channel_voltages = cytoflow.scripts.channel_voltages:main',
-                                       'cf-fcs_metadata = cytoflow.scripts.fcs_metadata:main'],
+                                       'cf-fcs_metadata = cytoflow.scripts.fcs_metadata:main',
+                                       'cf-benchmark = cytoflow.scripts.benchmark:main'],
                   'gui_scripts' : ['cytoflow = cytoflowgui.run:run_gui']}
 )